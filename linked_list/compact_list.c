@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "compact_list.h"
+
+_Static_assert(sizeof(struct cnode) == 5, "cnode must be packed");
+
+static uint32_t new_cnode(clist_t* list_p, const char new_data);
+static void free_cnode(clist_t* list_p, uint32_t idx);
+
+void clist_init(clist_t* list_p)
+{
+	list_p->nodes = NULL;
+	list_p->capacity = 0;
+	list_p->used = 0;
+	list_p->head = CLIST_NIL;
+	list_p->tail = CLIST_NIL;
+	list_p->free_head = CLIST_NIL;
+	list_p->size = 0;
+}
+
+int clist_push_front(clist_t* list_p, const char new_data)
+{
+	uint32_t new_idx = new_cnode(list_p, new_data);
+	if(new_idx == CLIST_NIL) return RESULT_NOK;
+
+	list_p->nodes[new_idx].next = list_p->head;
+	if(list_p->head == CLIST_NIL)
+	{
+		list_p->tail = new_idx;
+	}
+	list_p->head = new_idx;
+	++list_p->size;
+
+	return RESULT_OK;
+}
+
+int clist_push_back(clist_t* list_p, const char new_data)
+{
+	uint32_t new_idx = new_cnode(list_p, new_data);
+	if(new_idx == CLIST_NIL) return RESULT_NOK;
+
+	if(list_p->tail != CLIST_NIL)
+	{
+		list_p->nodes[list_p->tail].next = new_idx;
+	}
+	else
+	{
+		list_p->head = new_idx;
+	}
+	list_p->tail = new_idx;
+	++list_p->size;
+
+	return RESULT_OK;
+}
+
+int clist_pop_front(clist_t* list_p, char* data_storage)
+{
+	uint32_t head = list_p->head;
+	if(head == CLIST_NIL) return RESULT_NOK;
+
+	*data_storage = list_p->nodes[head].data;
+	list_p->head = list_p->nodes[head].next;
+	if(list_p->head == CLIST_NIL)
+	{
+		list_p->tail = CLIST_NIL;
+	}
+	free_cnode(list_p, head);
+	--list_p->size;
+
+	return RESULT_OK;
+}
+
+int clist_pop_back(clist_t* list_p, char* data_storage)
+{
+	uint32_t tail = list_p->tail;
+	if(tail == CLIST_NIL) return RESULT_NOK;
+
+	*data_storage = list_p->nodes[tail].data;
+	if(list_p->head == tail)
+	{
+		list_p->head = CLIST_NIL;
+		list_p->tail = CLIST_NIL;
+	}
+	else
+	{
+		uint32_t prev = list_p->head;
+		while(list_p->nodes[prev].next != tail)
+		{
+			prev = list_p->nodes[prev].next;
+		}
+		list_p->nodes[prev].next = CLIST_NIL;
+		list_p->tail = prev;
+	}
+	free_cnode(list_p, tail);
+	--list_p->size;
+
+	return RESULT_OK;
+}
+
+/* All nodes are in the array, forgetting them is enough */
+void clist_clear(clist_t* list_p)
+{
+	list_p->used = 0;
+	list_p->head = CLIST_NIL;
+	list_p->tail = CLIST_NIL;
+	list_p->free_head = CLIST_NIL;
+	list_p->size = 0;
+}
+
+unsigned int clist_count(clist_t* list_p)
+{
+#ifdef CHECK_COUNT
+	/* Cross-check the cached size against a full walk */
+	unsigned int elements_c = 0;
+	for(uint32_t idx = list_p->head; idx != CLIST_NIL; idx = list_p->nodes[idx].next)
+	{
+		++elements_c;
+	}
+	assert(elements_c == list_p->size);
+#endif
+	return list_p->size;
+}
+
+void clist_destroy(clist_t* list_p)
+{
+	free(list_p->nodes);
+	clist_init(list_p);
+}
+
+/* Indices stay valid in a copy, so the used part is copied as is */
+int clist_copy(clist_t* dest_p, const clist_t* src_p)
+{
+	clist_destroy(dest_p);
+	if(!src_p->used) return RESULT_OK;
+
+	dest_p->nodes = malloc(src_p->used * sizeof(*dest_p->nodes));
+	if(!dest_p->nodes) return RESULT_NOK;
+
+	memcpy(dest_p->nodes, src_p->nodes, src_p->used * sizeof(*dest_p->nodes));
+	dest_p->capacity = src_p->used;
+	dest_p->used = src_p->used;
+	dest_p->head = src_p->head;
+	dest_p->tail = src_p->tail;
+	dest_p->free_head = src_p->free_head;
+	dest_p->size = src_p->size;
+	return RESULT_OK;
+}
+
+/* Takes a freed node first, then an unused one, then grows the array twice
+ * @return index of the new node or CLIST_NIL when out of memory
+ */
+static uint32_t new_cnode(clist_t* list_p, const char new_data)
+{
+	uint32_t new_idx = list_p->free_head;
+	if(new_idx != CLIST_NIL)
+	{
+		list_p->free_head = list_p->nodes[new_idx].next;
+	}
+	else
+	{
+		if(list_p->used == list_p->capacity)
+		{
+			/* Last index is CLIST_NIL, it can't be a node */
+			if(list_p->capacity == CLIST_NIL) return CLIST_NIL;
+
+			uint64_t new_capacity = list_p->capacity ? 2 * (uint64_t)list_p->capacity : CLIST_MIN_NODES;
+			if(new_capacity > CLIST_NIL) new_capacity = CLIST_NIL;
+
+			struct cnode* grown_p = realloc(list_p->nodes, new_capacity * sizeof(*grown_p));
+			if(!grown_p) return CLIST_NIL;
+			list_p->nodes = grown_p;
+			list_p->capacity = (uint32_t)new_capacity;
+		}
+		new_idx = list_p->used;
+		++list_p->used;
+	}
+
+	list_p->nodes[new_idx].data = new_data;
+	list_p->nodes[new_idx].next = CLIST_NIL;
+	return new_idx;
+}
+
+static void free_cnode(clist_t* list_p, uint32_t idx)
+{
+	list_p->nodes[idx].next = list_p->free_head;
+	list_p->free_head = idx;
+}
@@ -0,0 +1,52 @@
+#ifndef COMPACT_LIST_H_
+#define COMPACT_LIST_H_
+
+#include <stdint.h>
+
+#include "linked_list.h"
+
+/* Index standing for no node, like NULL for pointers */
+#define CLIST_NIL       UINT32_MAX
+#define CLIST_MIN_NODES 64U
+
+#define clist_is_empty(list) ((list).head == CLIST_NIL)
+
+/* Packed, so a node takes 5 bytes instead of 16 of struct node */
+struct cnode
+{
+	uint32_t next;
+	char data;
+} __attribute__((packed));
+
+/* All nodes live in one array and link each other by indices, so the
+ * array can grow with realloc and the whole list is copied with one
+ * memcpy. Freed nodes are chained by next from free_head and reused first.
+ */
+struct clist
+{
+	struct cnode* nodes;
+	/* Nodes allocated, and nodes ever used out of them */
+	uint32_t capacity;
+	uint32_t used;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t free_head;
+	unsigned int size;
+};
+
+typedef struct clist clist_t;
+
+void clist_init(clist_t* list_p);
+int clist_push_front(clist_t* list_p, const char new_data);
+int clist_push_back(clist_t* list_p, const char new_data);
+int clist_pop_front(clist_t* list_p, char* data_storage);
+/* Singly linked, so the new tail is searched from the head */
+int clist_pop_back(clist_t* list_p, char* data_storage);
+/* Keeps the array for reuse, clist_destroy() gives it back */
+void clist_clear(clist_t* list_p);
+unsigned int clist_count(clist_t* list_p);
+void clist_destroy(clist_t* list_p);
+/* @return RESULT_NOK when out of memory, dest is left empty then */
+int clist_copy(clist_t* dest_p, const clist_t* src_p);
+
+#endif /* COMPACT_LIST_H_ */
@@ -0,0 +1,162 @@
+#include <criterion.h>
+#include <string.h>
+#include <time.h>
+
+#include "compact_list.h"
+
+Test(compact_list_suite, basic_scenario)
+{
+	clist_t list;
+	clist_init(&list);
+	cr_assert(clist_is_empty(list));
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_NOK, clist_pop_front(&list, &popped));
+	cr_assert_eq(RESULT_NOK, clist_pop_back(&list, &popped));
+
+	cr_assert_eq(RESULT_OK, clist_push_back(&list, 'b'));
+	cr_assert_eq(RESULT_OK, clist_push_front(&list, 'a'));
+	cr_assert_eq(RESULT_OK, clist_push_back(&list, 'c'));
+	cr_assert_eq(3, clist_count(&list));
+
+	cr_assert_eq(RESULT_OK, clist_pop_back(&list, &popped));
+	cr_assert_eq('c', popped);
+	cr_assert_eq(RESULT_OK, clist_pop_front(&list, &popped));
+	cr_assert_eq('a', popped);
+	cr_assert_eq(RESULT_OK, clist_pop_back(&list, &popped));
+	cr_assert_eq('b', popped);
+	cr_assert(clist_is_empty(list));
+	cr_assert_eq(0, clist_count(&list));
+
+	clist_destroy(&list);
+	cr_assert_eq(NULL, list.nodes);
+}
+
+/* Freed nodes are reused, so churn doesn't grow the array */
+Test(compact_list_suite, freed_nodes_reused)
+{
+	clist_t list;
+	clist_init(&list);
+	for(unsigned int i = 0; i < CLIST_MIN_NODES; ++i)
+	{
+		cr_assert_eq(RESULT_OK, clist_push_back(&list, (char)i));
+	}
+	uint32_t capacity = list.capacity;
+
+	char popped = '\0';
+	for(unsigned int i = 0; i < 100000; ++i)
+	{
+		cr_assert_eq(RESULT_OK, clist_pop_front(&list, &popped));
+		cr_assert_eq((char)i, popped);
+		cr_assert_eq(RESULT_OK, clist_push_back(&list, (char)(i + CLIST_MIN_NODES)));
+	}
+	cr_assert_eq(capacity, list.capacity);
+	cr_assert_eq(CLIST_MIN_NODES, clist_count(&list));
+
+	clist_clear(&list);
+	cr_assert(clist_is_empty(list));
+	cr_assert_eq(capacity, list.capacity);
+	cr_assert_eq(RESULT_OK, clist_push_front(&list, 'x'));
+	cr_assert_eq(0, list.head);
+	clist_destroy(&list);
+}
+
+/* Array is reallocated while growing, indices keep the order */
+Test(compact_list_suite, grow_and_copy)
+{
+	const unsigned int elements_c = 100000;
+	clist_t list, copy;
+	clist_init(&list);
+	clist_init(&copy);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, (i % 2 ? clist_push_back : clist_push_front)(&list, (char)i));
+	}
+	cr_assert_geq(list.capacity, elements_c);
+
+	cr_assert_eq(RESULT_OK, clist_copy(&copy, &list));
+	cr_assert_eq(elements_c, clist_count(&copy));
+	clist_destroy(&list);
+
+	char popped = '\0';
+	for(unsigned int i = elements_c; i > 0; i -= 2)
+	{
+		cr_assert_eq(RESULT_OK, clist_pop_front(&copy, &popped));
+		cr_assert_eq((char)(i - 2), popped);
+	}
+	for(unsigned int i = 1; i < elements_c; i += 2)
+	{
+		cr_assert_eq(RESULT_OK, clist_pop_front(&copy, &popped));
+		cr_assert_eq((char)i, popped);
+	}
+	cr_assert(clist_is_empty(copy));
+	clist_destroy(&copy);
+}
+
+static unsigned int walk_list(list_t* list_p)
+{
+	unsigned int sum = 0;
+	for(struct node* node_p = list_p->head; node_p; node_p = node_p->next)
+	{
+		sum += node_p->data;
+	}
+	return sum;
+}
+
+static unsigned int walk_clist(clist_t* list_p)
+{
+	unsigned int sum = 0;
+	for(uint32_t idx = list_p->head; idx != CLIST_NIL; idx = list_p->nodes[idx].next)
+	{
+		sum += list_p->nodes[idx].data;
+	}
+	return sum;
+}
+
+Test(compact_list_suite, time_measurements, .disabled = false)
+{
+	const unsigned int elements_c = 100000000;
+
+	list_t list;
+	init(&list);
+	clist_t clist;
+	clist_init(&clist);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_front(&list, 1));
+		cr_assert_eq(RESULT_OK, clist_push_front(&clist, 1));
+	}
+
+	cr_log_info("Memory of %d elements:", elements_c);
+	cr_log_info("list_t  MiB: %7.1f bytes per element: %5.2f",
+		(double)elements_c * sizeof(struct node) / (1 << 20), (double)sizeof(struct node));
+	/* Array grows twice, so up to half of it may be spare */
+	cr_log_info("clist_t MiB: %7.1f bytes per element: %5.2f, %5.2f allocated",
+		(double)clist.capacity * sizeof(struct cnode) / (1 << 20),
+		(double)sizeof(struct cnode),
+		(double)clist.capacity * sizeof(struct cnode) / elements_c);
+
+	cr_log_info("Measure cycles for traversal over %d elements:", elements_c);
+	clock_t start = clock();
+	cr_assert_eq(elements_c, walk_list(&list));
+	clock_t end = clock();
+	cr_log_info("list_t  CPU ticks used: %9ld", (long)(end - start));
+
+	start = clock();
+	cr_assert_eq(elements_c, walk_clist(&clist));
+	end = clock();
+	cr_log_info("clist_t CPU ticks used: %9ld", (long)(end - start));
+
+	cr_log_info("Measure cycles for copying %d elements:", elements_c);
+	clist_t copy;
+	clist_init(&copy);
+	start = clock();
+	cr_assert_eq(RESULT_OK, clist_copy(&copy, &clist));
+	end = clock();
+	cr_assert_eq(elements_c, walk_clist(&copy));
+	cr_log_info("clist_t CPU ticks used: %9ld", (long)(end - start));
+
+	clear(&list);
+	clist_destroy(&clist);
+	clist_destroy(&copy);
+}
@@ -0,0 +1,33 @@
+#ifndef DLINKED_LIST_H_
+#define DLINKED_LIST_H_
+
+#include "linked_list.h"
+
+#define dlist_is_empty(list) ((list).head == NULL)
+
+struct dnode
+{
+	struct dnode* next;
+	struct dnode* prev;
+	char data;
+};
+
+/* Handles to both ends, so every push and pop is O(1) */
+struct dlist
+{
+	struct dnode* head;
+	struct dnode* tail;
+	unsigned int size;
+};
+
+typedef struct dlist dlist_t;
+
+void dlist_init(dlist_t* list_p);
+int dlist_push_front(dlist_t* list_p, const char new_data);
+int dlist_push_back(dlist_t* list_p, const char new_data);
+int dlist_pop_front(dlist_t* list_p, char* data_storage);
+int dlist_pop_back(dlist_t* list_p, char* data_storage);
+void dlist_clear(dlist_t* list_p);
+unsigned int dlist_count(dlist_t* list_p);
+
+#endif /* DLINKED_LIST_H_ */
@@ -0,0 +1,141 @@
+#include <criterion.h>
+#include <time.h>
+
+#include "dlinked_list.h"
+
+Test(doubly_linked_list_suite, basic_scenario)
+{
+	dlist_t list;
+	dlist_init(&list);
+	cr_assert(dlist_is_empty(list));
+
+	char char_to_push = 'a', char_popped = '\0';
+	cr_assert_eq(RESULT_OK, dlist_push_back(&list, char_to_push));
+	cr_assert_eq(list.head, list.tail);
+
+	cr_assert_eq(RESULT_OK, dlist_pop_back(&list, &char_popped));
+	cr_expect(dlist_is_empty(list));
+	cr_expect_eq(NULL, list.tail);
+	cr_assert_eq(char_to_push, char_popped);
+
+	char_to_push = 'b';
+	char_popped = '\0';
+	cr_assert_eq(RESULT_OK, dlist_push_front(&list, char_to_push));
+	cr_assert_neq(NULL, list.head);
+
+	cr_assert_eq(RESULT_OK, dlist_pop_front(&list, &char_popped));
+	cr_expect(dlist_is_empty(list));
+	cr_expect_eq(NULL, list.tail);
+	cr_assert_eq(char_to_push, char_popped);
+}
+
+Test(doubly_linked_list_suite, pop_more_than_pushed)
+{
+	char to_push = 'f';
+	char to_pop_into = 0;
+
+	dlist_t list;
+	dlist_init(&list);
+
+	cr_assert_eq(RESULT_OK, dlist_push_front(&list, to_push));
+	cr_assert_eq(RESULT_OK, dlist_pop_back(&list, &to_pop_into));
+	cr_assert_eq(to_push, to_pop_into);
+
+	for(int i = 0; i < 3; ++i)
+	{
+		// trying to pop more than pushed should return error
+		cr_expect_eq(RESULT_NOK, dlist_pop_back(&list, &to_pop_into));
+		cr_expect_eq(RESULT_NOK, dlist_pop_front(&list, &to_pop_into));
+	}
+
+	// buffer should not be altered after wrong pops
+	cr_assert_eq(to_push, to_pop_into);
+}
+
+Test(doubly_linked_list_suite, both_ends_order)
+{
+	dlist_t letters;
+	dlist_init(&letters);
+
+	// d c b a x y z
+	for (char c = 'a'; c <= 'd'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, dlist_push_front(&letters, c));
+	}
+	for (char c = 'x'; c <= 'z'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, dlist_push_back(&letters, c));
+	}
+	cr_assert_eq(7, dlist_count(&letters));
+
+	char storage = 0;
+	cr_assert_eq(RESULT_OK, dlist_pop_back(&letters, &storage));
+	cr_assert_eq('z', storage);
+	cr_assert_eq(RESULT_OK, dlist_pop_front(&letters, &storage));
+	cr_assert_eq('d', storage);
+
+	// prev links must be consistent with next links
+	const char expected[] = "cbaxy";
+	unsigned int idx = 0;
+	for(struct dnode* node_p = letters.head; node_p; node_p = node_p->next, ++idx)
+	{
+		cr_assert_eq(expected[idx], node_p->data);
+		if(node_p->next) cr_assert_eq(node_p, node_p->next->prev);
+	}
+	idx = 5;
+	for(struct dnode* node_p = letters.tail; node_p; node_p = node_p->prev)
+	{
+		cr_assert_eq(expected[--idx], node_p->data);
+	}
+	cr_assert_eq(0, idx);
+
+	dlist_clear(&letters);
+	cr_assert(dlist_is_empty(letters));
+	cr_assert_eq(NULL, letters.tail);
+	cr_assert_eq(0, dlist_count(&letters));
+}
+
+Test(doubly_linked_list_suite, time_measurements, .disabled = false)
+{
+	dlist_t list;
+	dlist_init(&list);
+	const unsigned int count = 10000000;
+
+	cr_log_info("Measure cycles for the dlist_push_back "
+			    "and dlist_pop_back of %d elements:", count);
+	clock_t start = clock();
+
+	for(int i = 0; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, dlist_push_back(&list, '\0'));
+	}
+	for(int i = 0; i < count; ++i)
+	{
+		char dummy = 0;
+		cr_assert_eq(RESULT_OK, dlist_pop_back(&list, &dummy));
+	}
+	cr_assert(dlist_is_empty(list));
+
+	clock_t end = clock();
+	unsigned int ticks = end - start;
+	cr_log_info("CPU ticks used: %9d", ticks);
+
+	cr_log_info("Measure cycles for the dlist_push_front "
+			    "and dlist_pop_front of %d elements:", count);
+	start = clock();
+
+	for(int i = 0; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, dlist_push_front(&list, '\0'));
+	}
+	for(int i = 0; i < count; ++i)
+	{
+		char dummy = 0;
+		cr_assert_eq(RESULT_OK, dlist_pop_front(&list, &dummy));
+	}
+	cr_assert(dlist_is_empty(list));
+
+	end = clock();
+	ticks = end - start;
+	cr_log_info("CPU ticks used: %9d", ticks);
+}
@@ -0,0 +1,87 @@
+#include <stdlib.h>
+
+#include "lf_stack.h"
+#include "node_pool.h"
+
+/* Nodes are type stable: the pool never gives slabs back while in use,
+ * so reading next of a node popped meanwhile by another thread is
+ * harmless, the tag makes the following CAS fail
+ */
+static struct node_pool lf_nodes = NODE_POOL_INIT(struct node);
+
+static struct tagged_top load_head(lf_stack_t* stack_p);
+static int cas_head(lf_stack_t* stack_p, struct tagged_top expected,
+	struct tagged_top desired);
+
+void lf_stack_init(lf_stack_t* stack_p)
+{
+	stack_p->head.top = NULL;
+	stack_p->head.tag = 0;
+}
+
+int lf_stack_push(lf_stack_t* stack_p, const char new_data)
+{
+	struct node* new_p = node_pool_alloc(&lf_nodes);
+	if(!new_p) return RESULT_NOK;
+	new_p->data = new_data;
+
+	struct tagged_top old, new;
+	do
+	{
+		old = load_head(stack_p);
+		__atomic_store_n(&new_p->next, old.top, __ATOMIC_RELAXED);
+		new.top = new_p;
+		new.tag = old.tag + 1;
+	} while(!cas_head(stack_p, old, new));
+
+	return RESULT_OK;
+}
+
+int lf_stack_pop(lf_stack_t* stack_p, char* data_storage)
+{
+	struct tagged_top old, new;
+	do
+	{
+		old = load_head(stack_p);
+		if(!old.top) return RESULT_NOK;
+
+		new.top = __atomic_load_n(&old.top->next, __ATOMIC_RELAXED);
+		new.tag = old.tag + 1;
+	} while(!cas_head(stack_p, old, new));
+
+	/* Node is ours once the CAS succeeded */
+	*data_storage = old.top->data;
+	node_pool_free(&lf_nodes, old.top);
+
+	return RESULT_OK;
+}
+
+void lf_stack_clear(lf_stack_t* stack_p)
+{
+	node_pool_free_chain(&lf_nodes, stack_p->head.top);
+	stack_p->head.top = NULL;
+	++stack_p->head.tag;
+}
+
+void lf_stack_thread_flush(void)
+{
+	node_pool_thread_flush(&lf_nodes);
+}
+
+/* Halves are read one by one, a torn pair just fails the CAS */
+static struct tagged_top load_head(lf_stack_t* stack_p)
+{
+	struct tagged_top head;
+	head.tag = __atomic_load_n(&stack_p->head.tag, __ATOMIC_ACQUIRE);
+	head.top = __atomic_load_n(&stack_p->head.top, __ATOMIC_ACQUIRE);
+	return head;
+}
+
+/* Double width CAS, cmpxchg16b on x86-64 (needs -mcx16) */
+static int cas_head(lf_stack_t* stack_p, struct tagged_top expected,
+	struct tagged_top desired)
+{
+	lf_stack_t expected_u = {.head = expected};
+	lf_stack_t desired_u = {.head = desired};
+	return __sync_bool_compare_and_swap(&stack_p->word, expected_u.word, desired_u.word);
+}
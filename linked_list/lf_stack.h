@@ -0,0 +1,39 @@
+#ifndef LF_STACK_H_
+#define LF_STACK_H_
+
+#include <stdint.h>
+
+#include "linked_list.h"
+
+#define lf_stack_is_empty(stack) ((stack).head.top == NULL)
+
+/* Top is swapped together with a tag bumped on every change, so a node
+ * popped and pushed again between a load and a CAS (ABA) fails the CAS
+ */
+struct tagged_top
+{
+	struct node* top;
+	uintptr_t tag;
+};
+
+/* Lock-free LIFO stack of nodes, push and pop are safe from any thread */
+struct lf_stack
+{
+	union
+	{
+		struct tagged_top head;
+		unsigned __int128 word;
+	};
+} __attribute__((aligned(16)));
+
+typedef struct lf_stack lf_stack_t;
+
+void lf_stack_init(lf_stack_t* stack_p);
+int lf_stack_push(lf_stack_t* stack_p, const char new_data);
+int lf_stack_pop(lf_stack_t* stack_p, char* data_storage);
+/* Not thread safe, no other thread may use the stack meanwhile */
+void lf_stack_clear(lf_stack_t* stack_p);
+/* Gives nodes cached by calling thread back, call before it exits */
+void lf_stack_thread_flush(void);
+
+#endif /* LF_STACK_H_ */
@@ -0,0 +1,209 @@
+#include <criterion.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "lf_stack.h"
+
+#define STRESS_THREADS 8U
+#define MAX_THREADS    32U
+
+Test(lf_stack_suite, basic_scenario)
+{
+	lf_stack_t stack;
+	lf_stack_init(&stack);
+	cr_assert(lf_stack_is_empty(stack));
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_NOK, lf_stack_pop(&stack, &popped));
+	for(char c = 'a'; c <= 'z'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, lf_stack_push(&stack, c));
+	}
+	for(char c = 'z'; c >= 'a'; --c)
+	{
+		cr_assert_eq(RESULT_OK, lf_stack_pop(&stack, &popped));
+		cr_assert_eq(c, popped);
+	}
+	cr_assert(lf_stack_is_empty(stack));
+
+	cr_assert_eq(RESULT_OK, lf_stack_push(&stack, 'x'));
+	lf_stack_clear(&stack);
+	cr_assert(lf_stack_is_empty(stack));
+}
+
+/* Pop A and push again: the freed node is reused first, so the top is
+ * the same pointer as before, but the tag tells the stale snapshot apart
+ */
+Test(lf_stack_suite, aba_changes_tag)
+{
+	lf_stack_t stack;
+	lf_stack_init(&stack);
+	cr_assert_eq(RESULT_OK, lf_stack_push(&stack, 'c'));
+	cr_assert_eq(RESULT_OK, lf_stack_push(&stack, 'b'));
+	cr_assert_eq(RESULT_OK, lf_stack_push(&stack, 'a'));
+	struct tagged_top snapshot = stack.head;
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_OK, lf_stack_pop(&stack, &popped));
+	cr_assert_eq(RESULT_OK, lf_stack_push(&stack, 'a'));
+
+	cr_assert_eq(snapshot.top, stack.head.top);
+	cr_assert_neq(snapshot.tag, stack.head.tag);
+	lf_stack_clear(&stack);
+}
+
+struct worker_args
+{
+	lf_stack_t* stack_p;
+	pthread_mutex_t* lock_p;
+	list_t* list_p;
+	unsigned int ops;
+	char id;
+	unsigned int popped[STRESS_THREADS];
+	int errors_c;
+};
+
+/* Pushes own id and pops whatever is on top, counting popped ids */
+static void* stress_worker(void* arg)
+{
+	struct worker_args* args_p = arg;
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		if(lf_stack_push(args_p->stack_p, args_p->id)) ++args_p->errors_c;
+		if(i % 3 == 0 && lf_stack_push(args_p->stack_p, args_p->id)) ++args_p->errors_c;
+
+		char popped = '\0';
+		if(lf_stack_pop(args_p->stack_p, &popped)) ++args_p->errors_c;
+		else if((unsigned char)popped < STRESS_THREADS) ++args_p->popped[(unsigned char)popped];
+		else ++args_p->errors_c;
+	}
+	lf_stack_thread_flush();
+	return NULL;
+}
+
+Test(lf_stack_suite, threads_stress)
+{
+	const unsigned int ops = 200000;
+	lf_stack_t stack;
+	lf_stack_init(&stack);
+
+	pthread_t threads[STRESS_THREADS];
+	struct worker_args args[STRESS_THREADS];
+	memset(args, 0, sizeof(args));
+	for(unsigned int i = 0; i < STRESS_THREADS; ++i)
+	{
+		args[i].stack_p = &stack;
+		args[i].ops = ops;
+		args[i].id = (char)i;
+		cr_assert_eq(0, pthread_create(&threads[i], NULL, stress_worker, &args[i]));
+	}
+
+	unsigned int popped[STRESS_THREADS] = {0};
+	for(unsigned int i = 0; i < STRESS_THREADS; ++i)
+	{
+		cr_assert_eq(0, pthread_join(threads[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+		for(unsigned int id = 0; id < STRESS_THREADS; ++id)
+		{
+			popped[id] += args[i].popped[id];
+		}
+	}
+
+	/* Whatever wasn't popped by threads is still there, nothing lost */
+	char left = '\0';
+	while(lf_stack_pop(&stack, &left) == RESULT_OK)
+	{
+		cr_assert_lt((unsigned char)left, STRESS_THREADS);
+		++popped[(unsigned char)left];
+	}
+	const unsigned int pushed = ops + (ops + 2) / 3;
+	for(unsigned int id = 0; id < STRESS_THREADS; ++id)
+	{
+		cr_assert_eq(pushed, popped[id], "id %d: pushed %d, popped %d",
+			id, pushed, popped[id]);
+	}
+}
+
+static void* lf_worker(void* arg)
+{
+	struct worker_args* args_p = arg;
+	char popped = '\0';
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		if(lf_stack_push(args_p->stack_p, args_p->id)) ++args_p->errors_c;
+		if(lf_stack_pop(args_p->stack_p, &popped)) ++args_p->errors_c;
+	}
+	lf_stack_thread_flush();
+	return NULL;
+}
+
+static void* mutex_worker(void* arg)
+{
+	struct worker_args* args_p = arg;
+	char popped = '\0';
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		pthread_mutex_lock(args_p->lock_p);
+		if(push_front(args_p->list_p, args_p->id)) ++args_p->errors_c;
+		pthread_mutex_unlock(args_p->lock_p);
+
+		pthread_mutex_lock(args_p->lock_p);
+		if(pop_front(args_p->list_p, &popped)) ++args_p->errors_c;
+		pthread_mutex_unlock(args_p->lock_p);
+	}
+	return NULL;
+}
+
+/* @return millions of push and pop pairs per second */
+static double run_threads(void* (*worker)(void*), struct worker_args* base_p,
+	unsigned int threads_num, unsigned int total_ops)
+{
+	pthread_t threads[MAX_THREADS];
+	struct worker_args args[MAX_THREADS];
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int i = 0; i < threads_num; ++i)
+	{
+		args[i] = *base_p;
+		args[i].ops = total_ops / threads_num;
+		args[i].id = (char)i;
+		cr_assert_eq(0, pthread_create(&threads[i], NULL, worker, &args[i]));
+	}
+	for(unsigned int i = 0; i < threads_num; ++i)
+	{
+		cr_assert_eq(0, pthread_join(threads[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	return total_ops / seconds / 1e6;
+}
+
+Test(lf_stack_suite, time_measurements, .disabled = false)
+{
+	const unsigned int total_ops = 4000000;
+
+	lf_stack_t stack;
+	lf_stack_init(&stack);
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	list_t list;
+	init(&list);
+	struct worker_args base;
+	memset(&base, 0, sizeof(base));
+	base.stack_p = &stack;
+	base.lock_p = &lock;
+	base.list_p = &list;
+
+	cr_log_info("Measure millions of push and pop pairs per second, "
+			    "%d pairs in total:", total_ops);
+	for(unsigned int threads_num = 1; threads_num <= MAX_THREADS; threads_num *= 2)
+	{
+		double lf_mops = run_threads(lf_worker, &base, threads_num, total_ops);
+		double mutex_mops = run_threads(mutex_worker, &base, threads_num, total_ops);
+		cr_log_info("threads %2d lock-free: %7.2f mutex: %7.2f",
+			threads_num, lf_mops, mutex_mops);
+	}
+	cr_assert(lf_stack_is_empty(stack));
+	cr_assert_eq(0, count(&list));
+}
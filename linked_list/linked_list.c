@@ -1,121 +1,287 @@
 #include <stdlib.h>
+#include <stddef.h>
 
 #include "linked_list.h"
+#include "node_pool.h"
 
-static struct node** get_tail_pp(list_t* list_p);
-static struct node* new_node(const char new_data);
+/* Shared with the basic operations in list_abi.cpp */
+struct node_pool list_nodes = NODE_POOL_INIT(struct node);
 
-void init(list_t* list_p)
-{
-	 *list_p = NULL;
-}
+static struct node* new_chain(const char* data, unsigned int n, struct node** last_pp);
+static struct node* node_of_next(list_t* list_p, struct node** next_pp);
+static int compare_chars(const char a, const char b);
+static struct node* split_after(struct node* head_p, unsigned long n);
+static struct node** merge_chains(struct node* a_p, struct node* b_p,
+	list_compar_fn compar, struct node** out_pp);
 
-int push_front(list_t* list_p, const char new_data)
+int push_front_n(list_t* list_p, const char* data, unsigned int n)
 {
-	struct node* new_p = new_node(new_data);
-	if(!new_p) return RESULT_NOK;
+	if(!n) return RESULT_OK;
 
-	if(*list_p)
+	struct node* last_p;
+	struct node* chain_p = new_chain(data, n, &last_p);
+	if(!chain_p) return RESULT_NOK;
+
+	last_p->next = list_p->head;
+	if(!list_p->head)
 	{
-		new_p->next = *list_p;
+		list_p->tail = last_p;
 	}
-
-	*list_p = new_p;
+	list_p->head = chain_p;
+	list_p->size += n;
 
 	return RESULT_OK;
 }
 
-int push_back(list_t* list_p, const char new_data)
+int push_back_n(list_t* list_p, const char* data, unsigned int n)
 {
-	struct node* new_p = new_node(new_data);
-	if(!new_p) return RESULT_NOK;
+	if(!n) return RESULT_OK;
 
-	struct node** tail_pp = get_tail_pp(list_p);
+	struct node* last_p;
+	struct node* chain_p = new_chain(data, n, &last_p);
+	if(!chain_p) return RESULT_NOK;
 
-	if(tail_pp)
+	if(list_p->tail)
 	{
-		(*tail_pp)->next = new_p;
+		list_p->tail->next = chain_p;
 	}
 	else
 	{
-		*list_p = new_p;
+		list_p->head = chain_p;
 	}
+	list_p->tail = last_p;
+	list_p->size += n;
 
 	return RESULT_OK;
 }
 
-int pop_front(list_t* list_p, char* data_storage)
+/* Popped nodes are cut off and go back to the pool as one chain */
+unsigned int pop_front_n(list_t* list_p, char* buffer, unsigned int n)
+{
+	struct node* popped_p = list_p->head;
+	struct node** next_pp = &list_p->head;
+	unsigned int popped_c = 0;
+	for(; popped_c < n && *next_pp; ++popped_c)
+	{
+		buffer[popped_c] = (*next_pp)->data;
+		next_pp = &(*next_pp)->next;
+	}
+	if(!popped_c) return 0;
+
+	list_p->head = *next_pp;
+	*next_pp = NULL;
+	if(!list_p->head)
+	{
+		list_p->tail = NULL;
+	}
+	list_p->size -= popped_c;
+	node_pool_free_chain(&list_nodes, popped_p);
+
+	return popped_c;
+}
+
+void concat(list_t* dest_p, list_t* src_p)
+{
+	splice_after(dest_p, dest_p->tail, src_p);
+}
+
+void splice_after(list_t* dest_p, struct node* pos_p, list_t* src_p)
 {
-	if(!(*list_p)) return RESULT_NOK;
+	if(!src_p->head) return;
+
+	struct node** next_pp = pos_p ? &pos_p->next : &dest_p->head;
+	src_p->tail->next = *next_pp;
+	if(!*next_pp)
+	{
+		dest_p->tail = src_p->tail;
+	}
+	*next_pp = src_p->head;
+	dest_p->size += src_p->size;
 
-	*data_storage = (*list_p)->data;
-	struct node* to_free = *list_p;
-	*list_p = (*list_p)->next;
-	free(to_free);
+	init(src_p);
+}
+
+int split_at(list_t* list_p, unsigned int index, list_t* rest_p)
+{
+	if(index > list_p->size) return RESULT_NOK;
 
+	struct node** next_pp = &list_p->head;
+	for(unsigned int i = 0; i < index; ++i)
+	{
+		next_pp = &(*next_pp)->next;
+	}
+
+	list_t cut;
+	cut.head = *next_pp;
+	cut.tail = cut.head ? list_p->tail : NULL;
+	cut.size = list_p->size - index;
+	*next_pp = NULL;
+	list_p->tail = node_of_next(list_p, next_pp);
+	list_p->size = index;
+
+	concat(rest_p, &cut);
 	return RESULT_OK;
 }
 
-int pop_back(list_t* list_p, char* data_storage)
+/* Nodes sorted by address take the data of the list in order,
+ * then they are relinked in that order
+ */
+int defragment(list_t* list_p)
 {
-	struct node** tail_pp = get_tail_pp(list_p);
-	if(tail_pp)
+	if(list_p->size < 2) return RESULT_OK;
+
+	struct node** nodes_p = malloc(list_p->size * sizeof(*nodes_p));
+	if(!nodes_p) return RESULT_NOK;
+	char* data_p = malloc(list_p->size);
+	if(!data_p)
 	{
-		*data_storage = (*tail_pp)->data;
-		free(*tail_pp);
-		*tail_pp = NULL;
-		return RESULT_OK;
+		free(nodes_p);
+		return RESULT_NOK;
 	}
-	else
+
+	unsigned int i = 0;
+	for(struct node* node_p = list_p->head; node_p; node_p = node_p->next, ++i)
 	{
+		nodes_p[i] = node_p;
+		data_p[i] = node_p->data;
+	}
+	if(node_pool_sort_by_address((void**)nodes_p, list_p->size))
+	{
+		free(data_p);
+		free(nodes_p);
 		return RESULT_NOK;
 	}
+
+	for(i = 0; i < list_p->size; ++i)
+	{
+		nodes_p[i]->data = data_p[i];
+		nodes_p[i]->next = (i + 1 < list_p->size) ? nodes_p[i + 1] : NULL;
+	}
+	list_p->head = nodes_p[0];
+	list_p->tail = nodes_p[list_p->size - 1];
+
+	free(data_p);
+	free(nodes_p);
+	return RESULT_OK;
 }
 
-unsigned int count(list_t* list_p)
+int defragment_free_nodes(void)
 {
-	if(!(*list_p)) return 0;
+	return node_pool_sort_cache(&list_nodes) ? RESULT_NOK : RESULT_OK;
+}
 
-	struct node* next_p = *list_p;
-	unsigned int elements_c = 0;
-	while(next_p)
+void sort(list_t* list_p)
+{
+	sort_by(list_p, compare_chars);
+}
+
+/* Bottom-up: runs of width nodes are merged pairwise in one pass over
+ * the list, then width doubles, so there is no recursion nor extra memory
+ */
+void sort_by(list_t* list_p, list_compar_fn compar)
+{
+	for(unsigned long width = 1; width < list_p->size; width *= 2)
 	{
-		++elements_c;
-		next_p = next_p->next;
+		struct node* rest_p = list_p->head;
+		struct node** tail_pp = &list_p->head;
+		while(rest_p)
+		{
+			struct node* left_p = rest_p;
+			struct node* right_p = split_after(left_p, width);
+			rest_p = split_after(right_p, width);
+			tail_pp = merge_chains(left_p, right_p, compar, tail_pp);
+		}
+		list_p->tail = node_of_next(list_p, tail_pp);
 	}
-	return elements_c;
 }
 
-void clear(list_t* list_p)
+void merge(list_t* dest_p, list_t* src_p)
+{
+	merge_by(dest_p, src_p, compare_chars);
+}
+
+void merge_by(list_t* dest_p, list_t* src_p, list_compar_fn compar)
 {
-	while(*list_p)
+	struct node** tail_pp = merge_chains(dest_p->head, src_p->head, compar, &dest_p->head);
+	dest_p->tail = node_of_next(dest_p, tail_pp);
+	dest_p->size += src_p->size;
+	init(src_p);
+}
+
+static int compare_chars(const char a, const char b)
+{
+	return (unsigned char)a - (unsigned char)b;
+}
+
+/* Cuts the chain after n nodes
+ * @return rest of the chain, NULL if it's not longer than n
+ */
+static struct node* split_after(struct node* head_p, unsigned long n)
+{
+	for(unsigned long i = 1; head_p && i < n; ++i)
 	{
-		struct node* to_free = *list_p;
-		*list_p = (*list_p)->next;
-		free(to_free);
+		head_p = head_p->next;
 	}
+	if(!head_p) return NULL;
+
+	struct node* rest_p = head_p->next;
+	head_p->next = NULL;
+	return rest_p;
 }
 
-static struct node** get_tail_pp(list_t* list_p)
+/* Links merged chains to *out_pp, b goes after equal elements of a,
+ * which keeps the merge stable
+ * @return next of the last merged node
+ */
+static struct node** merge_chains(struct node* a_p, struct node* b_p,
+	list_compar_fn compar, struct node** out_pp)
 {
-	if(!(*list_p)) return NULL;
+	while(a_p && b_p)
+	{
+		if(compar(b_p->data, a_p->data) < 0)
+		{
+			*out_pp = b_p;
+			b_p = b_p->next;
+		}
+		else
+		{
+			*out_pp = a_p;
+			a_p = a_p->next;
+		}
+		out_pp = &(*out_pp)->next;
+	}
 
-	while ((*list_p)->next)
+	/* Rest is already linked, only its end is needed */
+	*out_pp = a_p ? a_p : b_p;
+	while(*out_pp)
 	{
-		list_p = &(*list_p)->next;
+		out_pp = &(*out_pp)->next;
 	}
-	return list_p;
+	return out_pp;
 }
 
-static struct node* new_node(const char new_data)
+/* @return node whose next is next_pp, NULL for the head of the list */
+static struct node* node_of_next(list_t* list_p, struct node** next_pp)
 {
-	struct node* new_p;
-	new_p = malloc(sizeof(struct node));
-	if(!new_p) return NULL;
-	else
+	if(next_pp == &list_p->head) return NULL;
+	return (struct node*)((char*)next_pp - offsetof(struct node, next));
+}
+
+/* @return head of a chain of n nodes holding data, its last node
+ *         is set in last_pp, NULL when out of memory
+ */
+static struct node* new_chain(const char* data, unsigned int n, struct node** last_pp)
+{
+	struct node* chain_p = node_pool_alloc_chain(&list_nodes, n);
+	if(!chain_p) return NULL;
+
+	struct node* node_p = chain_p;
+	for(unsigned int i = 0; i < n - 1; ++i)
 	{
-		new_p->data = new_data;
-		new_p->next = NULL;
-		return new_p;
+		node_p->data = data[i];
+		node_p = node_p->next;
 	}
+	node_p->data = data[n - 1];
+	*last_pp = node_p;
+	return chain_p;
 }
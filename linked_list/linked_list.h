@@ -3,7 +3,7 @@
 
 #define RESULT_OK   0
 #define RESULT_NOK -1
-#define is_empty(list) (list == NULL)
+#define is_empty(list) ((list).head == NULL)
 
 struct node
 {
@@ -11,7 +11,20 @@ struct node
 	char data;
 };
 
-typedef struct node* list_t;
+/* Tail and size are kept up to date by every operation, so counting,
+ * pushing back and joining lists are O(1)
+ */
+struct list
+{
+	struct node* head;
+	struct node* tail;
+	unsigned int size;
+};
+
+typedef struct list list_t;
+
+/* @return negative, zero or positive when a is less, equal or greater than b */
+typedef int (*list_compar_fn)(const char a, const char b);
 
 void init(list_t* list_p);
 int push_front(list_t* list_p, const char new_data);
@@ -21,4 +34,45 @@ int pop_back(list_t* list_p, char* data_storage);
 void clear(list_t* list_p);
 unsigned int count(list_t* list_p);
 
+/* Nodes for all n elements are taken from the pool at once, elements
+ * keep the order of data at either end
+ * @return RESULT_NOK when out of memory, the list is left as it was
+ */
+int push_front_n(list_t* list_p, const char* data, unsigned int n);
+int push_back_n(list_t* list_p, const char* data, unsigned int n);
+/* @return number of elements popped into buffer, less than n
+ *         when the list runs out
+ */
+unsigned int pop_front_n(list_t* list_p, char* buffer, unsigned int n);
+/* Both move all nodes of src in O(1), src is left empty */
+void concat(list_t* dest_p, list_t* src_p);
+/* pos_p is a node of dest or NULL for the front */
+void splice_after(list_t* dest_p, struct node* pos_p, list_t* src_p);
+/* Moves elements from index on to the end of rest, walks index nodes
+ * @return RESULT_NOK when index is past the end
+ */
+int split_at(list_t* list_p, unsigned int index, list_t* rest_p);
+
+/* Relinks nodes so that list order is address order, which makes
+ * traversal sequential in memory. Data is moved, nodes stay in place.
+ * @return RESULT_NOK when out of memory for n pointers, list is unchanged
+ */
+int defragment(list_t* list_p);
+/* Orders free nodes cached by calling thread by address, so nodes
+ * allocated next are laid out sequentially
+ * @return RESULT_NOK when out of memory, cache is unchanged
+ */
+int defragment_free_nodes(void);
+
+/* Stable, nodes are relinked in place without allocating.
+ * Without a comparator chars are compared as unsigned, like strcmp does.
+ */
+void sort(list_t* list_p);
+void sort_by(list_t* list_p, list_compar_fn compar);
+/* Both lists are sorted, nodes of src are moved into dest in O(n + m),
+ * equal elements of dest go first
+ */
+void merge(list_t* dest_p, list_t* src_p);
+void merge_by(list_t* dest_p, list_t* src_p, list_compar_fn compar);
+
 #endif /* LINKED_LIST_H_ */
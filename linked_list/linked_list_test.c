@@ -1,29 +1,38 @@
 #include <criterion.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "linked_list.h"
 
+/* Cross-checked count() walks the list, timing it is pointless */
+#ifdef CHECK_COUNT
+#define IS_COUNT_CHECKED 1
+#else
+#define IS_COUNT_CHECKED 0
+#endif
+
 Test(singly_linked_list_suite, basic_scenario)
 {
 	list_t list;
 	init(&list);
-	cr_assert_eq(list, NULL);
+	cr_assert_eq(list.head, NULL);
 
 	char char_to_push = 'a', char_popped = '\0';
 	cr_assert_eq(RESULT_OK, push_back(&list, char_to_push));
-	cr_assert_neq(NULL, list);
+	cr_assert_neq(NULL, list.head);
 
 	cr_assert_eq(RESULT_OK, pop_back(&list, &char_popped));
-	cr_expect_eq(NULL, list);
+	cr_expect_eq(NULL, list.head);
 	cr_assert_eq(char_to_push, char_popped);
 
 	char_to_push = 'b';
 	char_popped = '\0';
 	cr_assert_eq(RESULT_OK, push_front(&list, char_to_push));
-	cr_assert_neq(NULL, list);
+	cr_assert_neq(NULL, list.head);
 
 	cr_assert_eq(RESULT_OK, pop_front(&list, &char_popped));
-	cr_expect_eq(NULL, list);
+	cr_expect_eq(NULL, list.head);
 	cr_assert_eq(char_to_push, char_popped);
 }
 
@@ -52,6 +61,7 @@ Test(singly_linked_list_suite, pop_more_than_pushed)
 
 	// buffer should not be altered after wrong pops
 	cr_assert_eq(to_push, to_pop_into);
+	cr_assert_eq(0, count(&list));
 }
 
 Test(singly_linked_list_suite, push_pop_push_track_length)
@@ -126,7 +136,439 @@ Test(singly_linked_list_suite, push_clear_test)
 	cr_assert_eq(counted, elements_c, "Counted %d != %d", counted, elements_c);
 
 	clear(&list);
-	cr_assert_eq(NULL, list);
+	cr_assert_eq(NULL, list.head);
+}
+
+/* @return 1 if list is ordered by compar */
+static int is_sorted_by(list_t* list_p, list_compar_fn compar)
+{
+	for(struct node* node_p = list_p->head; node_p && node_p->next; node_p = node_p->next)
+	{
+		if(compar(node_p->data, node_p->next->data) > 0) return 0;
+	}
+	return 1;
+}
+
+static int compare_unsigned(const char a, const char b)
+{
+	return (unsigned char)a - (unsigned char)b;
+}
+
+/* Equal when high nibbles are equal, low ones keep the insertion order */
+static int compare_high_nibble(const char a, const char b)
+{
+	return ((unsigned char)a >> 4) - ((unsigned char)b >> 4);
+}
+
+Test(singly_linked_list_suite, sort_scenario)
+{
+	list_t list;
+	init(&list);
+	sort(&list);
+	cr_assert_eq(NULL, list.head);
+
+	const char unsorted[] = "the quick brown fox jumps over the lazy dog";
+	for(unsigned int i = 0; unsorted[i]; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_front(&list, unsorted[i]));
+	}
+	/* Chars above 127 go last, as unsigned */
+	cr_assert_eq(RESULT_OK, push_front(&list, (char)0xff));
+	cr_assert_eq(RESULT_OK, push_front(&list, '\0'));
+
+	sort(&list);
+	cr_assert(is_sorted_by(&list, compare_unsigned));
+	cr_assert_eq(sizeof(unsorted) + 1, count(&list));
+	cr_assert_eq('\0', list.head->data);
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_OK, pop_back(&list, &popped));
+	cr_assert_eq((char)0xff, popped);
+	clear(&list);
+}
+
+Test(singly_linked_list_suite, sort_by_is_stable)
+{
+	list_t list;
+	init(&list);
+	/* Every high nibble is pushed in order of low nibbles */
+	for(unsigned int low = 0; low < 16; ++low)
+	{
+		for(unsigned int high = 16; high > 0; --high)
+		{
+			cr_assert_eq(RESULT_OK, push_back(&list, (char)(((high - 1) << 4) | low)));
+		}
+	}
+
+	sort_by(&list, compare_high_nibble);
+	cr_assert_eq(256, count(&list));
+	struct node* node_p = list.head;
+	for(unsigned int i = 0; i < 256; ++i)
+	{
+		cr_assert_eq((char)i, node_p->data);
+		node_p = node_p->next;
+	}
+	cr_assert_eq(NULL, node_p);
+	clear(&list);
+}
+
+Test(singly_linked_list_suite, merge_sorted)
+{
+	list_t evens, odds, empty;
+	init(&evens);
+	init(&odds);
+	init(&empty);
+	for(char c = 'a'; c <= 'z'; c += 2)
+	{
+		cr_assert_eq(RESULT_OK, push_back(&evens, c));
+		cr_assert_eq(RESULT_OK, push_back(&odds, c + 1));
+	}
+	cr_assert_eq(RESULT_OK, push_back(&odds, 'z'));
+
+	merge(&evens, &empty);
+	cr_assert_eq(13, count(&evens));
+	merge(&evens, &odds);
+	cr_assert_eq(NULL, odds.head);
+	cr_assert_eq(0, count(&odds));
+	cr_assert_eq(27, count(&evens));
+	cr_assert(is_sorted_by(&evens, compare_unsigned));
+
+	merge(&empty, &evens);
+	cr_assert_eq(27, count(&empty));
+	cr_assert_eq('a', empty.head->data);
+	clear(&empty);
+}
+
+static int compare_bytes(const void* p1, const void* p2)
+{
+	return *(const unsigned char*)p1 - *(const unsigned char*)p2;
+}
+
+Test(singly_linked_list_suite, sort_time_measurements, .disabled = false)
+{
+	const unsigned int elements_c = 1000000;
+	list_t list;
+	init(&list);
+
+	srand(0);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_front(&list, (char)rand()));
+	}
+
+	cr_log_info("Measure cycles for sorting %d elements in place:", elements_c);
+	clock_t start = clock();
+	sort(&list);
+	clock_t end = clock();
+	cr_assert(is_sorted_by(&list, compare_unsigned));
+	cr_log_info("CPU ticks used: %9ld", (long)(end - start));
+
+	/* Shuffle it again for the same amount of work */
+	clear(&list);
+	srand(0);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_front(&list, (char)rand()));
+	}
+
+	cr_log_info("Measure cycles for popping %d elements into an array, "
+			    "qsort and pushing them back:", elements_c);
+	start = clock();
+	char* array_p = malloc(elements_c);
+	cr_assert_neq(NULL, array_p);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, pop_front(&list, &array_p[i]));
+	}
+	qsort(array_p, elements_c, sizeof(*array_p), compare_bytes);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_back(&list, array_p[i]));
+	}
+	free(array_p);
+	end = clock();
+	cr_assert(is_sorted_by(&list, compare_unsigned));
+	cr_log_info("CPU ticks used: %9ld", (long)(end - start));
+	clear(&list);
+}
+
+/* @return 1 if list holds exactly the chars of expected, in its order,
+ *         with its tail and size matching
+ */
+static int is_equal_to(list_t* list_p, const char* expected)
+{
+	struct node* node_p = list_p->head;
+	struct node* last_p = NULL;
+	for(unsigned int i = 0; expected[i]; ++i)
+	{
+		if(!node_p || node_p->data != expected[i]) return 0;
+		last_p = node_p;
+		node_p = node_p->next;
+	}
+	return !node_p && list_p->tail == last_p && count(list_p) == strlen(expected);
+}
+
+Test(singly_linked_list_suite, bulk_push_pop)
+{
+	list_t list;
+	init(&list);
+	cr_assert_eq(RESULT_OK, push_back_n(&list, "def", 3));
+	cr_assert_eq(RESULT_OK, push_front_n(&list, "abc", 3));
+	cr_assert_eq(RESULT_OK, push_back_n(&list, "ghi", 3));
+	cr_assert_eq(RESULT_OK, push_back_n(&list, "", 0));
+	cr_assert(is_equal_to(&list, "abcdefghi"));
+
+	char buffer[16] = {0};
+	cr_assert_eq(4, pop_front_n(&list, buffer, 4));
+	cr_assert_eq(0, strncmp("abcd", buffer, 4));
+	cr_assert(is_equal_to(&list, "efghi"));
+
+	cr_assert_eq(5, pop_front_n(&list, buffer, sizeof(buffer)));
+	cr_assert_eq(0, strncmp("efghi", buffer, 5));
+	cr_assert(is_equal_to(&list, ""));
+	cr_assert_eq(0, pop_front_n(&list, buffer, sizeof(buffer)));
+
+	/* Tail is still right for single element pushes */
+	cr_assert_eq(RESULT_OK, push_front_n(&list, "x", 1));
+	cr_assert_eq(RESULT_OK, push_back(&list, 'y'));
+	cr_assert(is_equal_to(&list, "xy"));
+	clear(&list);
+}
+
+Test(singly_linked_list_suite, concat_splice_split)
+{
+	list_t list, other, empty;
+	init(&list);
+	init(&other);
+	init(&empty);
+	cr_assert_eq(RESULT_OK, push_back_n(&list, "ad", 2));
+	cr_assert_eq(RESULT_OK, push_back_n(&other, "bc", 2));
+
+	splice_after(&list, list.head, &other);
+	cr_assert(is_equal_to(&list, "abcd"));
+	cr_assert(is_equal_to(&other, ""));
+
+	cr_assert_eq(RESULT_OK, push_back_n(&other, "ef", 2));
+	concat(&list, &other);
+	concat(&list, &empty);
+	cr_assert(is_equal_to(&list, "abcdef"));
+
+	cr_assert_eq(RESULT_OK, push_back(&other, '_'));
+	splice_after(&other, NULL, &list);
+	cr_assert(is_equal_to(&other, "abcdef_"));
+	concat(&list, &other);
+	cr_assert(is_equal_to(&list, "abcdef_"));
+
+	cr_assert_eq(RESULT_NOK, split_at(&list, 8, &other));
+	cr_assert_eq(RESULT_OK, split_at(&list, 4, &other));
+	cr_assert(is_equal_to(&list, "abcd"));
+	cr_assert(is_equal_to(&other, "ef_"));
+	cr_assert_eq(RESULT_OK, split_at(&list, 4, &other));
+	cr_assert(is_equal_to(&other, "ef_"));
+	cr_assert_eq(RESULT_OK, split_at(&list, 0, &other));
+	cr_assert(is_equal_to(&list, ""));
+	cr_assert(is_equal_to(&other, "ef_abcd"));
+
+	/* List stays usable at both ends after all the relinking */
+	char popped = '\0';
+	cr_assert_eq(RESULT_OK, pop_back(&other, &popped));
+	cr_assert_eq('d', popped);
+	cr_assert_eq(RESULT_OK, push_back(&other, 'z'));
+	cr_assert(is_equal_to(&other, "ef_abcz"));
+	clear(&other);
+}
+
+Test(singly_linked_list_suite, bulk_time_measurements, .disabled = false)
+{
+	const unsigned int chunk = 4096;
+	const unsigned int elements_c = 2500 * chunk;
+	list_t list;
+	init(&list);
+	char* buffer_p = malloc(chunk);
+	cr_assert_neq(NULL, buffer_p);
+	memset(buffer_p, 'a', chunk);
+
+	cr_log_info("Measure cycles for push_back and pop_front "
+			    "of %d elements one by one:", elements_c);
+	clock_t start = clock();
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_back(&list, buffer_p[i % chunk]));
+	}
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, pop_front(&list, &buffer_p[i % chunk]));
+	}
+	clock_t end = clock();
+	cr_assert_eq(0, count(&list));
+	cr_log_info("CPU ticks used: %9ld", (long)(end - start));
+
+	cr_log_info("Measure cycles for push_back_n and pop_front_n "
+			    "of %d elements in chunks of %d:", elements_c, chunk);
+	start = clock();
+	for(unsigned int i = 0; i < elements_c; i += chunk)
+	{
+		cr_assert_eq(RESULT_OK, push_back_n(&list, buffer_p, chunk));
+	}
+	for(unsigned int i = 0; i < elements_c; i += chunk)
+	{
+		cr_assert_eq(chunk, pop_front_n(&list, buffer_p, chunk));
+	}
+	end = clock();
+	cr_assert_eq(0, count(&list));
+	cr_log_info("CPU ticks used: %9ld", (long)(end - start));
+
+	list_t other;
+	init(&other);
+	for(unsigned int i = 0; i < elements_c; i += chunk)
+	{
+		cr_assert_eq(RESULT_OK, push_back_n(&list, buffer_p, chunk));
+	}
+	cr_log_info("Measure cycles for moving %d elements to another list "
+			    "one by one:", count(&list));
+	start = clock();
+	char moved = '\0';
+	while(pop_front(&list, &moved) == RESULT_OK)
+	{
+		cr_assert_eq(RESULT_OK, push_back(&other, moved));
+	}
+	end = clock();
+	cr_log_info("CPU ticks used: %9ld", (long)(end - start));
+
+	cr_log_info("Measure cycles for moving them back by concat:");
+	start = clock();
+	concat(&list, &other);
+	end = clock();
+	cr_assert_eq(0, count(&other));
+	cr_log_info("CPU ticks used: %9ld", (long)(end - start));
+
+	clear(&list);
+	free(buffer_p);
+}
+
+/* Relinks nodes in random order, data moves with them so the list still
+ * reads the same, but every next points somewhere else in memory
+ * @return 1 on success
+ */
+static int shuffle_nodes(list_t* list_p, unsigned int seed)
+{
+	unsigned int n = count(list_p);
+	if(n < 2) return 1;
+	struct node** nodes_p = malloc(n * sizeof(*nodes_p));
+	char* data_p = malloc(n);
+	if(!nodes_p || !data_p) return 0;
+
+	unsigned int i = 0;
+	for(struct node* node_p = list_p->head; node_p; node_p = node_p->next, ++i)
+	{
+		nodes_p[i] = node_p;
+		data_p[i] = node_p->data;
+	}
+	srand(seed);
+	for(i = n - 1; i > 0; --i)
+	{
+		unsigned int j = ((unsigned int)rand() * (RAND_MAX + 1U) + rand()) % (i + 1);
+		struct node* swapped_p = nodes_p[i];
+		nodes_p[i] = nodes_p[j];
+		nodes_p[j] = swapped_p;
+	}
+	for(i = 0; i < n; ++i)
+	{
+		nodes_p[i]->data = data_p[i];
+		nodes_p[i]->next = (i + 1 < n) ? nodes_p[i + 1] : NULL;
+	}
+	list_p->head = nodes_p[0];
+	list_p->tail = nodes_p[n - 1];
+	free(data_p);
+	free(nodes_p);
+	return 1;
+}
+
+Test(singly_linked_list_suite, defragment_keeps_order)
+{
+	const char* letters = "the quick brown fox jumps over the lazy dog";
+	list_t list;
+	init(&list);
+	cr_assert_eq(RESULT_OK, defragment(&list));
+	cr_assert_eq(RESULT_OK, push_back_n(&list, letters, strlen(letters)));
+	cr_assert(shuffle_nodes(&list, 1));
+	cr_assert(is_equal_to(&list, letters));
+
+	cr_assert_eq(RESULT_OK, defragment(&list));
+	cr_assert(is_equal_to(&list, letters));
+	for(struct node* node_p = list.head; node_p->next; node_p = node_p->next)
+	{
+		cr_assert_lt(node_p, node_p->next);
+	}
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_OK, pop_back(&list, &popped));
+	cr_assert_eq('g', popped);
+	cr_assert_eq(RESULT_OK, push_back(&list, '!'));
+	cr_assert_eq('!', list.tail->data);
+	clear(&list);
+}
+
+static unsigned int walk(list_t* list_p)
+{
+	unsigned int sum = 0;
+	for(struct node* node_p = list_p->head; node_p; node_p = node_p->next)
+	{
+		sum += node_p->data;
+	}
+	return sum;
+}
+
+/* @return nanoseconds per node of one traversal */
+static double ns_per_node(list_t* list_p)
+{
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	unsigned int sum = walk(list_p);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	cr_assert_eq(count(list_p), sum);
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / count(list_p);
+}
+
+Test(singly_linked_list_suite, traversal_time_measurements, .disabled = false)
+{
+	const unsigned int elements_c = 10000000;
+	list_t list;
+	init(&list);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_back(&list, 1));
+	}
+
+	cr_log_info("Measure ns per node of traversing %d elements:", elements_c);
+	cr_log_info("sequential   : %6.2f", ns_per_node(&list));
+	cr_assert(shuffle_nodes(&list, 1));
+	cr_log_info("shuffled     : %6.2f", ns_per_node(&list));
+
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	cr_assert_eq(RESULT_OK, defragment(&list));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	cr_log_info("defragmented : %6.2f, defragment itself: %6.2f", ns_per_node(&list),
+		((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / elements_c);
+
+	/* Freed shuffled nodes are handed out again in that order */
+	for(int is_sorted = 0; is_sorted <= 1; ++is_sorted)
+	{
+		cr_assert(shuffle_nodes(&list, 2));
+		clear(&list);
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		if(is_sorted) cr_assert_eq(RESULT_OK, defragment_free_nodes());
+		for(unsigned int i = 0; i < elements_c; ++i)
+		{
+			cr_assert_eq(RESULT_OK, push_back(&list, 1));
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		cr_log_info("rebuilt from shuffled free nodes%s: %6.2f, building: %6.2f",
+			is_sorted ? " sorted first" : "", ns_per_node(&list),
+			((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / elements_c);
+		clear(&list);
+	}
 }
 
 Test(singly_linked_list_suite, time_measurements, .disabled = false)
@@ -148,7 +590,7 @@ Test(singly_linked_list_suite, time_measurements, .disabled = false)
 		char dummy = 0;
 		cr_assert_eq(RESULT_OK, pop_back(&list, &dummy));
 	}
-	cr_assert_eq(NULL, list);
+	cr_assert_eq(NULL, list.head);
 
 	clock_t end = clock();
 	unsigned int ticks = end - start;
@@ -167,9 +609,38 @@ Test(singly_linked_list_suite, time_measurements, .disabled = false)
 		char dummy = 0;
 		cr_assert_eq(RESULT_OK, pop_front(&list, &dummy));
 	}
-	cr_assert_eq(NULL, list);
+	cr_assert_eq(NULL, list.head);
 
 	end = clock();
 	ticks = end - start;
 	cr_log_info("CPU ticks used: %9d", ticks);
 }
+
+Test(singly_linked_list_suite, count_time_measurements, .disabled = IS_COUNT_CHECKED)
+{
+	const unsigned int calls = 10000000;
+	list_t list;
+	init(&list);
+
+	cr_log_info("Measure cycles for %d calls of count:", calls);
+	for(unsigned int length = 1000; length <= 10000000; length *= 100)
+	{
+		while(count(&list) < length)
+		{
+			cr_assert_eq(RESULT_OK, push_front(&list, '\0'));
+		}
+
+		/* volatile keeps calls from being merged */
+		volatile unsigned int counted = 0;
+		clock_t start = clock();
+		for(unsigned int i = 0; i < calls; ++i)
+		{
+			counted = count(&list);
+		}
+		clock_t end = clock();
+		cr_assert_eq(length, counted);
+		cr_log_info("length %8d CPU ticks used: %9ld", length, (long)(end - start));
+	}
+	clear(&list);
+	cr_assert_eq(0, count(&list));
+}
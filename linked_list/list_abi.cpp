@@ -0,0 +1,95 @@
+#include "list_core.h"
+
+extern "C" {
+#include "linked_list.h"
+#include "dlinked_list.h"
+#include "node_pool.h"
+
+/* Defined along the rest of the list_t API in linked_list.c */
+extern struct node_pool list_nodes;
+}
+
+static struct node_pool dnodes = NODE_POOL_INIT(struct dnode);
+
+/* C pools are objects, not types, so each one gets a static front */
+template <typename Node, struct node_pool* pool_p>
+struct CPool {
+	static Node* alloc() { return static_cast<Node*>(node_pool_alloc(pool_p)); }
+	static void free(Node* node_p) { node_pool_free(pool_p, node_p); }
+	static void free_chain(Node* head_p) { node_pool_free_chain(pool_p, head_p); }
+};
+
+using Core = ListCore<list_t>;
+using Nodes = PoolNodes<struct node, CPool<struct node, &list_nodes>>;
+using DCore = ListCore<dlist_t>;
+using DNodes = PoolNodes<struct dnode, CPool<struct dnode, &dnodes>>;
+
+extern "C" void init(list_t* list_p)
+{
+	Core::init(*list_p);
+}
+
+extern "C" int push_front(list_t* list_p, const char new_data)
+{
+	return Core::push_front(*list_p, Nodes{}, new_data);
+}
+
+extern "C" int push_back(list_t* list_p, const char new_data)
+{
+	return Core::push_back(*list_p, Nodes{}, new_data);
+}
+
+extern "C" int pop_front(list_t* list_p, char* data_storage)
+{
+	return Core::pop_front(*list_p, Nodes{}, *data_storage);
+}
+
+extern "C" int pop_back(list_t* list_p, char* data_storage)
+{
+	return Core::pop_back(*list_p, Nodes{}, *data_storage);
+}
+
+extern "C" void clear(list_t* list_p)
+{
+	Core::clear(*list_p, Nodes{});
+}
+
+extern "C" unsigned int count(list_t* list_p)
+{
+	return Core::count(*list_p);
+}
+
+extern "C" void dlist_init(dlist_t* list_p)
+{
+	DCore::init(*list_p);
+}
+
+extern "C" int dlist_push_front(dlist_t* list_p, const char new_data)
+{
+	return DCore::push_front(*list_p, DNodes{}, new_data);
+}
+
+extern "C" int dlist_push_back(dlist_t* list_p, const char new_data)
+{
+	return DCore::push_back(*list_p, DNodes{}, new_data);
+}
+
+extern "C" int dlist_pop_front(dlist_t* list_p, char* data_storage)
+{
+	return DCore::pop_front(*list_p, DNodes{}, *data_storage);
+}
+
+extern "C" int dlist_pop_back(dlist_t* list_p, char* data_storage)
+{
+	return DCore::pop_back(*list_p, DNodes{}, *data_storage);
+}
+
+extern "C" void dlist_clear(dlist_t* list_p)
+{
+	DCore::clear(*list_p, DNodes{});
+}
+
+extern "C" unsigned int dlist_count(dlist_t* list_p)
+{
+	return DCore::count(*list_p);
+}
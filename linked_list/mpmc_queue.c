@@ -0,0 +1,257 @@
+#include <stdlib.h>
+
+#include "mpmc_queue.h"
+#include "node_pool.h"
+
+#define HAZARDS_PER_THREAD 2U
+#define RETIRED_MIN        64U
+
+/* Hazard pointers: before dereferencing a node a thread publishes it
+ * in its record and checks it's still reachable. Popped nodes are retired
+ * and go back to the pool only once no record holds them, so a node is
+ * never reused while read, which also rules out ABA on head and tail.
+ */
+struct hazard_rec
+{
+	struct node* hazards[HAZARDS_PER_THREAD];
+	int is_active;
+	/* Retired nodes stay with the record, the next owner frees them */
+	struct node** retired;
+	unsigned int retired_c;
+	unsigned int retired_cap;
+	struct hazard_rec* next;
+};
+
+static struct node_pool queue_nodes = NODE_POOL_INIT(struct node);
+/* Records are never freed, threads reuse inactive ones */
+static struct hazard_rec* hazard_recs;
+static unsigned int hazard_recs_c;
+static _Thread_local struct hazard_rec* my_rec;
+
+static struct hazard_rec* acquire_rec(void);
+static struct node* protect(struct node** src_pp, unsigned int hazard_idx);
+static void retire(struct hazard_rec* rec_p, struct node* node_p);
+static void scan(struct hazard_rec* rec_p);
+static int is_hazard(const struct node* node_p);
+static int cas(struct node** target_pp, struct node* expected, struct node* desired);
+
+int mpmc_queue_init(mpmc_queue_t* queue_p)
+{
+	struct node* dummy_p = node_pool_alloc(&queue_nodes);
+	if(!dummy_p) return RESULT_NOK;
+
+	dummy_p->next = NULL;
+	queue_p->head = dummy_p;
+	queue_p->tail = dummy_p;
+	return RESULT_OK;
+}
+
+int mpmc_queue_push(mpmc_queue_t* queue_p, const char new_data)
+{
+	struct hazard_rec* rec_p = acquire_rec();
+	struct node* new_p = node_pool_alloc(&queue_nodes);
+	if(!rec_p || !new_p)
+	{
+		if(new_p) node_pool_free(&queue_nodes, new_p);
+		return RESULT_NOK;
+	}
+	new_p->data = new_data;
+	new_p->next = NULL;
+
+	while(1)
+	{
+		struct node* tail_p = protect(&queue_p->tail, 0);
+		struct node* next_p = __atomic_load_n(&tail_p->next, __ATOMIC_ACQUIRE);
+		if(tail_p != __atomic_load_n(&queue_p->tail, __ATOMIC_ACQUIRE)) continue;
+
+		/* Tail lags behind, help the producer which linked next */
+		if(next_p)
+		{
+			cas(&queue_p->tail, tail_p, next_p);
+			continue;
+		}
+		if(cas(&tail_p->next, NULL, new_p))
+		{
+			/* Failure means another thread already moved the tail on */
+			cas(&queue_p->tail, tail_p, new_p);
+			break;
+		}
+	}
+	__atomic_store_n(&rec_p->hazards[0], NULL, __ATOMIC_RELEASE);
+
+	return RESULT_OK;
+}
+
+int mpmc_queue_pop(mpmc_queue_t* queue_p, char* data_storage)
+{
+	struct hazard_rec* rec_p = acquire_rec();
+	if(!rec_p) return RESULT_NOK;
+
+	struct node* head_p;
+	int result = RESULT_OK;
+	while(1)
+	{
+		head_p = protect(&queue_p->head, 0);
+		struct node* tail_p = __atomic_load_n(&queue_p->tail, __ATOMIC_ACQUIRE);
+		struct node* next_p = protect(&head_p->next, 1);
+		if(head_p != __atomic_load_n(&queue_p->head, __ATOMIC_ACQUIRE)) continue;
+
+		if(!next_p)
+		{
+			result = RESULT_NOK;
+			break;
+		}
+		/* Don't let head pass the tail */
+		if(head_p == tail_p)
+		{
+			cas(&queue_p->tail, tail_p, next_p);
+			continue;
+		}
+
+		/* Next becomes the dummy, its data is read while protected */
+		char data = next_p->data;
+		if(cas(&queue_p->head, head_p, next_p))
+		{
+			*data_storage = data;
+			break;
+		}
+	}
+	__atomic_store_n(&rec_p->hazards[0], NULL, __ATOMIC_RELEASE);
+	__atomic_store_n(&rec_p->hazards[1], NULL, __ATOMIC_RELEASE);
+
+	if(result == RESULT_OK) retire(rec_p, head_p);
+	return result;
+}
+
+void mpmc_queue_destroy(mpmc_queue_t* queue_p)
+{
+	node_pool_free_chain(&queue_nodes, queue_p->head);
+	queue_p->head = NULL;
+	queue_p->tail = NULL;
+}
+
+void mpmc_queue_thread_exit(void)
+{
+	if(my_rec)
+	{
+		scan(my_rec);
+		__atomic_store_n(&my_rec->is_active, 0, __ATOMIC_RELEASE);
+		my_rec = NULL;
+	}
+	node_pool_thread_flush(&queue_nodes);
+}
+
+/* @return record of calling thread, NULL when out of memory */
+static struct hazard_rec* acquire_rec(void)
+{
+	if(my_rec) return my_rec;
+
+	for(struct hazard_rec* rec_p = __atomic_load_n(&hazard_recs, __ATOMIC_ACQUIRE);
+		rec_p; rec_p = rec_p->next)
+	{
+		int inactive = 0;
+		if(__atomic_compare_exchange_n(&rec_p->is_active, &inactive, 1, 0,
+			__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+			my_rec = rec_p;
+			return my_rec;
+		}
+	}
+
+	struct hazard_rec* rec_p = calloc(1, sizeof(*rec_p));
+	if(!rec_p) return NULL;
+	rec_p->is_active = 1;
+	rec_p->next = __atomic_load_n(&hazard_recs, __ATOMIC_RELAXED);
+	while(!__atomic_compare_exchange_n(&hazard_recs, &rec_p->next, rec_p, 0,
+		__ATOMIC_RELEASE, __ATOMIC_RELAXED));
+	__atomic_add_fetch(&hazard_recs_c, 1, __ATOMIC_RELAXED);
+
+	my_rec = rec_p;
+	return my_rec;
+}
+
+/* Publishes the node *src_pp points to until it doesn't change meanwhile,
+ * from then on it can't be freed
+ * @return protected node
+ */
+static struct node* protect(struct node** src_pp, unsigned int hazard_idx)
+{
+	struct node* node_p = __atomic_load_n(src_pp, __ATOMIC_ACQUIRE);
+	while(1)
+	{
+		__atomic_store_n(&my_rec->hazards[hazard_idx], node_p, __ATOMIC_SEQ_CST);
+		struct node* again_p = __atomic_load_n(src_pp, __ATOMIC_SEQ_CST);
+		if(again_p == node_p) return node_p;
+		node_p = again_p;
+	}
+}
+
+/* Scans once the number of retired nodes is twice the number of hazards,
+ * so at least half of them are freed by each scan
+ */
+static void retire(struct hazard_rec* rec_p, struct node* node_p)
+{
+	if(rec_p->retired_c == rec_p->retired_cap)
+	{
+		unsigned int hazards_c =
+			__atomic_load_n(&hazard_recs_c, __ATOMIC_RELAXED) * HAZARDS_PER_THREAD;
+		unsigned int new_cap = rec_p->retired_cap ? rec_p->retired_cap : RETIRED_MIN;
+		while(new_cap < 2 * hazards_c)
+		{
+			new_cap *= 2;
+		}
+		if(new_cap != rec_p->retired_cap)
+		{
+			struct node** grown_p = realloc(rec_p->retired, new_cap * sizeof(*grown_p));
+			/* Without room the node is leaked, which is still safe */
+			if(!grown_p) return;
+			rec_p->retired = grown_p;
+			rec_p->retired_cap = new_cap;
+		}
+	}
+
+	rec_p->retired[rec_p->retired_c] = node_p;
+	++rec_p->retired_c;
+	if(rec_p->retired_c == rec_p->retired_cap)
+	{
+		scan(rec_p);
+	}
+}
+
+static void scan(struct hazard_rec* rec_p)
+{
+	unsigned int kept_c = 0;
+	for(unsigned int i = 0; i < rec_p->retired_c; ++i)
+	{
+		struct node* node_p = rec_p->retired[i];
+		if(is_hazard(node_p))
+		{
+			rec_p->retired[kept_c] = node_p;
+			++kept_c;
+		}
+		else
+		{
+			node_pool_free(&queue_nodes, node_p);
+		}
+	}
+	rec_p->retired_c = kept_c;
+}
+
+static int is_hazard(const struct node* node_p)
+{
+	for(struct hazard_rec* rec_p = __atomic_load_n(&hazard_recs, __ATOMIC_ACQUIRE);
+		rec_p; rec_p = rec_p->next)
+	{
+		for(unsigned int i = 0; i < HAZARDS_PER_THREAD; ++i)
+		{
+			if(__atomic_load_n(&rec_p->hazards[i], __ATOMIC_SEQ_CST) == node_p) return 1;
+		}
+	}
+	return 0;
+}
+
+static int cas(struct node** target_pp, struct node* expected, struct node* desired)
+{
+	return __atomic_compare_exchange_n(target_pp, &expected, desired, 0,
+		__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,34 @@
+#ifndef MPMC_QUEUE_H_
+#define MPMC_QUEUE_H_
+
+#include "linked_list.h"
+
+#define MPMC_QUEUE_ALIGN 64U
+
+#define mpmc_queue_is_empty(queue) ((queue).head->next == NULL)
+
+/* Lock-free FIFO queue of nodes (Michael-Scott), push and pop are safe
+ * from any thread. Head always points to a dummy node, the first element
+ * is the one after it. Head and tail are on separate cache lines, so
+ * producers and consumers don't invalidate each other's.
+ */
+struct mpmc_queue
+{
+	_Alignas(MPMC_QUEUE_ALIGN) struct node* head;
+	_Alignas(MPMC_QUEUE_ALIGN) struct node* tail;
+};
+
+typedef struct mpmc_queue mpmc_queue_t;
+
+/* @return RESULT_NOK when out of memory for the dummy node */
+int mpmc_queue_init(mpmc_queue_t* queue_p);
+int mpmc_queue_push(mpmc_queue_t* queue_p, const char new_data);
+int mpmc_queue_pop(mpmc_queue_t* queue_p, char* data_storage);
+/* Not thread safe, no other thread may use the queue meanwhile */
+void mpmc_queue_destroy(mpmc_queue_t* queue_p);
+/* Frees what calling thread retired and is no longer in use, gives
+ * its hazard record and cached nodes back, call before it exits
+ */
+void mpmc_queue_thread_exit(void);
+
+#endif /* MPMC_QUEUE_H_ */
@@ -0,0 +1,274 @@
+#include <criterion.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "mpmc_queue.h"
+
+#define STRESS_PRODUCERS 4U
+#define STRESS_CONSUMERS 4U
+#define MAX_THREADS      32U
+/* Data of a stress element is producer id and a sequence number */
+#define SEQ_BITS         6U
+#define SEQ_MASK         ((1U << SEQ_BITS) - 1)
+
+Test(mpmc_queue_suite, basic_scenario)
+{
+	mpmc_queue_t queue;
+	cr_assert_eq(RESULT_OK, mpmc_queue_init(&queue));
+	cr_assert(mpmc_queue_is_empty(queue));
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_NOK, mpmc_queue_pop(&queue, &popped));
+	for(char c = 'a'; c <= 'z'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, mpmc_queue_push(&queue, c));
+	}
+	for(char c = 'a'; c <= 'z'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, mpmc_queue_pop(&queue, &popped));
+		cr_assert_eq(c, popped);
+	}
+	cr_assert(mpmc_queue_is_empty(queue));
+	cr_assert_eq(RESULT_NOK, mpmc_queue_pop(&queue, &popped));
+
+	cr_assert_eq(RESULT_OK, mpmc_queue_push(&queue, 'x'));
+	mpmc_queue_destroy(&queue);
+	mpmc_queue_thread_exit();
+}
+
+struct stress_args
+{
+	mpmc_queue_t* queue_p;
+	unsigned int ops;
+	unsigned int id;
+	/* Left by consumers, how many elements of each producer they got */
+	unsigned int popped[STRESS_PRODUCERS];
+	int* done_p;
+	int errors_c;
+};
+
+static void* stress_producer(void* arg)
+{
+	struct stress_args* args_p = arg;
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		char data = (char)((args_p->id << SEQ_BITS) | (i & SEQ_MASK));
+		if(mpmc_queue_push(args_p->queue_p, data)) ++args_p->errors_c;
+	}
+	mpmc_queue_thread_exit();
+	return NULL;
+}
+
+/* Pops until producers are done and the queue is drained */
+static void* stress_consumer(void* arg)
+{
+	struct stress_args* args_p = arg;
+	while(1)
+	{
+		int is_done = __atomic_load_n(args_p->done_p, __ATOMIC_ACQUIRE);
+		char popped = '\0';
+		if(mpmc_queue_pop(args_p->queue_p, &popped) == RESULT_OK)
+		{
+			unsigned int id = (unsigned char)popped >> SEQ_BITS;
+			if(id < STRESS_PRODUCERS) ++args_p->popped[id];
+			else ++args_p->errors_c;
+		}
+		else if(is_done) break;
+	}
+	mpmc_queue_thread_exit();
+	return NULL;
+}
+
+/* Single consumer sees elements of each producer in the order pushed */
+Test(mpmc_queue_suite, threads_producers_order)
+{
+	const unsigned int ops = 100000;
+	mpmc_queue_t queue;
+	cr_assert_eq(RESULT_OK, mpmc_queue_init(&queue));
+
+	pthread_t threads[STRESS_PRODUCERS];
+	struct stress_args args[STRESS_PRODUCERS];
+	memset(args, 0, sizeof(args));
+	for(unsigned int i = 0; i < STRESS_PRODUCERS; ++i)
+	{
+		args[i].queue_p = &queue;
+		args[i].ops = ops;
+		args[i].id = i;
+		cr_assert_eq(0, pthread_create(&threads[i], NULL, stress_producer, &args[i]));
+	}
+
+	unsigned int popped[STRESS_PRODUCERS] = {0};
+	unsigned int popped_c = 0;
+	while(popped_c < STRESS_PRODUCERS * ops)
+	{
+		char data = '\0';
+		if(mpmc_queue_pop(&queue, &data)) continue;
+
+		unsigned int id = (unsigned char)data >> SEQ_BITS;
+		cr_assert_lt(id, STRESS_PRODUCERS);
+		cr_assert_eq(popped[id] & SEQ_MASK, (unsigned char)data & SEQ_MASK);
+		++popped[id];
+		++popped_c;
+	}
+
+	for(unsigned int i = 0; i < STRESS_PRODUCERS; ++i)
+	{
+		cr_assert_eq(0, pthread_join(threads[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+	}
+	cr_assert(mpmc_queue_is_empty(queue));
+	mpmc_queue_destroy(&queue);
+	mpmc_queue_thread_exit();
+}
+
+Test(mpmc_queue_suite, threads_stress)
+{
+	const unsigned int ops = 200000;
+	mpmc_queue_t queue;
+	cr_assert_eq(RESULT_OK, mpmc_queue_init(&queue));
+	int is_done = 0;
+
+	pthread_t producers[STRESS_PRODUCERS];
+	pthread_t consumers[STRESS_CONSUMERS];
+	struct stress_args args[STRESS_PRODUCERS + STRESS_CONSUMERS];
+	memset(args, 0, sizeof(args));
+	for(unsigned int i = 0; i < STRESS_PRODUCERS + STRESS_CONSUMERS; ++i)
+	{
+		args[i].queue_p = &queue;
+		args[i].ops = ops;
+		args[i].id = i;
+		args[i].done_p = &is_done;
+	}
+	for(unsigned int i = 0; i < STRESS_CONSUMERS; ++i)
+	{
+		cr_assert_eq(0, pthread_create(&consumers[i], NULL, stress_consumer,
+			&args[STRESS_PRODUCERS + i]));
+	}
+	for(unsigned int i = 0; i < STRESS_PRODUCERS; ++i)
+	{
+		cr_assert_eq(0, pthread_create(&producers[i], NULL, stress_producer, &args[i]));
+	}
+
+	for(unsigned int i = 0; i < STRESS_PRODUCERS; ++i)
+	{
+		cr_assert_eq(0, pthread_join(producers[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+	}
+	__atomic_store_n(&is_done, 1, __ATOMIC_RELEASE);
+
+	unsigned int popped[STRESS_PRODUCERS] = {0};
+	for(unsigned int i = 0; i < STRESS_CONSUMERS; ++i)
+	{
+		struct stress_args* consumer_p = &args[STRESS_PRODUCERS + i];
+		cr_assert_eq(0, pthread_join(consumers[i], NULL));
+		cr_assert_eq(0, consumer_p->errors_c);
+		for(unsigned int id = 0; id < STRESS_PRODUCERS; ++id)
+		{
+			popped[id] += consumer_p->popped[id];
+		}
+	}
+
+	for(unsigned int id = 0; id < STRESS_PRODUCERS; ++id)
+	{
+		cr_assert_eq(ops, popped[id], "producer %d: pushed %d, popped %d",
+			id, ops, popped[id]);
+	}
+	cr_assert(mpmc_queue_is_empty(queue));
+	mpmc_queue_destroy(&queue);
+}
+
+struct bench_args
+{
+	mpmc_queue_t* queue_p;
+	pthread_mutex_t* lock_p;
+	list_t* list_p;
+	unsigned int ops;
+	int errors_c;
+};
+
+/* Each thread is both a producer and a consumer, so all of them contend
+ * on both ends while the queue stays short
+ */
+static void* queue_worker(void* arg)
+{
+	struct bench_args* args_p = arg;
+	char popped = '\0';
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		if(mpmc_queue_push(args_p->queue_p, (char)i)) ++args_p->errors_c;
+		if(mpmc_queue_pop(args_p->queue_p, &popped)) ++args_p->errors_c;
+	}
+	mpmc_queue_thread_exit();
+	return NULL;
+}
+
+static void* mutex_worker(void* arg)
+{
+	struct bench_args* args_p = arg;
+	char popped = '\0';
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		pthread_mutex_lock(args_p->lock_p);
+		if(push_back(args_p->list_p, (char)i)) ++args_p->errors_c;
+		pthread_mutex_unlock(args_p->lock_p);
+
+		pthread_mutex_lock(args_p->lock_p);
+		if(pop_front(args_p->list_p, &popped)) ++args_p->errors_c;
+		pthread_mutex_unlock(args_p->lock_p);
+	}
+	return NULL;
+}
+
+/* @return millions of push and pop pairs per second */
+static double run_threads(void* (*worker)(void*), struct bench_args* base_p,
+	unsigned int threads_num, unsigned int total_ops)
+{
+	pthread_t threads[MAX_THREADS];
+	struct bench_args args[MAX_THREADS];
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int i = 0; i < threads_num; ++i)
+	{
+		args[i] = *base_p;
+		args[i].ops = total_ops / threads_num;
+		cr_assert_eq(0, pthread_create(&threads[i], NULL, worker, &args[i]));
+	}
+	for(unsigned int i = 0; i < threads_num; ++i)
+	{
+		cr_assert_eq(0, pthread_join(threads[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	return total_ops / seconds / 1e6;
+}
+
+Test(mpmc_queue_suite, time_measurements, .disabled = false)
+{
+	const unsigned int total_ops = 4000000;
+
+	mpmc_queue_t queue;
+	cr_assert_eq(RESULT_OK, mpmc_queue_init(&queue));
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	list_t list;
+	init(&list);
+	struct bench_args base;
+	memset(&base, 0, sizeof(base));
+	base.queue_p = &queue;
+	base.lock_p = &lock;
+	base.list_p = &list;
+
+	cr_log_info("Measure millions of push and pop pairs per second, "
+			    "%d pairs in total:", total_ops);
+	for(unsigned int threads_num = 1; threads_num <= MAX_THREADS; threads_num *= 2)
+	{
+		double queue_mops = run_threads(queue_worker, &base, threads_num, total_ops);
+		double mutex_mops = run_threads(mutex_worker, &base, threads_num, total_ops);
+		cr_log_info("threads %2d lock-free: %7.2f mutex: %7.2f",
+			threads_num, queue_mops, mutex_mops);
+	}
+	cr_assert(mpmc_queue_is_empty(queue));
+	cr_assert_eq(0, count(&list));
+	mpmc_queue_destroy(&queue);
+}
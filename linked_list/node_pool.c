@@ -0,0 +1,438 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "node_pool.h"
+
+/* Slab header takes a whole line, so nodes after it start at a line too */
+#define SLAB_HEADER_SIZE NODE_POOL_ALIGN
+/* Addresses are sorted by digits of that many bits */
+#define RADIX_BITS       11U
+#define RADIX_BUCKETS    (1U << RADIX_BITS)
+
+/* Free nodes of one thread: a stack of NULL terminated chains. Nodes are
+ * taken from the top chain and single frees are prepended to it.
+ */
+struct pool_cache
+{
+	struct pool_link* chains[NODE_POOL_CACHE_CHAINS];
+	size_t chains_c;
+	size_t net_frees;
+};
+
+/* Caches of the calling thread by pool id - 1, grown when it first uses
+ * a pool with a higher id and freed when it exits
+ */
+static _Thread_local struct pool_cache* caches;
+static _Thread_local size_t caches_c;
+static pthread_key_t caches_key;
+static pthread_once_t caches_key_once = PTHREAD_ONCE_INIT;
+static int caches_key_err;
+/* Byte i is set while id i + 1 is owned by a pool, guarded by pools_lock */
+static unsigned char* ids_used;
+static size_t ids_c;
+static pthread_mutex_t pools_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct pool_cache* get_cache(struct node_pool* pool_p);
+static unsigned int assign_id(struct node_pool* pool_p);
+static int grow_caches(unsigned int id);
+static void shared_push_chain(struct node_pool* pool_p, struct pool_link* chain_p);
+static int refill(struct node_pool* pool_p, struct pool_cache* cache_p);
+static void give_back(struct node_pool* pool_p, struct pool_cache* cache_p,
+	size_t chains_c);
+static void shared_push(struct node_pool* pool_p, struct pool_link* chain_p);
+
+void* node_pool_alloc(struct node_pool* pool_p)
+{
+	struct pool_cache* cache_p = get_cache(pool_p);
+	if(!cache_p || (!cache_p->chains_c && refill(pool_p, cache_p))) return NULL;
+
+	struct pool_link** top_pp = &cache_p->chains[cache_p->chains_c - 1];
+	struct pool_link* node_p = *top_pp;
+	*top_pp = node_p->next;
+	if(!*top_pp) --cache_p->chains_c;
+	if(cache_p->net_frees) --cache_p->net_frees;
+
+	return node_p;
+}
+
+/* Nodes are moved from cached chains as they are, one cache lookup and
+ * no per node bookkeeping
+ */
+void* node_pool_alloc_chain(struct node_pool* pool_p, size_t n)
+{
+	struct pool_cache* cache_p = get_cache(pool_p);
+	if(!cache_p) return NULL;
+	struct pool_link* head_p = NULL;
+	struct pool_link** tail_pp = &head_p;
+	for(size_t i = 0; i < n; ++i)
+	{
+		if(!cache_p->chains_c && refill(pool_p, cache_p))
+		{
+			*tail_pp = NULL;
+			node_pool_free_chain(pool_p, head_p);
+			return NULL;
+		}
+
+		struct pool_link** top_pp = &cache_p->chains[cache_p->chains_c - 1];
+		*tail_pp = *top_pp;
+		*top_pp = (*top_pp)->next;
+		if(!*top_pp) --cache_p->chains_c;
+		tail_pp = &(*tail_pp)->next;
+	}
+	*tail_pp = NULL;
+	cache_p->net_frees = cache_p->net_frees > n ? cache_p->net_frees - n : 0;
+
+	return head_p;
+}
+
+void node_pool_free(struct node_pool* pool_p, void* node_p)
+{
+	if(!node_p) return;
+
+	struct pool_cache* cache_p = get_cache(pool_p);
+	struct pool_link* link_p = node_p;
+	if(!cache_p)
+	{
+		link_p->next = NULL;
+		shared_push_chain(pool_p, link_p);
+		return;
+	}
+	if(cache_p->chains_c)
+	{
+		link_p->next = cache_p->chains[cache_p->chains_c - 1];
+		cache_p->chains[cache_p->chains_c - 1] = link_p;
+	}
+	else
+	{
+		link_p->next = NULL;
+		cache_p->chains[cache_p->chains_c++] = link_p;
+	}
+
+	/* A thread only freeing nodes allocated by others would grow forever */
+	if(++cache_p->net_frees >= NODE_POOL_CACHE_NODES)
+	{
+		give_back(pool_p, cache_p, 1);
+		cache_p->net_frees = 0;
+	}
+}
+
+void node_pool_free_chain(struct node_pool* pool_p, void* head_p)
+{
+	if(!head_p) return;
+
+	struct pool_cache* cache_p = get_cache(pool_p);
+	if(!cache_p)
+	{
+		shared_push_chain(pool_p, head_p);
+		return;
+	}
+	if(cache_p->chains_c == NODE_POOL_CACHE_CHAINS)
+	{
+		give_back(pool_p, cache_p, NODE_POOL_CACHE_CHAINS / 2);
+	}
+	cache_p->chains[cache_p->chains_c++] = head_p;
+}
+
+void node_pool_thread_flush(struct node_pool* pool_p)
+{
+	struct pool_cache* cache_p = get_cache(pool_p);
+	if(!cache_p) return;
+	give_back(pool_p, cache_p, cache_p->chains_c);
+	cache_p->net_frees = 0;
+}
+
+/* Free nodes are scattered, so they are walked only once, into an array
+ * grown as needed
+ */
+int node_pool_sort_cache(struct node_pool* pool_p)
+{
+	struct pool_cache* cache_p = get_cache(pool_p);
+	if(!cache_p) return 0;
+	size_t links_c = 0;
+	size_t links_cap = 0;
+	struct pool_link** links_p = NULL;
+	for(size_t i = 0; i < cache_p->chains_c; ++i)
+	{
+		for(struct pool_link* link_p = cache_p->chains[i]; link_p; link_p = link_p->next)
+		{
+			if(links_c == links_cap)
+			{
+				links_cap = links_cap ? 2 * links_cap : NODE_POOL_SLAB_NODES;
+				struct pool_link** grown_p = realloc(links_p, links_cap * sizeof(*links_p));
+				if(!grown_p)
+				{
+					free(links_p);
+					return -1;
+				}
+				links_p = grown_p;
+			}
+			links_p[links_c++] = link_p;
+		}
+	}
+	if(links_c < 2 || node_pool_sort_by_address((void**)links_p, links_c))
+	{
+		free(links_p);
+		return links_c < 2 ? 0 : -1;
+	}
+
+	for(size_t j = 0; j + 1 < links_c; ++j)
+	{
+		links_p[j]->next = links_p[j + 1];
+	}
+	links_p[links_c - 1]->next = NULL;
+	cache_p->chains[0] = links_p[0];
+	cache_p->chains_c = 1;
+
+	free(links_p);
+	return 0;
+}
+
+/* Only bits which differ between the lowest and highest address are
+ * sorted, nodes are at least pointer aligned, so the lowest ones are skipped
+ */
+int node_pool_sort_by_address(void** nodes_p, size_t n)
+{
+	if(n < 2) return 0;
+
+	uintptr_t min = (uintptr_t)nodes_p[0];
+	uintptr_t max = min;
+	for(size_t i = 1; i < n; ++i)
+	{
+		uintptr_t address = (uintptr_t)nodes_p[i];
+		if(address < min) min = address;
+		if(address > max) max = address;
+	}
+
+	void** temp_p = malloc(n * sizeof(*temp_p));
+	if(!temp_p) return -1;
+
+	/* Every pass moves nodes from src to dest, keeping order within digits */
+	void** src_p = nodes_p;
+	void** dest_p = temp_p;
+	const unsigned int low_bits = __builtin_ctzll(sizeof(struct pool_link));
+	for(unsigned int shift = low_bits; shift < 8 * sizeof(uintptr_t) && (max - min) >> shift;
+		shift += RADIX_BITS)
+	{
+		size_t starts[RADIX_BUCKETS] = {0};
+		for(size_t i = 0; i < n; ++i)
+		{
+			++starts[(((uintptr_t)src_p[i] - min) >> shift) & (RADIX_BUCKETS - 1)];
+		}
+		size_t start = 0;
+		for(size_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket)
+		{
+			size_t bucket_c = starts[bucket];
+			starts[bucket] = start;
+			start += bucket_c;
+		}
+		for(size_t i = 0; i < n; ++i)
+		{
+			dest_p[starts[(((uintptr_t)src_p[i] - min) >> shift) & (RADIX_BUCKETS - 1)]++] = src_p[i];
+		}
+
+		void** swapped_p = src_p;
+		src_p = dest_p;
+		dest_p = swapped_p;
+	}
+
+	if(src_p != nodes_p)
+	{
+		memcpy(nodes_p, src_p, n * sizeof(*nodes_p));
+	}
+	free(temp_p);
+	return 0;
+}
+
+void node_pool_destroy(struct node_pool* pool_p)
+{
+	pthread_mutex_lock(&pool_p->lock);
+	while(pool_p->slabs)
+	{
+		struct pool_link* to_free = pool_p->slabs;
+		pool_p->slabs = to_free->next;
+		free(to_free);
+	}
+	free(pool_p->shared);
+	pool_p->shared = NULL;
+	pool_p->shared_c = 0;
+	pool_p->shared_cap = 0;
+	pthread_mutex_unlock(&pool_p->lock);
+
+	/* Caches of other threads must be flushed already */
+	pthread_mutex_lock(&pools_lock);
+	if(pool_p->id)
+	{
+		if(pool_p->id <= caches_c)
+		{
+			caches[pool_p->id - 1].chains_c = 0;
+			caches[pool_p->id - 1].net_frees = 0;
+		}
+		ids_used[pool_p->id - 1] = 0;
+		pool_p->id = 0;
+	}
+	pthread_mutex_unlock(&pools_lock);
+}
+
+/* @return cache of the calling thread, NULL when out of memory for it */
+static struct pool_cache* get_cache(struct node_pool* pool_p)
+{
+	unsigned int id = __atomic_load_n(&pool_p->id, __ATOMIC_ACQUIRE);
+	if(!id && !(id = assign_id(pool_p))) return NULL;
+	if(id > caches_c && grow_caches(id)) return NULL;
+	return &caches[id - 1];
+}
+
+/* Lowest id no other pool owns, so caches stay dense
+ * @return id, 0 when out of memory
+ */
+static unsigned int assign_id(struct node_pool* pool_p)
+{
+	pthread_mutex_lock(&pools_lock);
+	unsigned int id = pool_p->id;
+	if(!id)
+	{
+		size_t i = 0;
+		while(i < ids_c && ids_used[i]) ++i;
+		if(i == ids_c)
+		{
+			size_t cap = ids_c ? 2 * ids_c : NODE_POOL_CACHES_INIT;
+			unsigned char* grown_p = realloc(ids_used, cap);
+			if(!grown_p)
+			{
+				pthread_mutex_unlock(&pools_lock);
+				return 0;
+			}
+			memset(grown_p + ids_c, 0, cap - ids_c);
+			ids_used = grown_p;
+			ids_c = cap;
+		}
+		ids_used[i] = 1;
+		id = i + 1;
+		__atomic_store_n(&pool_p->id, id, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&pools_lock);
+	return id;
+}
+
+/* Runs when a thread exits, its cached nodes are lost unless flushed */
+static void free_caches(void* caches_p)
+{
+	free(caches_p);
+	caches = NULL;
+	caches_c = 0;
+}
+
+static void create_caches_key(void)
+{
+	caches_key_err = pthread_key_create(&caches_key, free_caches);
+}
+
+/* Makes room for caches of pools up to id in the calling thread
+ * @return 0 on success, -1 when out of memory
+ */
+static int grow_caches(unsigned int id)
+{
+	pthread_once(&caches_key_once, create_caches_key);
+	if(caches_key_err) return -1;
+
+	size_t cap = caches_c ? caches_c : NODE_POOL_CACHES_INIT;
+	while(cap < id) cap *= 2;
+	struct pool_cache* grown_p = realloc(caches, cap * sizeof(*grown_p));
+	if(!grown_p) return -1;
+	memset(grown_p + caches_c, 0, (cap - caches_c) * sizeof(*grown_p));
+	caches = grown_p;
+	caches_c = cap;
+	/* When it fails, the table is only left behind at exit */
+	pthread_setspecific(caches_key, caches);
+	return 0;
+}
+
+/* Takes chains given back by other threads, or carves a new slab
+ * @return 0 on success, -1 when out of memory
+ */
+static int refill(struct node_pool* pool_p, struct pool_cache* cache_p)
+{
+	pthread_mutex_lock(&pool_p->lock);
+	while(pool_p->shared_c && cache_p->chains_c < NODE_POOL_REFILL_CHAINS)
+	{
+		cache_p->chains[cache_p->chains_c++] = pool_p->shared[--pool_p->shared_c];
+	}
+	if(cache_p->chains_c)
+	{
+		pthread_mutex_unlock(&pool_p->lock);
+		return 0;
+	}
+
+	struct pool_link* slab_p =
+		aligned_alloc(NODE_POOL_ALIGN,
+			SLAB_HEADER_SIZE + NODE_POOL_SLAB_NODES * pool_p->node_size);
+	if(!slab_p)
+	{
+		pthread_mutex_unlock(&pool_p->lock);
+		return -1;
+	}
+	slab_p->next = pool_p->slabs;
+	pool_p->slabs = slab_p;
+	pthread_mutex_unlock(&pool_p->lock);
+
+	char* nodes_p = (char*)slab_p + SLAB_HEADER_SIZE;
+	for(size_t i = 0; i + 1 < NODE_POOL_SLAB_NODES; ++i)
+	{
+		((struct pool_link*)(nodes_p + i * pool_p->node_size))->next =
+			(struct pool_link*)(nodes_p + (i + 1) * pool_p->node_size);
+	}
+	((struct pool_link*)(nodes_p + (NODE_POOL_SLAB_NODES - 1) * pool_p->node_size))->next
+		= NULL;
+	cache_p->chains[cache_p->chains_c++] = (struct pool_link*)nodes_p;
+
+	return 0;
+}
+
+/* Moves top chains_c chains of the cache to the shared stack */
+static void give_back(struct node_pool* pool_p, struct pool_cache* cache_p,
+	size_t chains_c)
+{
+	pthread_mutex_lock(&pool_p->lock);
+	while(chains_c-- && cache_p->chains_c)
+	{
+		shared_push(pool_p, cache_p->chains[--cache_p->chains_c]);
+	}
+	pthread_mutex_unlock(&pool_p->lock);
+}
+
+/* Frees of a thread without a cache skip it */
+static void shared_push_chain(struct node_pool* pool_p, struct pool_link* chain_p)
+{
+	pthread_mutex_lock(&pool_p->lock);
+	shared_push(pool_p, chain_p);
+	pthread_mutex_unlock(&pool_p->lock);
+}
+
+/* Must be called with pool lock held */
+static void shared_push(struct node_pool* pool_p, struct pool_link* chain_p)
+{
+	if(pool_p->shared_c == pool_p->shared_cap)
+	{
+		size_t cap = pool_p->shared_cap ? 2 * pool_p->shared_cap : NODE_POOL_CACHE_CHAINS;
+		struct pool_link** grown_p = realloc(pool_p->shared, cap * sizeof(*grown_p));
+		if(!grown_p)
+		{
+			/* No room for another chain, append it to the last one */
+			if(pool_p->shared_c)
+			{
+				struct pool_link* tail_p = chain_p;
+				while(tail_p->next) tail_p = tail_p->next;
+				tail_p->next = pool_p->shared[pool_p->shared_c - 1];
+				pool_p->shared[pool_p->shared_c - 1] = chain_p;
+			}
+			/* Nothing shared at all, the nodes stay lost in their slab */
+			return;
+		}
+		pool_p->shared = grown_p;
+		pool_p->shared_cap = cap;
+	}
+	pool_p->shared[pool_p->shared_c++] = chain_p;
+}
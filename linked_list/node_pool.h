@@ -0,0 +1,72 @@
+#ifndef NODE_POOL_H_
+#define NODE_POOL_H_
+
+#include <stddef.h>
+#include <pthread.h>
+
+#define NODE_POOL_SLAB_NODES    1024U
+/* Chains kept by one thread before half of them go to the shared stack */
+#define NODE_POOL_CACHE_CHAINS  64U
+/* Net number of single frees kept by one thread before giving back */
+#define NODE_POOL_CACHE_NODES   4096U
+#define NODE_POOL_REFILL_CHAINS 8U
+/* Pool caches a thread starts with, doubled when it uses more pools */
+#define NODE_POOL_CACHES_INIT   8U
+/* Slabs are cache line aligned, so line sized nodes never straddle two.
+ * Slab size is a multiple of it for any node size, as aligned_alloc needs.
+ */
+#define NODE_POOL_ALIGN         64U
+
+/* Free nodes are chained through their first member, so any node type
+ * whose first member is the next pointer can be pooled
+ */
+struct pool_link
+{
+	struct pool_link* next;
+};
+
+struct node_pool
+{
+	size_t node_size;
+	/* Index of thread local cache + 1, assigned on first use
+	 * and released by node_pool_destroy(), any number of pools may be live
+	 */
+	unsigned int id;
+	pthread_mutex_t lock;
+	/* Chains given back by threads, guarded by lock */
+	struct pool_link** shared;
+	size_t shared_c;
+	size_t shared_cap;
+	/* Every slab allocated, freed by node_pool_destroy() */
+	struct pool_link* slabs;
+};
+
+#define NODE_POOL_INIT(type) \
+	{sizeof(type), 0, PTHREAD_MUTEX_INITIALIZER, NULL, 0, 0, NULL}
+
+/* @return node, NULL when out of memory */
+void* node_pool_alloc(struct node_pool* pool_p);
+/* Takes n nodes at once, chained by next and NULL terminated
+ * @return head of the chain, NULL when out of memory or n is 0
+ */
+void* node_pool_alloc_chain(struct node_pool* pool_p, size_t n);
+void node_pool_free(struct node_pool* pool_p, void* node_p);
+/* Gives back a whole NULL terminated chain of nodes in O(1) */
+void node_pool_free_chain(struct node_pool* pool_p, void* head_p);
+/* Moves nodes cached by calling thread to the shared stack,
+ * call before a thread using the pool exits
+ */
+void node_pool_thread_flush(struct node_pool* pool_p);
+/* Merges free nodes cached by calling thread into one chain ordered by
+ * address, so following allocations walk memory sequentially
+ * @return -1 when out of memory for sorting, cache is unchanged then
+ */
+int node_pool_sort_cache(struct node_pool* pool_p);
+/* Radix sorts pointers to nodes by address
+ * @return -1 when out of memory, nodes are unchanged then
+ */
+int node_pool_sort_by_address(void** nodes_p, size_t n);
+/* Frees all memory, no node of the pool may be in use anymore */
+void node_pool_destroy(struct node_pool* pool_p);
+
+#endif /* NODE_POOL_H_ */
@@ -0,0 +1,353 @@
+#include <criterion.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "node_pool.h"
+#include "linked_list.h"
+
+#define THREADS_NUM 4U
+
+struct test_node
+{
+	struct test_node* next;
+	unsigned long value;
+};
+
+static size_t slabs_count(struct node_pool* pool_p)
+{
+	size_t slabs_c = 0;
+	for(struct pool_link* slab_p = pool_p->slabs; slab_p; slab_p = slab_p->next)
+	{
+		++slabs_c;
+	}
+	return slabs_c;
+}
+
+Test(node_pool_suite, freed_node_is_reused)
+{
+	struct node_pool pool = NODE_POOL_INIT(struct test_node);
+
+	struct test_node* first_p = node_pool_alloc(&pool);
+	cr_assert_neq(NULL, first_p);
+	node_pool_free(&pool, first_p);
+	struct test_node* second_p = node_pool_alloc(&pool);
+	cr_assert_eq(first_p, second_p);
+	node_pool_free(&pool, second_p);
+
+	node_pool_destroy(&pool);
+}
+
+Test(node_pool_suite, chain_is_reused_without_new_slabs)
+{
+	struct node_pool pool = NODE_POOL_INIT(struct test_node);
+	const unsigned int count = 5 * NODE_POOL_SLAB_NODES;
+
+	struct test_node* head_p = NULL;
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		struct test_node* new_p = node_pool_alloc(&pool);
+		cr_assert_neq(NULL, new_p);
+		new_p->value = i;
+		new_p->next = head_p;
+		head_p = new_p;
+	}
+	size_t slabs_c = slabs_count(&pool);
+	cr_assert_eq(5, slabs_c);
+
+	node_pool_free_chain(&pool, head_p);
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		cr_assert_neq(NULL, node_pool_alloc(&pool));
+	}
+	cr_assert_eq(slabs_c, slabs_count(&pool));
+
+	node_pool_destroy(&pool);
+}
+
+/* Other thread uses every pool, growing its own caches from scratch */
+static void* alloc_from_pools(void* arg)
+{
+	struct node_pool* pools = arg;
+	for(unsigned int i = 0; i < 4 * NODE_POOL_CACHES_INIT; ++i)
+	{
+		struct test_node* node_p = node_pool_alloc(&pools[i]);
+		if(!node_p) return NULL;
+		node_pool_free(&pools[i], node_p);
+		node_pool_thread_flush(&pools[i]);
+	}
+	return arg;
+}
+
+/* Caches grow with the number of live pools, each pool keeps its own */
+Test(node_pool_suite, more_pools_than_initial_caches)
+{
+	const unsigned int pools_c = 4 * NODE_POOL_CACHES_INIT;
+	struct node_pool pools[4 * NODE_POOL_CACHES_INIT];
+	struct test_node* nodes[4 * NODE_POOL_CACHES_INIT];
+	for(unsigned int i = 0; i < pools_c; ++i)
+	{
+		pools[i] = (struct node_pool)NODE_POOL_INIT(struct test_node);
+		nodes[i] = node_pool_alloc(&pools[i]);
+		cr_assert_neq(NULL, nodes[i]);
+		nodes[i]->value = i;
+	}
+	for(unsigned int i = 0; i < pools_c; ++i)
+	{
+		cr_assert_eq(i, nodes[i]->value);
+		node_pool_free(&pools[i], nodes[i]);
+		cr_assert_eq(nodes[i], node_pool_alloc(&pools[i]));
+		node_pool_free(&pools[i], nodes[i]);
+	}
+
+	pthread_t thread;
+	void* result_p;
+	cr_assert_eq(0, pthread_create(&thread, NULL, alloc_from_pools, pools));
+	cr_assert_eq(0, pthread_join(thread, &result_p));
+	cr_assert_eq(pools, result_p);
+
+	/* Ids of destroyed pools are taken again */
+	unsigned int max_id = 0;
+	for(unsigned int i = 0; i < pools_c; ++i)
+	{
+		if(pools[i].id > max_id) max_id = pools[i].id;
+		node_pool_destroy(&pools[i]);
+	}
+	struct node_pool pool = NODE_POOL_INIT(struct test_node);
+	cr_assert_neq(NULL, node_pool_alloc(&pool));
+	cr_assert_leq(pool.id, max_id);
+	node_pool_destroy(&pool);
+}
+
+/* Nodes freed in reverse order come out in address order after sorting */
+Test(node_pool_suite, sorted_cache_allocates_sequentially)
+{
+	struct node_pool pool = NODE_POOL_INIT(struct test_node);
+	const unsigned int count = 3 * NODE_POOL_SLAB_NODES;
+
+	struct test_node* nodes[3 * NODE_POOL_SLAB_NODES];
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		nodes[i] = node_pool_alloc(&pool);
+		cr_assert_neq(NULL, nodes[i]);
+	}
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		node_pool_free(&pool, nodes[(i * 7919) % count]);
+	}
+
+	cr_assert_eq(0, node_pool_sort_cache(&pool));
+	struct test_node* last_p = node_pool_alloc(&pool);
+	for(unsigned int i = 1; i < count; ++i)
+	{
+		struct test_node* next_p = node_pool_alloc(&pool);
+		cr_assert_lt(last_p, next_p);
+		last_p = next_p;
+	}
+
+	node_pool_destroy(&pool);
+}
+
+Test(node_pool_suite, clear_returns_list_to_pool)
+{
+	list_t list;
+	init(&list);
+	for(int i = 0; i < 1000; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_front(&list, (char)i));
+	}
+	struct node* head_p = list.head;
+	clear(&list);
+	cr_assert_eq(NULL, list.head);
+
+	/* Last freed chain is the first one to be reused */
+	cr_assert_eq(RESULT_OK, push_front(&list, 'a'));
+	cr_assert_eq(head_p, list.head);
+	clear(&list);
+}
+
+struct handoff
+{
+	struct node_pool* pool_p;
+	struct test_node* head_p;
+};
+
+static void* free_all(void* arg)
+{
+	struct handoff* handoff_p = arg;
+	while(handoff_p->head_p)
+	{
+		struct test_node* to_free = handoff_p->head_p;
+		handoff_p->head_p = to_free->next;
+		node_pool_free(handoff_p->pool_p, to_free);
+	}
+	node_pool_thread_flush(handoff_p->pool_p);
+	return NULL;
+}
+
+Test(node_pool_suite, nodes_freed_by_other_thread_are_reused)
+{
+	struct node_pool pool = NODE_POOL_INIT(struct test_node);
+	const unsigned int count = 4 * NODE_POOL_SLAB_NODES;
+
+	struct handoff handoff = {&pool, NULL};
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		struct test_node* new_p = node_pool_alloc(&pool);
+		cr_assert_neq(NULL, new_p);
+		new_p->next = handoff.head_p;
+		handoff.head_p = new_p;
+	}
+	size_t slabs_c = slabs_count(&pool);
+
+	pthread_t thread;
+	cr_assert_eq(0, pthread_create(&thread, NULL, free_all, &handoff));
+	cr_assert_eq(0, pthread_join(thread, NULL));
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		cr_assert_neq(NULL, node_pool_alloc(&pool));
+	}
+	cr_assert_eq(slabs_c, slabs_count(&pool));
+
+	node_pool_destroy(&pool);
+}
+
+struct churn_args
+{
+	struct node_pool* pool_p;
+	unsigned int rounds;
+	unsigned int depth;
+	unsigned long id;
+	int errors_c;
+};
+
+/* Every thread keeps depth nodes alive, checks nobody else touched them */
+static void* pool_churn(void* arg)
+{
+	struct churn_args* args_p = arg;
+	for(unsigned int round = 0; round < args_p->rounds; ++round)
+	{
+		struct test_node* head_p = NULL;
+		for(unsigned int i = 0; i < args_p->depth; ++i)
+		{
+			struct test_node* new_p = node_pool_alloc(args_p->pool_p);
+			if(!new_p)
+			{
+				++args_p->errors_c;
+				break;
+			}
+			new_p->value = args_p->id;
+			new_p->next = head_p;
+			head_p = new_p;
+		}
+		for(struct test_node* node_p = head_p; node_p; node_p = node_p->next)
+		{
+			if(node_p->value != args_p->id) ++args_p->errors_c;
+		}
+		/* Give back alternately one by one and as a whole */
+		if(round % 2)
+		{
+			node_pool_free_chain(args_p->pool_p, head_p);
+			continue;
+		}
+		while(head_p)
+		{
+			struct test_node* to_free = head_p;
+			head_p = head_p->next;
+			node_pool_free(args_p->pool_p, to_free);
+		}
+	}
+	node_pool_thread_flush(args_p->pool_p);
+	return NULL;
+}
+
+static void* malloc_churn(void* arg)
+{
+	struct churn_args* args_p = arg;
+	for(unsigned int round = 0; round < args_p->rounds; ++round)
+	{
+		struct test_node* head_p = NULL;
+		for(unsigned int i = 0; i < args_p->depth; ++i)
+		{
+			struct test_node* new_p = malloc(sizeof(*new_p));
+			if(!new_p)
+			{
+				++args_p->errors_c;
+				break;
+			}
+			new_p->value = args_p->id;
+			new_p->next = head_p;
+			head_p = new_p;
+		}
+		while(head_p)
+		{
+			struct test_node* to_free = head_p;
+			head_p = head_p->next;
+			free(to_free);
+		}
+	}
+	return NULL;
+}
+
+/* @return wall clock nanoseconds of running routine in threads_num threads */
+static long long run_threads(void* (*routine)(void*), struct node_pool* pool_p,
+	unsigned int threads_num, unsigned int rounds, unsigned int depth)
+{
+	pthread_t threads[THREADS_NUM];
+	struct churn_args args[THREADS_NUM];
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int i = 0; i < threads_num; ++i)
+	{
+		args[i] = (struct churn_args){pool_p, rounds, depth, i + 1, 0};
+		cr_assert_eq(0, pthread_create(&threads[i], NULL, routine, &args[i]));
+	}
+	for(unsigned int i = 0; i < threads_num; ++i)
+	{
+		cr_assert_eq(0, pthread_join(threads[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+}
+
+Test(node_pool_suite, threads_stress)
+{
+	struct node_pool pool = NODE_POOL_INIT(struct test_node);
+	run_threads(pool_churn, &pool, THREADS_NUM, 200, 3 * NODE_POOL_SLAB_NODES);
+	node_pool_destroy(&pool);
+}
+
+Test(node_pool_suite, time_measurements, .disabled = false)
+{
+	const unsigned int rounds = 10000;
+	const unsigned int depth = 1000;
+	struct churn_args args;
+
+	cr_log_info("Measure cycles for %d rounds of allocating and freeing "
+			    "%d nodes:", rounds, depth);
+	struct node_pool pool = NODE_POOL_INIT(struct test_node);
+	args = (struct churn_args){&pool, rounds, depth, 1, 0};
+	clock_t start = clock();
+	pool_churn(&args);
+	clock_t end = clock();
+	cr_assert_eq(0, args.errors_c);
+	cr_log_info("node pool CPU ticks used: %9ld", (long)(end - start));
+	node_pool_destroy(&pool);
+
+	args = (struct churn_args){NULL, rounds, depth, 1, 0};
+	start = clock();
+	malloc_churn(&args);
+	end = clock();
+	cr_assert_eq(0, args.errors_c);
+	cr_log_info("malloc    CPU ticks used: %9ld", (long)(end - start));
+
+	cr_log_info("Measure wall clock of the same churn in %d threads:", THREADS_NUM);
+	pool = (struct node_pool)NODE_POOL_INIT(struct test_node);
+	long long pool_ns = run_threads(pool_churn, &pool, THREADS_NUM, rounds, depth);
+	node_pool_destroy(&pool);
+	long long malloc_ns = run_threads(malloc_churn, NULL, THREADS_NUM, rounds, depth);
+	cr_log_info("node pool ms: %9lld", pool_ns / 1000000);
+	cr_log_info("malloc    ms: %9lld", malloc_ns / 1000000);
+}
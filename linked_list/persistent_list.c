@@ -0,0 +1,89 @@
+#include <stdlib.h>
+#include <assert.h>
+
+#include "persistent_list.h"
+#include "node_pool.h"
+
+_Static_assert(sizeof(struct pnode) == sizeof(struct node), "pnode must fit a node");
+
+static struct node_pool pnodes = NODE_POOL_INIT(struct pnode);
+
+static struct pnode* acquire(struct pnode* node_p);
+
+void plist_init(plist_t* list_p)
+{
+	list_p->head = NULL;
+	list_p->size = 0;
+}
+
+int plist_push_front(const plist_t* list_p, const char new_data, plist_t* new_version_p)
+{
+	struct pnode* new_p = node_pool_alloc(&pnodes);
+	if(!new_p) return RESULT_NOK;
+
+	new_p->next = acquire(list_p->head);
+	new_p->data = new_data;
+	new_p->refs = 1;
+	new_version_p->head = new_p;
+	new_version_p->size = list_p->size + 1;
+
+	return RESULT_OK;
+}
+
+int plist_pop_front(const plist_t* list_p, char* data_storage, plist_t* rest_p)
+{
+	if(!list_p->head) return RESULT_NOK;
+
+	*data_storage = list_p->head->data;
+	rest_p->head = acquire(list_p->head->next);
+	rest_p->size = list_p->size - 1;
+
+	return RESULT_OK;
+}
+
+void plist_snapshot(const plist_t* list_p, plist_t* snapshot_p)
+{
+	snapshot_p->head = acquire(list_p->head);
+	snapshot_p->size = list_p->size;
+}
+
+/* Dropping the last reference to a node drops its reference to the next
+ * one, so a released version frees its nodes up to the first shared one
+ */
+void plist_release(plist_t* list_p)
+{
+	struct pnode* node_p = list_p->head;
+	while(node_p && __atomic_sub_fetch(&node_p->refs, 1, __ATOMIC_ACQ_REL) == 0)
+	{
+		struct pnode* next_p = node_p->next;
+		node_pool_free(&pnodes, node_p);
+		node_p = next_p;
+	}
+	plist_init(list_p);
+}
+
+unsigned int plist_count(const plist_t* list_p)
+{
+#ifdef CHECK_COUNT
+	/* Cross-check the cached size against a full walk */
+	unsigned int elements_c = 0;
+	for(struct pnode* node_p = list_p->head; node_p; node_p = node_p->next)
+	{
+		++elements_c;
+	}
+	assert(elements_c == list_p->size);
+#endif
+	return list_p->size;
+}
+
+void plist_thread_flush(void)
+{
+	node_pool_thread_flush(&pnodes);
+}
+
+/* The caller holds a reference already, so nothing frees the node meanwhile */
+static struct pnode* acquire(struct pnode* node_p)
+{
+	if(node_p) __atomic_add_fetch(&node_p->refs, 1, __ATOMIC_RELAXED);
+	return node_p;
+}
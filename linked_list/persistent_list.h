@@ -0,0 +1,47 @@
+#ifndef PERSISTENT_LIST_H_
+#define PERSISTENT_LIST_H_
+
+#include "linked_list.h"
+
+#define plist_is_empty(list) ((list).head == NULL)
+
+/* Nodes never change once linked, so versions share them. Each node is
+ * referenced by versions starting at it and by the node before it, and
+ * fits the padding of struct node, so it takes no more memory.
+ */
+struct pnode
+{
+	struct pnode* next;
+	char data;
+	unsigned int refs;
+};
+
+/* One version of an immutable list. Versions may be passed to and read
+ * from any thread without locking, each has to be released once.
+ */
+struct plist
+{
+	struct pnode* head;
+	unsigned int size;
+};
+
+typedef struct plist plist_t;
+
+void plist_init(plist_t* list_p);
+/* New version is new_data followed by list, which stays as it was
+ * @return RESULT_NOK when out of memory
+ */
+int plist_push_front(const plist_t* list_p, const char new_data, plist_t* new_version_p);
+/* Rest is the version without the first element
+ * @return RESULT_NOK when list is empty
+ */
+int plist_pop_front(const plist_t* list_p, char* data_storage, plist_t* rest_p);
+/* O(1), the snapshot is another reference to the same version */
+void plist_snapshot(const plist_t* list_p, plist_t* snapshot_p);
+/* Frees nodes no other version uses, list is left empty */
+void plist_release(plist_t* list_p);
+unsigned int plist_count(const plist_t* list_p);
+/* Gives nodes cached by calling thread back, call before it exits */
+void plist_thread_flush(void);
+
+#endif /* PERSISTENT_LIST_H_ */
@@ -0,0 +1,382 @@
+#include <criterion.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "persistent_list.h"
+
+#define MAX_READERS 8U
+
+/* @return 1 if list holds exactly the chars of expected, in its order */
+static int is_equal_to(const plist_t* list_p, const char* expected)
+{
+	const struct pnode* node_p = list_p->head;
+	for(unsigned int i = 0; expected[i]; ++i)
+	{
+		if(!node_p || node_p->data != expected[i]) return 0;
+		node_p = node_p->next;
+	}
+	return !node_p && plist_count(list_p) == strlen(expected);
+}
+
+Test(persistent_list_suite, versions_share_tail)
+{
+	plist_t empty, c, bc, abc, xbc;
+	plist_init(&empty);
+	cr_assert(plist_is_empty(empty));
+
+	cr_assert_eq(RESULT_OK, plist_push_front(&empty, 'c', &c));
+	cr_assert_eq(RESULT_OK, plist_push_front(&c, 'b', &bc));
+	cr_assert_eq(RESULT_OK, plist_push_front(&bc, 'a', &abc));
+	cr_assert_eq(RESULT_OK, plist_push_front(&bc, 'x', &xbc));
+
+	cr_assert(is_equal_to(&c, "c"));
+	cr_assert(is_equal_to(&bc, "bc"));
+	cr_assert(is_equal_to(&abc, "abc"));
+	cr_assert(is_equal_to(&xbc, "xbc"));
+	cr_assert(plist_is_empty(empty));
+	cr_assert_eq(bc.head, abc.head->next);
+	cr_assert_eq(bc.head, xbc.head->next);
+	/* bc itself, abc and xbc */
+	cr_assert_eq(3, bc.head->refs);
+
+	/* Releasing a version keeps nodes others still use */
+	plist_release(&bc);
+	cr_assert(plist_is_empty(bc));
+	cr_assert_eq(2, abc.head->next->refs);
+	plist_release(&abc);
+	cr_assert(is_equal_to(&xbc, "xbc"));
+	cr_assert_eq(1, xbc.head->next->refs);
+
+	plist_release(&c);
+	plist_release(&xbc);
+	plist_release(&empty);
+}
+
+Test(persistent_list_suite, pop_and_snapshot)
+{
+	plist_t list, snapshot, rest;
+	plist_init(&list);
+	char popped = '\0';
+	cr_assert_eq(RESULT_NOK, plist_pop_front(&list, &popped, &rest));
+
+	for(char c = 'z'; c >= 'a'; --c)
+	{
+		plist_t longer;
+		cr_assert_eq(RESULT_OK, plist_push_front(&list, c, &longer));
+		plist_release(&list);
+		list = longer;
+	}
+	plist_snapshot(&list, &snapshot);
+	cr_assert_eq(list.head, snapshot.head);
+	cr_assert_eq(26, plist_count(&snapshot));
+
+	/* Popping everything from the list leaves the snapshot whole */
+	for(char c = 'a'; c <= 'z'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, plist_pop_front(&list, &popped, &rest));
+		cr_assert_eq(c, popped);
+		plist_release(&list);
+		list = rest;
+	}
+	cr_assert(plist_is_empty(list));
+	cr_assert(is_equal_to(&snapshot, "abcdefghijklmnopqrstuvwxyz"));
+	cr_assert_eq(1, snapshot.head->refs);
+	plist_release(&snapshot);
+}
+
+/* Latest version is published under a lock, readers traverse their
+ * snapshots without it
+ */
+struct shared_version
+{
+	pthread_mutex_t lock;
+	plist_t current;
+	int is_done;
+};
+
+static void take_snapshot(struct shared_version* shared_p, plist_t* snapshot_p)
+{
+	pthread_mutex_lock(&shared_p->lock);
+	plist_snapshot(&shared_p->current, snapshot_p);
+	pthread_mutex_unlock(&shared_p->lock);
+}
+
+static void publish(struct shared_version* shared_p, plist_t* version_p)
+{
+	pthread_mutex_lock(&shared_p->lock);
+	plist_t old = shared_p->current;
+	shared_p->current = *version_p;
+	pthread_mutex_unlock(&shared_p->lock);
+	plist_release(&old);
+}
+
+struct reader_args
+{
+	struct shared_version* shared_p;
+	unsigned int traversals_c;
+	int errors_c;
+};
+
+/* Every version holds n, n - 1, ..., 1 modulo 100, whatever n it saw */
+static void* checking_reader(void* arg)
+{
+	struct reader_args* args_p = arg;
+	while(!__atomic_load_n(&args_p->shared_p->is_done, __ATOMIC_ACQUIRE))
+	{
+		plist_t snapshot;
+		take_snapshot(args_p->shared_p, &snapshot);
+		unsigned int expected = plist_count(&snapshot);
+		for(const struct pnode* node_p = snapshot.head; node_p; node_p = node_p->next)
+		{
+			if(node_p->data != (char)(expected % 100)) ++args_p->errors_c;
+			--expected;
+		}
+		if(expected) ++args_p->errors_c;
+		plist_release(&snapshot);
+		++args_p->traversals_c;
+	}
+	plist_thread_flush();
+	return NULL;
+}
+
+Test(persistent_list_suite, threads_snapshots)
+{
+	const unsigned int readers_c = 4;
+	struct shared_version shared = {PTHREAD_MUTEX_INITIALIZER, {NULL, 0}, 0};
+
+	pthread_t readers[MAX_READERS];
+	struct reader_args args[MAX_READERS];
+	memset(args, 0, sizeof(args));
+	for(unsigned int i = 0; i < readers_c; ++i)
+	{
+		args[i].shared_p = &shared;
+		cr_assert_eq(0, pthread_create(&readers[i], NULL, checking_reader, &args[i]));
+	}
+
+	/* Writer grows the list and every 1000 versions starts over */
+	plist_t version;
+	plist_init(&version);
+	for(unsigned int i = 0; i < 200000; ++i)
+	{
+		plist_t next;
+		if(plist_count(&version) == 1000)
+		{
+			plist_init(&next);
+		}
+		else
+		{
+			cr_assert_eq(RESULT_OK, plist_push_front(&version, (char)((plist_count(&version) + 1) % 100), &next));
+		}
+		plist_release(&version);
+		plist_snapshot(&next, &version);
+		publish(&shared, &next);
+	}
+	__atomic_store_n(&shared.is_done, 1, __ATOMIC_RELEASE);
+
+	for(unsigned int i = 0; i < readers_c; ++i)
+	{
+		cr_assert_eq(0, pthread_join(readers[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+	}
+	plist_release(&version);
+	plist_release(&shared.current);
+}
+
+static unsigned int walk_plist(const plist_t* list_p)
+{
+	unsigned int sum = 0;
+	for(const struct pnode* node_p = list_p->head; node_p; node_p = node_p->next)
+	{
+		sum += node_p->data;
+	}
+	return sum;
+}
+
+static unsigned int walk_list(list_t* list_p)
+{
+	unsigned int sum = 0;
+	for(struct node* node_p = list_p->head; node_p; node_p = node_p->next)
+	{
+		sum += node_p->data;
+	}
+	return sum;
+}
+
+struct bench_args
+{
+	struct shared_version* shared_p;
+	pthread_mutex_t* lock_p;
+	list_t* list_p;
+	unsigned int traversals_c;
+	unsigned int length;
+	int errors_c;
+};
+
+static void* snapshot_reader(void* arg)
+{
+	struct bench_args* args_p = arg;
+	for(unsigned int i = 0; i < args_p->traversals_c; ++i)
+	{
+		plist_t snapshot;
+		take_snapshot(args_p->shared_p, &snapshot);
+		if(walk_plist(&snapshot) != plist_count(&snapshot)) ++args_p->errors_c;
+		plist_release(&snapshot);
+	}
+	plist_thread_flush();
+	return NULL;
+}
+
+/* Without snapshots the list stays locked for the whole traversal */
+static void* locking_reader(void* arg)
+{
+	struct bench_args* args_p = arg;
+	for(unsigned int i = 0; i < args_p->traversals_c; ++i)
+	{
+		pthread_mutex_lock(args_p->lock_p);
+		if(walk_list(args_p->list_p) != count(args_p->list_p)) ++args_p->errors_c;
+		pthread_mutex_unlock(args_p->lock_p);
+	}
+	return NULL;
+}
+
+/* Writer keeps adding elements and dropping them again around length */
+static void* snapshot_writer(void* arg)
+{
+	struct bench_args* args_p = arg;
+	plist_t version;
+	take_snapshot(args_p->shared_p, &version);
+	while(!__atomic_load_n(&args_p->shared_p->is_done, __ATOMIC_ACQUIRE))
+	{
+		plist_t next;
+		char popped = '\0';
+		if(plist_count(&version) > args_p->length)
+		{
+			plist_pop_front(&version, &popped, &next);
+		}
+		else if(plist_push_front(&version, 1, &next))
+		{
+			++args_p->errors_c;
+			break;
+		}
+		plist_release(&version);
+		plist_snapshot(&next, &version);
+		publish(args_p->shared_p, &next);
+	}
+	plist_release(&version);
+	plist_thread_flush();
+	return NULL;
+}
+
+static void* locking_writer(void* arg)
+{
+	struct bench_args* args_p = arg;
+	while(!__atomic_load_n(&args_p->shared_p->is_done, __ATOMIC_ACQUIRE))
+	{
+		pthread_mutex_lock(args_p->lock_p);
+		char popped = '\0';
+		if(count(args_p->list_p) > args_p->length) pop_front(args_p->list_p, &popped);
+		else if(push_front(args_p->list_p, 1)) ++args_p->errors_c;
+		pthread_mutex_unlock(args_p->lock_p);
+	}
+	return NULL;
+}
+
+/* @return traversals per second of all readers along one writer */
+static double run_readers(void* (*reader)(void*), void* (*writer)(void*),
+	struct bench_args* base_p, unsigned int readers_c)
+{
+	pthread_t writer_thread, readers[MAX_READERS];
+	struct bench_args writer_args = *base_p, args[MAX_READERS];
+	__atomic_store_n(&base_p->shared_p->is_done, 0, __ATOMIC_RELEASE);
+	cr_assert_eq(0, pthread_create(&writer_thread, NULL, writer, &writer_args));
+
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned int i = 0; i < readers_c; ++i)
+	{
+		args[i] = *base_p;
+		cr_assert_eq(0, pthread_create(&readers[i], NULL, reader, &args[i]));
+	}
+	for(unsigned int i = 0; i < readers_c; ++i)
+	{
+		cr_assert_eq(0, pthread_join(readers[i], NULL));
+		cr_assert_eq(0, args[i].errors_c);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	__atomic_store_n(&base_p->shared_p->is_done, 1, __ATOMIC_RELEASE);
+	cr_assert_eq(0, pthread_join(writer_thread, NULL));
+	cr_assert_eq(0, writer_args.errors_c);
+
+	double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	return readers_c * base_p->traversals_c / seconds;
+}
+
+Test(persistent_list_suite, time_measurements, .disabled = false)
+{
+	const unsigned int snapshots_c = 1000;
+
+	cr_log_info("Measure cycles for %d snapshots:", snapshots_c);
+	for(unsigned int length = 1000; length <= 1000000; length *= 10)
+	{
+		plist_t version;
+		plist_init(&version);
+		list_t list;
+		init(&list);
+		for(unsigned int i = 0; i < length; ++i)
+		{
+			plist_t next;
+			cr_assert_eq(RESULT_OK, plist_push_front(&version, 1, &next));
+			plist_release(&version);
+			version = next;
+			cr_assert_eq(RESULT_OK, push_front(&list, 1));
+		}
+
+		clock_t start = clock();
+		for(unsigned int i = 0; i < snapshots_c; ++i)
+		{
+			plist_t snapshot;
+			plist_snapshot(&version, &snapshot);
+			plist_release(&snapshot);
+		}
+		clock_t end = clock();
+		cr_log_info("length %7d plist_t CPU ticks used: %9ld", length, (long)(end - start));
+
+		/* Copy of list_t is the snapshot without sharing */
+		start = clock();
+		for(unsigned int i = 0; i < snapshots_c; ++i)
+		{
+			list_t copy;
+			init(&copy);
+			for(struct node* node_p = list.head; node_p; node_p = node_p->next)
+			{
+				cr_assert_eq(RESULT_OK, push_back(&copy, node_p->data));
+			}
+			clear(&copy);
+		}
+		end = clock();
+		cr_log_info("length %7d list_t  CPU ticks used: %9ld", length, (long)(end - start));
+
+		plist_release(&version);
+		clear(&list);
+	}
+
+	const unsigned int length = 10000;
+	struct shared_version shared = {PTHREAD_MUTEX_INITIALIZER, {NULL, 0}, 0};
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	list_t list;
+	init(&list);
+	struct bench_args base = {&shared, &lock, &list, 2000, length, 0};
+
+	cr_log_info("Measure traversals per second of %d elements "
+			    "along one writer:", length);
+	for(unsigned int readers_c = 1; readers_c <= MAX_READERS; readers_c *= 2)
+	{
+		double snapshot_tps = run_readers(snapshot_reader, snapshot_writer, &base, readers_c);
+		double locking_tps = run_readers(locking_reader, locking_writer, &base, readers_c);
+		cr_log_info("readers %d snapshots: %9.0f locked list_t: %9.0f",
+			readers_c, snapshot_tps, locking_tps);
+	}
+	plist_release(&shared.current);
+	clear(&list);
+}
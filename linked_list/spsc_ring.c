@@ -0,0 +1,91 @@
+#include <stdlib.h>
+
+#include "spsc_ring.h"
+
+#define CAPACITY_MAX (1U << 31)
+
+/* Indices run freely and wrap around, slots are indices masked by
+ * capacity - 1, so the number of elements is tail - head in any case
+ */
+int spsc_ring_init(spsc_ring_t* ring_p, unsigned int capacity)
+{
+	if(capacity > CAPACITY_MAX) return RESULT_NOK;
+
+	unsigned int rounded = 1;
+	while(rounded < capacity)
+	{
+		rounded <<= 1;
+	}
+
+	ring_p->data = aligned_alloc(SPSC_RING_ALIGN,
+		rounded < SPSC_RING_ALIGN ? SPSC_RING_ALIGN : rounded);
+	if(!ring_p->data) return RESULT_NOK;
+
+	ring_p->mask = rounded - 1;
+	ring_p->tail = 0;
+	ring_p->head = 0;
+	ring_p->prod_tail = 0;
+	ring_p->prod_head_cache = 0;
+	ring_p->cons_head = 0;
+	ring_p->cons_tail_cache = 0;
+	return RESULT_OK;
+}
+
+void spsc_ring_destroy(spsc_ring_t* ring_p)
+{
+	free(ring_p->data);
+	ring_p->data = NULL;
+}
+
+int spsc_ring_push_back(spsc_ring_t* ring_p, const char new_data)
+{
+	unsigned int tail = ring_p->prod_tail;
+	if(tail - ring_p->prod_head_cache > ring_p->mask)
+	{
+		/* Looks full, the consumer may have freed slots meanwhile */
+		ring_p->prod_head_cache = __atomic_load_n(&ring_p->head, __ATOMIC_ACQUIRE);
+		if(tail - ring_p->prod_head_cache > ring_p->mask)
+		{
+			/* Whatever is pending must be seen, or the consumer never frees any */
+			spsc_ring_flush(ring_p);
+			return RESULT_NOK;
+		}
+	}
+
+	ring_p->data[tail & ring_p->mask] = new_data;
+	ring_p->prod_tail = ++tail;
+	if(tail % SPSC_RING_BATCH == 0)
+	{
+		spsc_ring_flush(ring_p);
+	}
+	return RESULT_OK;
+}
+
+/* Release store makes the elements written before visible with the index */
+void spsc_ring_flush(spsc_ring_t* ring_p)
+{
+	__atomic_store_n(&ring_p->tail, ring_p->prod_tail, __ATOMIC_RELEASE);
+}
+
+int spsc_ring_pop_front(spsc_ring_t* ring_p, char* data_storage)
+{
+	unsigned int head = ring_p->cons_head;
+	if(head == ring_p->cons_tail_cache)
+	{
+		ring_p->cons_tail_cache = __atomic_load_n(&ring_p->tail, __ATOMIC_ACQUIRE);
+		if(head == ring_p->cons_tail_cache)
+		{
+			/* Free what was popped before, the producer may be waiting for it */
+			__atomic_store_n(&ring_p->head, head, __ATOMIC_RELEASE);
+			return RESULT_NOK;
+		}
+	}
+
+	*data_storage = ring_p->data[head & ring_p->mask];
+	ring_p->cons_head = ++head;
+	if(head % SPSC_RING_BATCH == 0)
+	{
+		__atomic_store_n(&ring_p->head, head, __ATOMIC_RELEASE);
+	}
+	return RESULT_OK;
+}
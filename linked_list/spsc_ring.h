@@ -0,0 +1,57 @@
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+#include "linked_list.h"
+
+#define SPSC_RING_ALIGN 64U
+/* Indices are published to the other side once per that many elements */
+#define SPSC_RING_BATCH 32U
+
+/* Bounded FIFO queue for exactly one producer and one consumer thread.
+ * Each side works on its own cache line with a private copy of its
+ * index and a cached copy of the other side's one, shared indices are
+ * read only when the cached ones say the ring is full or empty.
+ */
+struct spsc_ring
+{
+	/* Published by the producer, read by the consumer */
+	_Alignas(SPSC_RING_ALIGN) unsigned int tail;
+	/* Published by the consumer, read by the producer */
+	_Alignas(SPSC_RING_ALIGN) unsigned int head;
+	/* Producer only */
+	_Alignas(SPSC_RING_ALIGN) unsigned int prod_tail;
+	unsigned int prod_head_cache;
+	/* Consumer only */
+	_Alignas(SPSC_RING_ALIGN) unsigned int cons_head;
+	unsigned int cons_tail_cache;
+	/* Set once by init */
+	_Alignas(SPSC_RING_ALIGN) char* data;
+	unsigned int mask;
+};
+
+typedef struct spsc_ring spsc_ring_t;
+
+/* Capacity is rounded up to a power of two
+ * @return RESULT_NOK when out of memory or capacity is over 2^31
+ */
+int spsc_ring_init(spsc_ring_t* ring_p, unsigned int capacity);
+void spsc_ring_destroy(spsc_ring_t* ring_p);
+
+/* Producer side. Elements are visible to the consumer once a batch is
+ * full, the ring is full, or after spsc_ring_flush()
+ * @return RESULT_NOK when the ring is full
+ */
+int spsc_ring_push_back(spsc_ring_t* ring_p, const char new_data);
+void spsc_ring_flush(spsc_ring_t* ring_p);
+
+/* Consumer side
+ * @return RESULT_NOK when the ring is empty
+ */
+int spsc_ring_pop_front(spsc_ring_t* ring_p, char* data_storage);
+
+static inline unsigned int spsc_ring_capacity(const spsc_ring_t* ring_p)
+{
+	return ring_p->mask + 1;
+}
+
+#endif /* SPSC_RING_H_ */
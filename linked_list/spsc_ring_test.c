@@ -0,0 +1,237 @@
+#include <criterion.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#include "spsc_ring.h"
+
+#define BENCH_CAPACITY 4096U
+
+Test(spsc_ring_suite, basic_scenario)
+{
+	spsc_ring_t ring;
+	cr_assert_eq(RESULT_OK, spsc_ring_init(&ring, 100));
+	cr_assert_eq(128, spsc_ring_capacity(&ring));
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_NOK, spsc_ring_pop_front(&ring, &popped));
+
+	/* Several rounds, so indices wrap around the ring */
+	for(unsigned int round = 0; round < 5; ++round)
+	{
+		for(unsigned int i = 0; i < 128; ++i)
+		{
+			cr_assert_eq(RESULT_OK, spsc_ring_push_back(&ring, (char)(round + i)));
+		}
+		cr_assert_eq(RESULT_NOK, spsc_ring_push_back(&ring, 'x'));
+
+		for(unsigned int i = 0; i < 128; ++i)
+		{
+			cr_assert_eq(RESULT_OK, spsc_ring_pop_front(&ring, &popped));
+			cr_assert_eq((char)(round + i), popped);
+		}
+		cr_assert_eq(RESULT_NOK, spsc_ring_pop_front(&ring, &popped));
+	}
+	spsc_ring_destroy(&ring);
+}
+
+/* Elements of an unfinished batch are seen only after a flush */
+Test(spsc_ring_suite, flush_publishes)
+{
+	spsc_ring_t ring;
+	cr_assert_eq(RESULT_OK, spsc_ring_init(&ring, 1024));
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_OK, spsc_ring_push_back(&ring, 'a'));
+	cr_assert_eq(RESULT_NOK, spsc_ring_pop_front(&ring, &popped));
+	spsc_ring_flush(&ring);
+	cr_assert_eq(RESULT_OK, spsc_ring_pop_front(&ring, &popped));
+	cr_assert_eq('a', popped);
+
+	for(unsigned int i = 0; i < SPSC_RING_BATCH; ++i)
+	{
+		cr_assert_eq(RESULT_OK, spsc_ring_push_back(&ring, 'b'));
+	}
+	/* 'a' and 31 more complete the batch, the last 'b' waits */
+	for(unsigned int i = 1; i < SPSC_RING_BATCH; ++i)
+	{
+		cr_assert_eq(RESULT_OK, spsc_ring_pop_front(&ring, &popped));
+	}
+	cr_assert_eq(RESULT_NOK, spsc_ring_pop_front(&ring, &popped));
+	spsc_ring_destroy(&ring);
+}
+
+struct ring_args
+{
+	spsc_ring_t* ring_p;
+	spsc_ring_t* back_p;
+	unsigned int ops;
+};
+
+static void* producer(void* arg)
+{
+	struct ring_args* args_p = arg;
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		while(spsc_ring_push_back(args_p->ring_p, (char)i))
+		{
+			sched_yield();
+		}
+	}
+	spsc_ring_flush(args_p->ring_p);
+	return NULL;
+}
+
+/* Consumer side is the calling thread
+ * @return number of elements out of order
+ */
+static unsigned int consume(spsc_ring_t* ring_p, unsigned int ops)
+{
+	unsigned int errors_c = 0;
+	for(unsigned int i = 0; i < ops; ++i)
+	{
+		char popped = '\0';
+		while(spsc_ring_pop_front(ring_p, &popped))
+		{
+			sched_yield();
+		}
+		if(popped != (char)i) ++errors_c;
+	}
+	return errors_c;
+}
+
+Test(spsc_ring_suite, threads_stress)
+{
+	const unsigned int ops = 10000000;
+	spsc_ring_t ring;
+	/* Small ring, so the producer keeps hitting a full one */
+	cr_assert_eq(RESULT_OK, spsc_ring_init(&ring, 64));
+
+	pthread_t thread;
+	struct ring_args args = {&ring, NULL, ops};
+	cr_assert_eq(0, pthread_create(&thread, NULL, producer, &args));
+	cr_assert_eq(0, consume(&ring, ops));
+	cr_assert_eq(0, pthread_join(thread, NULL));
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_NOK, spsc_ring_pop_front(&ring, &popped));
+	spsc_ring_destroy(&ring);
+}
+
+struct list_args
+{
+	list_t* list_p;
+	pthread_mutex_t* lock_p;
+	unsigned int ops;
+};
+
+/* Current way of passing data between two threads */
+static void* list_producer(void* arg)
+{
+	struct list_args* args_p = arg;
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		pthread_mutex_lock(args_p->lock_p);
+		push_back(args_p->list_p, (char)i);
+		pthread_mutex_unlock(args_p->lock_p);
+	}
+	return NULL;
+}
+
+/* Echoes every element back, so the other side measures round trips */
+static void* echo(void* arg)
+{
+	struct ring_args* args_p = arg;
+	for(unsigned int i = 0; i < args_p->ops; ++i)
+	{
+		char popped = '\0';
+		while(spsc_ring_pop_front(args_p->ring_p, &popped))
+		{
+			sched_yield();
+		}
+		while(spsc_ring_push_back(args_p->back_p, popped))
+		{
+			sched_yield();
+		}
+		spsc_ring_flush(args_p->back_p);
+	}
+	return NULL;
+}
+
+static double elapsed_s(const struct timespec* start_p)
+{
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start_p->tv_sec) + (end.tv_nsec - start_p->tv_nsec) / 1e9;
+}
+
+Test(spsc_ring_suite, time_measurements, .disabled = false)
+{
+	const unsigned int ops = 20000000;
+	/* Linked list is far slower, don't wait for the same amount */
+	const unsigned int list_ops = 2000000;
+	const unsigned int round_trips = 100000;
+	struct timespec start;
+	pthread_t thread;
+
+	spsc_ring_t ring;
+	cr_assert_eq(RESULT_OK, spsc_ring_init(&ring, BENCH_CAPACITY));
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	struct ring_args args = {&ring, NULL, ops};
+	cr_assert_eq(0, pthread_create(&thread, NULL, producer, &args));
+	cr_assert_eq(0, consume(&ring, ops));
+	cr_assert_eq(0, pthread_join(thread, NULL));
+	double ring_mops = ops / elapsed_s(&start) / 1e6;
+
+	list_t list;
+	init(&list);
+	pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	struct list_args list_args = {&list, &lock, list_ops};
+	cr_assert_eq(0, pthread_create(&thread, NULL, list_producer, &list_args));
+	unsigned int errors_c = 0;
+	for(unsigned int i = 0; i < list_ops; ++i)
+	{
+		char popped = '\0';
+		int result;
+		do
+		{
+			pthread_mutex_lock(&lock);
+			result = pop_front(&list, &popped);
+			pthread_mutex_unlock(&lock);
+			if(result) sched_yield();
+		} while(result);
+		if(popped != (char)i) ++errors_c;
+	}
+	cr_assert_eq(0, pthread_join(thread, NULL));
+	cr_assert_eq(0, errors_c);
+	double list_mops = list_ops / elapsed_s(&start) / 1e6;
+
+	cr_log_info("Measure millions of elements per second from one thread to another:");
+	cr_log_info("spsc ring: %7.2f", ring_mops);
+	cr_log_info("mutex list: %7.2f", list_mops);
+
+	/* Latency of one element is half of a round trip through two rings */
+	spsc_ring_t back;
+	cr_assert_eq(RESULT_OK, spsc_ring_init(&back, BENCH_CAPACITY));
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	struct ring_args echo_args = {&ring, &back, round_trips};
+	cr_assert_eq(0, pthread_create(&thread, NULL, echo, &echo_args));
+	for(unsigned int i = 0; i < round_trips; ++i)
+	{
+		cr_assert_eq(RESULT_OK, spsc_ring_push_back(&ring, (char)i));
+		spsc_ring_flush(&ring);
+		char popped = '\0';
+		while(spsc_ring_pop_front(&back, &popped))
+		{
+			sched_yield();
+		}
+		cr_assert_eq((char)i, popped);
+	}
+	cr_assert_eq(0, pthread_join(thread, NULL));
+	cr_log_info("one way latency: %.0f ns", elapsed_s(&start) / round_trips / 2 * 1e9);
+
+	spsc_ring_destroy(&back);
+	spsc_ring_destroy(&ring);
+}
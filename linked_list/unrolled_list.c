@@ -0,0 +1,154 @@
+#include <stdlib.h>
+#include <assert.h>
+
+#include "unrolled_list.h"
+#include "node_pool.h"
+
+_Static_assert(sizeof(struct unode) == CACHE_LINE_SIZE, "unode must fill a cache line");
+
+static struct node_pool unodes = NODE_POOL_INIT(struct unode);
+
+static struct unode* new_unode(unsigned char begin);
+
+void ulist_init(ulist_t* list_p)
+{
+	list_p->head = NULL;
+	list_p->tail = NULL;
+	list_p->size = 0;
+}
+
+int ulist_push_front(ulist_t* list_p, const char new_data)
+{
+	struct unode* head_p = list_p->head;
+	if(!head_p || !head_p->begin)
+	{
+		/* New head is filled from its end towards the begin */
+		head_p = new_unode(UNODE_CAPACITY);
+		if(!head_p) return RESULT_NOK;
+
+		head_p->next = list_p->head;
+		if(!list_p->head)
+		{
+			list_p->tail = head_p;
+		}
+		list_p->head = head_p;
+	}
+
+	head_p->data[--head_p->begin] = new_data;
+	++list_p->size;
+
+	return RESULT_OK;
+}
+
+int ulist_push_back(ulist_t* list_p, const char new_data)
+{
+	struct unode* tail_p = list_p->tail;
+	if(!tail_p || tail_p->end == UNODE_CAPACITY)
+	{
+		tail_p = new_unode(0);
+		if(!tail_p) return RESULT_NOK;
+
+		if(list_p->tail)
+		{
+			list_p->tail->next = tail_p;
+		}
+		else
+		{
+			list_p->head = tail_p;
+		}
+		list_p->tail = tail_p;
+	}
+
+	tail_p->data[tail_p->end++] = new_data;
+	++list_p->size;
+
+	return RESULT_OK;
+}
+
+int ulist_pop_front(ulist_t* list_p, char* data_storage)
+{
+	struct unode* head_p = list_p->head;
+	if(!head_p) return RESULT_NOK;
+
+	*data_storage = head_p->data[head_p->begin++];
+	if(head_p->begin == head_p->end)
+	{
+		list_p->head = head_p->next;
+		if(!list_p->head)
+		{
+			list_p->tail = NULL;
+		}
+		node_pool_free(&unodes, head_p);
+	}
+	--list_p->size;
+
+	return RESULT_OK;
+}
+
+int ulist_pop_back(ulist_t* list_p, char* data_storage)
+{
+	struct unode* tail_p = list_p->tail;
+	if(!tail_p) return RESULT_NOK;
+
+	*data_storage = tail_p->data[--tail_p->end];
+	if(tail_p->begin == tail_p->end)
+	{
+		/* Singly linked, but only once per node the predecessor is searched */
+		if(list_p->head == tail_p)
+		{
+			list_p->head = NULL;
+			list_p->tail = NULL;
+		}
+		else
+		{
+			struct unode* prev_p = list_p->head;
+			while(prev_p->next != tail_p)
+			{
+				prev_p = prev_p->next;
+			}
+			prev_p->next = NULL;
+			list_p->tail = prev_p;
+		}
+		node_pool_free(&unodes, tail_p);
+	}
+	--list_p->size;
+
+	return RESULT_OK;
+}
+
+unsigned int ulist_count(ulist_t* list_p)
+{
+#ifdef CHECK_COUNT
+	/* Cross-check the cached size against a full walk */
+	unsigned int elements_c = 0;
+	for(struct unode* next_p = list_p->head; next_p; next_p = next_p->next)
+	{
+		elements_c += next_p->end - next_p->begin;
+	}
+	assert(elements_c == list_p->size);
+#endif
+	return list_p->size;
+}
+
+void ulist_clear(ulist_t* list_p)
+{
+	node_pool_free_chain(&unodes, list_p->head);
+	list_p->head = NULL;
+	list_p->tail = NULL;
+	list_p->size = 0;
+}
+
+/* @return empty node with begin and end set to the same index */
+static struct unode* new_unode(unsigned char begin)
+{
+	struct unode* new_p;
+	new_p = node_pool_alloc(&unodes);
+	if(!new_p) return NULL;
+	else
+	{
+		new_p->next = NULL;
+		new_p->begin = begin;
+		new_p->end = begin;
+		return new_p;
+	}
+}
@@ -0,0 +1,40 @@
+#ifndef UNROLLED_LIST_H_
+#define UNROLLED_LIST_H_
+
+#include "linked_list.h"
+
+#define CACHE_LINE_SIZE 64U
+/* Whatever is left of a cache line after the link and the fill range */
+#define UNODE_CAPACITY  (CACHE_LINE_SIZE - sizeof(struct unode*) - 2 * sizeof(unsigned char))
+
+#define ulist_is_empty(list) ((list).head == NULL)
+
+/* Elements of a node are data[begin] .. data[end - 1], so pushes to both
+ * ends fill the node without moving what is already stored
+ */
+struct unode
+{
+	struct unode* next;
+	unsigned char begin;
+	unsigned char end;
+	char data[UNODE_CAPACITY];
+};
+
+struct ulist
+{
+	struct unode* head;
+	struct unode* tail;
+	unsigned int size;
+};
+
+typedef struct ulist ulist_t;
+
+void ulist_init(ulist_t* list_p);
+int ulist_push_front(ulist_t* list_p, const char new_data);
+int ulist_push_back(ulist_t* list_p, const char new_data);
+int ulist_pop_front(ulist_t* list_p, char* data_storage);
+int ulist_pop_back(ulist_t* list_p, char* data_storage);
+void ulist_clear(ulist_t* list_p);
+unsigned int ulist_count(ulist_t* list_p);
+
+#endif /* UNROLLED_LIST_H_ */
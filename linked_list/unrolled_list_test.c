@@ -0,0 +1,210 @@
+#include <criterion.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "unrolled_list.h"
+
+Test(unrolled_list_suite, basic_scenario)
+{
+	ulist_t list;
+	ulist_init(&list);
+	cr_assert(ulist_is_empty(list));
+
+	char char_to_push = 'a', char_popped = '\0';
+	cr_assert_eq(RESULT_OK, ulist_push_back(&list, char_to_push));
+	cr_assert_eq(list.head, list.tail);
+	cr_assert_eq(1, ulist_count(&list));
+
+	cr_assert_eq(RESULT_OK, ulist_pop_back(&list, &char_popped));
+	cr_expect(ulist_is_empty(list));
+	cr_expect_eq(NULL, list.tail);
+	cr_assert_eq(char_to_push, char_popped);
+
+	char_to_push = 'b';
+	cr_assert_eq(RESULT_OK, ulist_push_front(&list, char_to_push));
+	cr_assert_eq(RESULT_OK, ulist_pop_front(&list, &char_popped));
+	cr_expect(ulist_is_empty(list));
+	cr_assert_eq(char_to_push, char_popped);
+
+	cr_assert_eq(RESULT_NOK, ulist_pop_front(&list, &char_popped));
+	cr_assert_eq(RESULT_NOK, ulist_pop_back(&list, &char_popped));
+}
+
+Test(unrolled_list_suite, nodes_fill_cache_lines)
+{
+	cr_assert_eq(CACHE_LINE_SIZE, sizeof(struct unode));
+
+	ulist_t list;
+	ulist_init(&list);
+	for(unsigned int i = 0; i < 10 * UNODE_CAPACITY; ++i)
+	{
+		cr_assert_eq(RESULT_OK, ulist_push_back(&list, (char)i));
+	}
+
+	unsigned int nodes_c = 0;
+	for(struct unode* node_p = list.head; node_p; node_p = node_p->next)
+	{
+		cr_assert_eq(0, (uintptr_t)node_p % CACHE_LINE_SIZE);
+		cr_assert_eq(UNODE_CAPACITY, node_p->end - node_p->begin);
+		++nodes_c;
+	}
+	cr_assert_eq(10, nodes_c);
+	ulist_clear(&list);
+	cr_assert(ulist_is_empty(list));
+}
+
+Test(unrolled_list_suite, order_across_nodes)
+{
+	const unsigned int count = 5 * UNODE_CAPACITY + 7;
+	ulist_t list;
+	ulist_init(&list);
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, ulist_push_back(&list, (char)i));
+	}
+	cr_assert_eq(count, ulist_count(&list));
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		char popped = 0;
+		cr_assert_eq(RESULT_OK, ulist_pop_front(&list, &popped));
+		cr_assert_eq((char)i, popped);
+	}
+	cr_assert(ulist_is_empty(list));
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, ulist_push_front(&list, (char)i));
+	}
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		char popped = 0;
+		cr_assert_eq(RESULT_OK, ulist_pop_back(&list, &popped));
+		cr_assert_eq((char)i, popped);
+	}
+	cr_assert(ulist_is_empty(list));
+	cr_assert_eq(NULL, list.tail);
+}
+
+/* Random operations at both ends against an array used as a deque */
+Test(unrolled_list_suite, matches_reference_deque)
+{
+	enum {capacity = 4096};
+	char expected[2 * capacity];
+	unsigned int first = capacity, last = capacity;
+
+	ulist_t list;
+	ulist_init(&list);
+	srand(33);
+	for(unsigned int op = 0; op < 100000; ++op)
+	{
+		char data = (char)rand();
+		char popped = 0;
+		switch(rand() % 4)
+		{
+			case 0:
+				if(first == 0) break;
+				cr_assert_eq(RESULT_OK, ulist_push_front(&list, data));
+				expected[--first] = data;
+				break;
+			case 1:
+				if(last == 2 * capacity) break;
+				cr_assert_eq(RESULT_OK, ulist_push_back(&list, data));
+				expected[last++] = data;
+				break;
+			case 2:
+				if(first == last)
+				{
+					cr_assert_eq(RESULT_NOK, ulist_pop_front(&list, &popped));
+					break;
+				}
+				cr_assert_eq(RESULT_OK, ulist_pop_front(&list, &popped));
+				cr_assert_eq(expected[first++], popped);
+				break;
+			default:
+				if(first == last)
+				{
+					cr_assert_eq(RESULT_NOK, ulist_pop_back(&list, &popped));
+					break;
+				}
+				cr_assert_eq(RESULT_OK, ulist_pop_back(&list, &popped));
+				cr_assert_eq(expected[--last], popped);
+				break;
+		}
+	}
+	cr_assert_eq(last - first, ulist_count(&list));
+	ulist_clear(&list);
+}
+
+/* Walks nodes one by one, count() of both lists doesn't since it is cached
+ * @return sum of all elements
+ */
+static unsigned int walk_list(list_t* list_p)
+{
+	unsigned int sum = 0;
+	for(struct node* node_p = list_p->head; node_p; node_p = node_p->next)
+	{
+		sum += node_p->data;
+	}
+	return sum;
+}
+
+static unsigned int walk_ulist(ulist_t* list_p)
+{
+	unsigned int sum = 0;
+	for(struct unode* node_p = list_p->head; node_p; node_p = node_p->next)
+	{
+		for(unsigned int i = node_p->begin; i < node_p->end; ++i)
+		{
+			sum += node_p->data[i];
+		}
+	}
+	return sum;
+}
+
+Test(unrolled_list_suite, time_measurements, .disabled = false)
+{
+	const unsigned int elements_c = 10000000;
+	const unsigned int passes = 10;
+
+	list_t list;
+	init(&list);
+	ulist_t ulist;
+	ulist_init(&ulist);
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_front(&list, 1));
+		cr_assert_eq(RESULT_OK, ulist_push_back(&ulist, 1));
+	}
+
+	unsigned int nodes_c = 0;
+	for(struct unode* node_p = ulist.head; node_p; node_p = node_p->next)
+	{
+		++nodes_c;
+	}
+	cr_log_info("Memory per element of %d elements:", elements_c);
+	cr_log_info("list_t  bytes: %6.2f", (double)sizeof(struct node));
+	cr_log_info("ulist_t bytes: %6.2f", (double)nodes_c * sizeof(struct unode) / elements_c);
+
+	cr_log_info("Measure cycles for %d passes of traversal "
+			    "over %d elements:", passes, elements_c);
+	clock_t start = clock();
+	for(unsigned int i = 0; i < passes; ++i)
+	{
+		cr_assert_eq(elements_c, walk_list(&list));
+	}
+	clock_t end = clock();
+	cr_log_info("list_t  CPU ticks used: %9ld", (long)(end - start));
+
+	start = clock();
+	for(unsigned int i = 0; i < passes; ++i)
+	{
+		cr_assert_eq(elements_c, walk_ulist(&ulist));
+	}
+	end = clock();
+	cr_log_info("ulist_t CPU ticks used: %9ld", (long)(end - start));
+
+	clear(&list);
+	ulist_clear(&ulist);
+}
@@ -0,0 +1,57 @@
+#include "dlinked_list.h"
+#include "node_pool.h"
+
+using Core = ListCore<DList>;
+using Nodes = PoolNodes<struct dnode, NodePool<struct dnode>>;
+
+DList::DList(char data)
+{
+	Core::init(*this);
+	Core::push_front(*this, Nodes{}, data);
+}
+
+DList::~DList()
+{
+	clear();
+}
+
+int DList::push_front(char new_data)
+{
+	return Core::push_front(*this, Nodes{}, new_data);
+}
+
+int DList::push_back(char new_data)
+{
+	return Core::push_back(*this, Nodes{}, new_data);
+}
+
+int DList::pop_front(char& data_storage)
+{
+	return Core::pop_front(*this, Nodes{}, data_storage);
+}
+
+int DList::pop_back(char& data_storage)
+{
+	return Core::pop_back(*this, Nodes{}, data_storage);
+}
+
+unsigned int DList::count()
+{
+	return Core::count(*this);
+}
+
+void DList::clear()
+{
+	Core::clear(*this, Nodes{});
+}
+
+DList::iterator DList::insert(const_iterator pos, char new_data)
+{
+	auto new_p = Core::insert(*this, Nodes{}, pos.node_p, new_data);
+	return new_p ? iterator{new_p, this} : end();
+}
+
+DList::iterator DList::erase(const_iterator pos)
+{
+	return iterator{Core::erase(*this, Nodes{}, pos.node_p), this};
+}
@@ -0,0 +1,121 @@
+#ifndef DLINKED_LIST_H_
+#define DLINKED_LIST_H_
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include "linked_list.h"
+
+struct dnode
+{
+	struct dnode* next;
+	struct dnode* prev;
+	char data;
+};
+
+/* Keeps handles to both ends, so every push and pop is O(1),
+ * its operations are ListCore's
+ */
+class DList {
+private:
+	friend class ListCore<DList>;
+
+	struct dnode* head;
+	struct dnode* tail;
+	unsigned int size;
+
+	/* Bidirectional iterator, end can be decremented
+	 * as it knows the list it belongs to
+	 */
+	template <bool is_const>
+	class basic_iterator {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = char;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<is_const, const char*, char*>;
+		using reference = std::conditional_t<is_const, const char&, char&>;
+
+		basic_iterator() = default;
+
+		/* Mutable iterator is usable wherever a const one is expected */
+		operator basic_iterator<true>() const
+		{
+			return basic_iterator<true>{node_p, list_p};
+		}
+
+		reference operator*() const { return node_p->data; }
+		pointer operator->() const { return &node_p->data; }
+
+		basic_iterator& operator++()
+		{
+			node_p = node_p->next;
+			return *this;
+		}
+
+		basic_iterator operator++(int)
+		{
+			auto old = *this;
+			++*this;
+			return old;
+		}
+
+		basic_iterator& operator--()
+		{
+			node_p = node_p ? node_p->prev : list_p->tail;
+			return *this;
+		}
+
+		basic_iterator operator--(int)
+		{
+			auto old = *this;
+			--*this;
+			return old;
+		}
+
+		friend bool operator==(const basic_iterator& a, const basic_iterator& b)
+		{
+			return a.node_p == b.node_p;
+		}
+
+	private:
+		friend class DList;
+		friend class basic_iterator<!is_const>;
+
+		basic_iterator(struct dnode* node_p, const DList* list_p) :
+			node_p{node_p}, list_p{list_p} {}
+
+		struct dnode* node_p = nullptr;
+		const DList* list_p = nullptr;
+	};
+
+public:
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	DList(char data);
+	~DList();
+	DList(const DList&) = delete;
+	DList& operator=(const DList&) = delete;
+	int push_front(char new_data);
+	int push_back(char new_data);
+	int pop_front(char& data_storage);
+	int pop_back(char& data_storage);
+	void clear();
+	unsigned int count();
+
+	iterator begin() { return iterator{head, this}; }
+	iterator end() { return iterator{nullptr, this}; }
+	const_iterator begin() const { return const_iterator{head, this}; }
+	const_iterator end() const { return const_iterator{nullptr, this}; }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+	/* Both are O(1), insert() adds the new element before pos
+	 * @return iterator to the new element, or end when out of memory
+	 */
+	iterator insert(const_iterator pos, char new_data);
+	/* @return iterator to the element after the erased one */
+	iterator erase(const_iterator pos);
+};
+
+#endif /* DLINKED_LIST_H_ */
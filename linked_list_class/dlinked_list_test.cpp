@@ -0,0 +1,176 @@
+#include <time.h>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <criterion.h>
+#include "dlinked_list.h"
+
+Test(doubly_linked_list_suite, basic_scenario)
+{
+	const char initial_char = 'x';
+	DList list {initial_char};
+	cr_assert_eq(1, list.count());
+
+	char char_to_push = 'a';
+	char char_popped = '\0';
+	cr_assert_eq(RESULT_OK, list.push_back(char_to_push));
+	cr_assert_eq(RESULT_OK, list.pop_back(char_popped));
+	cr_assert_eq(char_to_push, char_popped);
+
+	char_to_push = 'b';
+	char_popped = '\0';
+	cr_assert_eq(RESULT_OK, list.push_front(char_to_push));
+	cr_assert_eq(RESULT_OK, list.pop_front(char_popped));
+	cr_assert_eq(char_to_push, char_popped);
+
+	cr_assert_eq(RESULT_OK, list.pop_back(char_popped));
+	cr_assert_eq(initial_char, char_popped);
+	cr_expect_eq(0, list.count());
+}
+
+Test(doubly_linked_list_suite, pop_more_than_pushed)
+{
+	const char to_push = 'f';
+	DList list {to_push};
+	char to_pop_into = '\0';
+	cr_assert_eq(RESULT_OK, list.pop_front(to_pop_into));
+	cr_assert_eq(to_push, to_pop_into);
+
+	for(int i = 0; i < 3; ++i)
+	{
+		// trying to pop more than pushed should return error
+		cr_expect_eq(RESULT_NOK, list.pop_back(to_pop_into));
+		cr_expect_eq(RESULT_NOK, list.pop_front(to_pop_into));
+	}
+
+	// buffer should not be altered after wrong pops
+	cr_assert_eq(to_push, to_pop_into);
+}
+
+Test(doubly_linked_list_suite, both_ends_order)
+{
+	DList letters {'a'};
+
+	// d c b a x y z
+	for (char c = 'b'; c <= 'd'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, letters.push_front(c));
+	}
+	for (char c = 'x'; c <= 'z'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, letters.push_back(c));
+	}
+	cr_assert_eq(7, letters.count());
+
+	const char expected_front[] = "dcba";
+	const char expected_back[] = "zyx";
+	char storage = 0;
+	for(int i = 0; i < 3; ++i)
+	{
+		cr_assert_eq(RESULT_OK, letters.pop_back(storage));
+		cr_assert_eq(expected_back[i], storage);
+	}
+	for(int i = 0; i < 4; ++i)
+	{
+		cr_assert_eq(RESULT_OK, letters.pop_front(storage));
+		cr_assert_eq(expected_front[i], storage);
+	}
+	cr_assert_eq(0, letters.count());
+
+	cr_assert_eq(RESULT_OK, letters.push_back('q'));
+	letters.clear();
+	cr_assert_eq(0, letters.count());
+	cr_assert_eq(RESULT_NOK, letters.pop_back(storage));
+}
+
+Test(doubly_linked_list_suite, iterate_both_ways)
+{
+	static_assert(std::bidirectional_iterator<DList::iterator>);
+	static_assert(std::bidirectional_iterator<DList::const_iterator>);
+	static_assert(std::ranges::bidirectional_range<DList>);
+
+	DList list {'a'};
+	for(char c = 'b'; c <= 'e'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, list.push_back(c));
+	}
+
+	cr_assert_eq('e', *std::prev(list.end()));
+	cr_assert(std::ranges::equal(list | std::views::reverse, std::string_view("edcba")));
+
+	std::ranges::reverse(list);
+	const DList& const_list = list;
+	cr_assert(std::equal(const_list.cbegin(), const_list.cend(), "edcba"));
+
+	char popped = '\0';
+	cr_assert_eq(RESULT_OK, list.pop_front(popped));
+	cr_assert_eq('e', popped);
+	cr_assert_eq(4, list.count());
+}
+
+Test(doubly_linked_list_suite, insert_and_erase)
+{
+	DList list {'c'};
+
+	auto head = list.insert(list.begin(), 'a');
+	list.insert(std::next(head), 'b');
+	auto tail = list.insert(list.end(), 'd');
+	cr_assert_eq('d', *tail);
+	cr_assert(std::equal(list.begin(), list.end(), "abcd"));
+
+	cr_assert(list.erase(tail) == list.end());
+	char popped = '\0';
+	cr_assert_eq(RESULT_OK, list.pop_back(popped));
+	cr_assert_eq('c', popped);
+
+	auto after = list.erase(list.begin());
+	cr_assert_eq('b', *after);
+	cr_assert_eq(list.begin(), after);
+	list.erase(after);
+	cr_assert_eq(0, list.count());
+	cr_assert_eq(RESULT_NOK, list.pop_front(popped));
+	cr_assert_eq(RESULT_OK, list.push_back('z'));
+	cr_assert_eq('z', *list.begin());
+}
+
+Test(doubly_linked_list_suite, time_measurements, .disabled = false)
+{
+	const unsigned int count = 10000000;
+
+	cr_log_info("Measure cycles for the push_back "
+			    "and pop_back of %d elements:", count);
+	clock_t start = clock();
+	DList list {'\0'};
+	for(unsigned int i = 1; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, list.push_back('\0'));
+	}
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		char dummy = 0;
+		cr_assert_eq(RESULT_OK, list.pop_back(dummy));
+	}
+	clock_t end = clock();
+	unsigned int ticks = end - start;
+	cr_log_info("CPU ticks used: %9d", ticks);
+
+	cr_assert_eq(0, list.count());
+
+	cr_log_info("Measure cycles for the push_front "
+			    "and pop_front of %d elements:", count);
+	start = clock();
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, list.push_front('\0'));
+	}
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		char dummy = 0;
+		cr_assert_eq(RESULT_OK, list.pop_front(dummy));
+	}
+	cr_assert_eq(0, list.count());
+	end = clock();
+	ticks = end - start;
+	cr_log_info("CPU ticks used: %9d", ticks);
+}
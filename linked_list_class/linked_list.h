@@ -1,28 +1,351 @@
 #ifndef LINKED_LIST_H_
 #define LINKED_LIST_H_
 
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "list_core.h"
+#include "node_pool.h"
+
 #define RESULT_OK   0
 #define RESULT_NOK -1
 
-struct node
+template <typename T>
+struct ListNode
 {
-	struct node* next;
-	char data;
+	ListNode* next;
+	T data;
 };
 
-typedef struct node* list_t;
-
+/* Singly linked list owning its elements, its operations are ListCore's.
+ * Nodes come from Allocator rebound to ListNode<T>, e.g.
+ * std::pmr::polymorphic_allocator<T> over a monotonic arena; the default
+ * one takes them from NodePool.
+ */
+template <typename T, typename Allocator = PoolAllocator<T>>
 class List {
 private:
-	list_t list;
+	using Node = ListNode<T>;
+	using NodeAllocator =
+		typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAllocator>;
+	using Core = ListCore<List>;
+	friend Core;
+
+	Node* head = nullptr;
+	Node* tail = nullptr;
+	unsigned int size = 0;
+	NodeAllocator node_allocator;
+
+	/* Forward iterator, besides elements it can point before the first one,
+	 * which is where insert_after() adds a new head
+	 */
+	template <bool is_const>
+	class basic_iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<is_const, const T*, T*>;
+		using reference = std::conditional_t<is_const, const T&, T&>;
+
+		basic_iterator() = default;
+
+		/* Mutable iterator is usable wherever a const one is expected */
+		operator basic_iterator<true>() const
+		{
+			return basic_iterator<true>{node_p, before_p};
+		}
+
+		reference operator*() const { return node_p->data; }
+		pointer operator->() const { return std::addressof(node_p->data); }
+
+		basic_iterator& operator++()
+		{
+			node_p = before_p ? before_p->head : node_p->next;
+			before_p = nullptr;
+			return *this;
+		}
+
+		basic_iterator operator++(int)
+		{
+			auto old = *this;
+			++*this;
+			return old;
+		}
+
+		friend bool operator==(const basic_iterator& a, const basic_iterator& b)
+		{
+			return a.node_p == b.node_p && a.before_p == b.before_p;
+		}
+
+	private:
+		friend class List;
+		friend class basic_iterator<!is_const>;
+
+		basic_iterator(Node* node_p, const List* before_p) :
+			node_p{node_p}, before_p{before_p} {}
+
+		Node* node_p = nullptr;
+		/* Set only for the position before the first element */
+		const List* before_p = nullptr;
+	};
+
 public:
-	List(char data);
-	int push_front(char new_data);
-	int push_back(char new_data);
-	int pop_front(char& data_storage);
-	int pop_back(char& data_storage);
-	void clear();
-	unsigned int count();
+	using value_type = T;
+	using allocator_type = Allocator;
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	List() : List(Allocator()) {}
+	explicit List(const Allocator& allocator) noexcept : node_allocator{allocator} {}
+
+	List(const T& data, const Allocator& allocator = Allocator()) :
+		node_allocator{allocator}
+	{
+		if(emplace_back(data)) throw std::bad_alloc();
+	}
+
+	List(const List& other) :
+		node_allocator{NodeTraits::select_on_container_copy_construction(other.node_allocator)}
+	{
+		copy_from(other);
+	}
+
+	List(List&& other) noexcept :
+		head{other.head}, tail{other.tail}, size{other.size},
+		node_allocator{std::move(other.node_allocator)}
+	{
+		Core::init(other);
+	}
+
+	~List()
+	{
+		clear();
+	}
+
+	List& operator=(const List& other)
+	{
+		if(this == &other) return *this;
+
+		clear();
+		if constexpr(NodeTraits::propagate_on_container_copy_assignment::value)
+		{
+			node_allocator = other.node_allocator;
+		}
+		copy_from(other);
+		return *this;
+	}
+
+	/* Nodes can be taken over only if they can be freed by our allocator,
+	 * otherwise elements are moved one by one
+	 */
+	List& operator=(List&& other) noexcept(
+		NodeTraits::propagate_on_container_move_assignment::value ||
+		NodeTraits::is_always_equal::value)
+	{
+		if(this == &other) return *this;
+
+		clear();
+		if constexpr(NodeTraits::propagate_on_container_move_assignment::value)
+		{
+			node_allocator = std::move(other.node_allocator);
+		}
+		else if constexpr(!NodeTraits::is_always_equal::value)
+		{
+			if(node_allocator != other.node_allocator)
+			{
+				for(auto node_p = other.head; node_p; node_p = node_p->next)
+				{
+					if(emplace_back(std::move(node_p->data))) throw std::bad_alloc();
+				}
+				other.clear();
+				return *this;
+			}
+		}
+		head = other.head;
+		tail = other.tail;
+		size = other.size;
+		Core::init(other);
+		return *this;
+	}
+
+	int push_front(const T& new_data)
+	{
+		return emplace_front(new_data);
+	}
+
+	int push_front(T&& new_data)
+	{
+		return emplace_front(std::move(new_data));
+	}
+
+	int push_back(const T& new_data)
+	{
+		return emplace_back(new_data);
+	}
+
+	int push_back(T&& new_data)
+	{
+		return emplace_back(std::move(new_data));
+	}
+
+	/* Element is constructed in place from args */
+	template <typename... Args>
+	int emplace_front(Args&&... args)
+	{
+		return Core::push_front(*this, nodes(), std::forward<Args>(args)...);
+	}
+
+	template <typename... Args>
+	int emplace_back(Args&&... args)
+	{
+		return Core::push_back(*this, nodes(), std::forward<Args>(args)...);
+	}
+
+	int pop_front(T& data_storage)
+	{
+		return Core::pop_front(*this, nodes(), data_storage);
+	}
+
+	/* Singly linked, so the new tail is searched from the head */
+	int pop_back(T& data_storage)
+	{
+		return Core::pop_back(*this, nodes(), data_storage);
+	}
+
+	void clear() noexcept
+	{
+		Core::clear(*this, nodes());
+	}
+
+	unsigned int count() const noexcept
+	{
+		return Core::count(*this);
+	}
+
+	iterator begin() noexcept { return iterator{head, nullptr}; }
+	iterator end() noexcept { return iterator{}; }
+	const_iterator begin() const noexcept { return const_iterator{head, nullptr}; }
+	const_iterator end() const noexcept { return const_iterator{}; }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+	iterator before_begin() noexcept { return iterator{nullptr, this}; }
+	const_iterator before_begin() const noexcept { return const_iterator{nullptr, this}; }
+
+	/* Both are O(1), pos may be before_begin()
+	 * @return iterator to the new element, or end when out of memory
+	 */
+	iterator insert_after(const_iterator pos, const T& new_data)
+	{
+		return emplace_after(pos, new_data);
+	}
+
+	iterator insert_after(const_iterator pos, T&& new_data)
+	{
+		return emplace_after(pos, std::move(new_data));
+	}
+
+	template <typename... Args>
+	iterator emplace_after(const_iterator pos, Args&&... args)
+	{
+		auto new_p = Core::insert_after(*this, nodes(), pos.node_p, std::forward<Args>(args)...);
+		return new_p ? iterator{new_p, nullptr} : end();
+	}
+
+	/* @return iterator to the element after the erased one */
+	iterator erase_after(const_iterator pos)
+	{
+		return iterator{Core::erase_after(*this, nodes(), pos.node_p), nullptr};
+	}
+
+	allocator_type get_allocator() const
+	{
+		return allocator_type(node_allocator);
+	}
+
+private:
+	/* Nodes of ListCore taken from node_allocator */
+	class Nodes {
+	public:
+		explicit Nodes(NodeAllocator& node_allocator) : node_allocator{node_allocator} {}
+
+		/* @return node or nullptr when allocator is out of memory */
+		template <typename... Args>
+		Node* new_node(Args&&... args)
+		{
+			Node* new_p;
+			try
+			{
+				new_p = NodeTraits::allocate(node_allocator, 1);
+			}
+			catch(const std::bad_alloc&)
+			{
+				return nullptr;
+			}
+
+			try
+			{
+				NodeTraits::construct(node_allocator, std::addressof(new_p->data),
+					std::forward<Args>(args)...);
+			}
+			catch(...)
+			{
+				NodeTraits::deallocate(node_allocator, new_p, 1);
+				throw;
+			}
+			return new_p;
+		}
+
+		void delete_node(Node* node_p) noexcept
+		{
+			NodeTraits::destroy(node_allocator, std::addressof(node_p->data));
+			NodeTraits::deallocate(node_allocator, node_p, 1);
+		}
+
+		void delete_chain(Node* head_p) noexcept
+			requires std::is_same_v<NodeAllocator, PoolAllocator<Node>>
+		{
+			if constexpr(!std::is_trivially_destructible_v<T>)
+			{
+				for(auto node_p = head_p; node_p; node_p = node_p->next)
+				{
+					NodeTraits::destroy(node_allocator, std::addressof(node_p->data));
+				}
+			}
+			NodePool<Node>::free_chain(head_p);
+		}
+
+	private:
+		NodeAllocator& node_allocator;
+	};
+
+	Nodes nodes() noexcept
+	{
+		return Nodes{node_allocator};
+	}
+
+	/* Copied nodes are freed when an element's copy throws too, a copy
+	 * constructor that throws never gets to run the destructor
+	 */
+	void copy_from(const List& other)
+	{
+		try
+		{
+			for(auto node_p = other.head; node_p; node_p = node_p->next)
+			{
+				if(emplace_back(node_p->data)) throw std::bad_alloc();
+			}
+		}
+		catch(...)
+		{
+			clear();
+			throw;
+		}
+	}
 };
 
 #endif /* LINKED_LIST_H_ */
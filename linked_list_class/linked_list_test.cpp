@@ -1,7 +1,52 @@
 #include <time.h>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <ranges>
 #include <criterion.h>
 #include "linked_list.h"
 
+/* Cross-checked count() walks the list, timing it is pointless */
+#ifdef CHECK_COUNT
+#define IS_COUNT_CHECKED true
+#else
+#define IS_COUNT_CHECKED false
+#endif
+
+/* Counts live instances, to find leaked or doubly destroyed elements */
+struct counted
+{
+	static int live_c;
+	int value;
+
+	counted(int value) : value{value} { ++live_c; }
+	counted(const counted& other) : value{other.value} { ++live_c; }
+	~counted() { --live_c; }
+};
+
+int counted::live_c = 0;
+
+/* Counted element whose copy throws once copies_left runs out */
+struct throwing : counted
+{
+	static int copies_left;
+
+	throwing(int value) : counted{value} {}
+	throwing(const throwing& other) : counted{check_copy(other)} {}
+
+	static const counted& check_copy(const throwing& other)
+	{
+		if(copies_left-- == 0) throw std::runtime_error("copy");
+		return other;
+	}
+};
+
+int throwing::copies_left = 0;
+
 Test(singly_linked_list_suite, basic_scenario)
 {
 	const char initial_char = 'x';
@@ -173,3 +218,316 @@ Test(singly_linked_list_suite, time_measurements, .disabled = false)
 	ticks = end - start;
 	cr_log_info("CPU ticks used: %9d", ticks);
 }
+
+Test(list_template_suite, emplace_constructs_in_place)
+{
+	List<std::string> list;
+	cr_assert_eq(RESULT_OK, list.emplace_back(3, 'a'));
+	cr_assert_eq(RESULT_OK, list.emplace_front("front"));
+	cr_assert_eq(RESULT_OK, list.push_back(std::string("back")));
+	cr_assert_eq(3, list.count());
+
+	std::string popped;
+	cr_assert_eq(RESULT_OK, list.pop_front(popped));
+	cr_assert_eq(std::string("front"), popped);
+	cr_assert_eq(RESULT_OK, list.pop_back(popped));
+	cr_assert_eq(std::string("back"), popped);
+	cr_assert_eq(RESULT_OK, list.pop_back(popped));
+	cr_assert_eq(std::string("aaa"), popped);
+	cr_assert_eq(RESULT_NOK, list.pop_back(popped));
+}
+
+Test(list_template_suite, destructor_destroys_elements)
+{
+	std::pmr::unsynchronized_pool_resource resource;
+	{
+		List<counted> pooled;
+		List<counted, std::allocator<counted>> standard;
+		List<counted, std::pmr::polymorphic_allocator<counted>> pmr(&resource);
+		for(int i = 0; i < 100; ++i)
+		{
+			cr_assert_eq(RESULT_OK, pooled.emplace_back(i));
+			cr_assert_eq(RESULT_OK, standard.emplace_front(i));
+			cr_assert_eq(RESULT_OK, pmr.emplace_back(i));
+		}
+		cr_assert_eq(300, counted::live_c);
+
+		pooled.clear();
+		cr_assert_eq(200, counted::live_c);
+	}
+	cr_assert_eq(0, counted::live_c);
+}
+
+Test(list_template_suite, copy_is_deep)
+{
+	List<std::string> list;
+	cr_assert_eq(RESULT_OK, list.push_back("a"));
+	cr_assert_eq(RESULT_OK, list.push_back("b"));
+
+	List<std::string> copy(list);
+	std::string popped;
+	cr_assert_eq(RESULT_OK, copy.pop_front(popped));
+	cr_assert_eq(1, copy.count());
+	cr_assert_eq(2, list.count());
+
+	copy = list;
+	cr_assert_eq(2, copy.count());
+	cr_assert_eq(RESULT_OK, copy.pop_back(popped));
+	cr_assert_eq(std::string("b"), popped);
+}
+
+template <typename List>
+static void check_throwing_copy()
+{
+	{
+		List list;
+		for(int i = 0; i < 5; ++i)
+		{
+			cr_assert_eq(RESULT_OK, list.emplace_back(i));
+		}
+		bool is_thrown = false;
+		throwing::copies_left = 2;
+		try
+		{
+			List copy(list);
+		}
+		catch(const std::runtime_error&)
+		{
+			is_thrown = true;
+		}
+		cr_assert(is_thrown);
+		cr_assert_eq(5, counted::live_c);
+
+		List assigned;
+		cr_assert_eq(RESULT_OK, assigned.emplace_back(9));
+		is_thrown = false;
+		throwing::copies_left = 3;
+		try
+		{
+			assigned = list;
+		}
+		catch(const std::runtime_error&)
+		{
+			is_thrown = true;
+		}
+		cr_assert(is_thrown);
+		cr_assert_eq(0, assigned.count());
+		cr_assert_eq(5, counted::live_c);
+	}
+	cr_assert_eq(0, counted::live_c);
+}
+
+/* Elements copied before the throwing one are freed with their nodes */
+Test(list_template_suite, throwing_copy_leaks_nothing)
+{
+	check_throwing_copy<List<throwing>>();
+	check_throwing_copy<List<throwing, std::allocator<throwing>>>();
+	check_throwing_copy<List<throwing, std::pmr::polymorphic_allocator<throwing>>>();
+}
+
+Test(list_template_suite, move_takes_nodes_over)
+{
+	static_assert(std::is_nothrow_move_constructible_v<List<std::string>>);
+	static_assert(std::is_nothrow_move_assignable_v<List<std::string>>);
+
+	std::vector<List<std::string>> lists;
+	for(int i = 0; i < 10; ++i)
+	{
+		List<std::string> list;
+		cr_assert_eq(RESULT_OK, list.emplace_back(i, 'x'));
+		lists.push_back(std::move(list));
+		cr_assert_eq(0, list.count());
+	}
+
+	List<std::string> moved;
+	moved = std::move(lists.back());
+	cr_assert_eq(0, lists.back().count());
+	std::string popped;
+	cr_assert_eq(RESULT_OK, moved.pop_front(popped));
+	cr_assert_eq(std::string(9, 'x'), popped);
+}
+
+Test(list_template_suite, move_between_arenas_moves_elements)
+{
+	using pmr_list = List<counted, std::pmr::polymorphic_allocator<counted>>;
+
+	std::pmr::monotonic_buffer_resource first_arena, second_arena;
+	{
+		pmr_list first(&first_arena), second(&second_arena);
+		for(int i = 0; i < 10; ++i)
+		{
+			cr_assert_eq(RESULT_OK, first.emplace_back(i));
+		}
+
+		second = std::move(first);
+		cr_assert_eq(0, first.count());
+		cr_assert_eq(10, second.count());
+		cr_assert_eq(10, counted::live_c);
+		cr_assert(second.get_allocator().resource() == &second_arena);
+
+		counted popped(-1);
+		cr_assert_eq(RESULT_OK, second.pop_front(popped));
+		cr_assert_eq(0, popped.value);
+	}
+	cr_assert_eq(0, counted::live_c);
+}
+
+Test(list_template_suite, exhausted_arena_reports_error)
+{
+	alignas(std::max_align_t) char buffer[1024];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+		std::pmr::null_memory_resource());
+	List<long, std::pmr::polymorphic_allocator<long>> list(&arena);
+
+	unsigned int pushed_c = 0;
+	while(list.push_back(pushed_c) == RESULT_OK)
+	{
+		++pushed_c;
+	}
+	cr_assert_gt(pushed_c, 0);
+	cr_assert_leq(pushed_c, sizeof(buffer) / sizeof(ListNode<long>));
+	cr_assert_eq(pushed_c, list.count());
+}
+
+Test(list_template_suite, iterate_without_popping)
+{
+	static_assert(std::forward_iterator<List<int>::iterator>);
+	static_assert(std::forward_iterator<List<int>::const_iterator>);
+	static_assert(std::ranges::forward_range<List<int>>);
+
+	List<int> list;
+	for(int i = 1; i <= 5; ++i)
+	{
+		cr_assert_eq(RESULT_OK, list.push_back(i));
+	}
+
+	int sum = 0;
+	for(int value : list)
+	{
+		sum += value;
+	}
+	cr_assert_eq(15, sum);
+	cr_assert_eq(5, list.count());
+
+	for(auto& value : list)
+	{
+		value *= 10;
+	}
+	const auto& const_list = list;
+	cr_assert_eq(150, std::accumulate(const_list.begin(), const_list.end(), 0));
+	cr_assert_eq(30, *std::ranges::find(list, 30));
+	auto evens = list | std::views::filter([](int value) { return value % 20 == 0; });
+	cr_assert_eq(2, std::ranges::distance(evens));
+
+	List<std::string> strings;
+	cr_assert_eq(RESULT_OK, strings.emplace_back("abc"));
+	cr_assert_eq(3, strings.begin()->size());
+}
+
+Test(list_template_suite, insert_and_erase_after)
+{
+	List<std::string> list;
+
+	auto head = list.emplace_after(list.before_begin(), "b");
+	cr_assert_eq(std::string("b"), *head);
+	list.insert_after(list.before_begin(), "a");
+	auto tail = list.insert_after(head, "d");
+	list.insert_after(head, std::string("c"));
+	cr_assert_eq(std::string("d"), *tail);
+	cr_assert(std::ranges::equal(list, std::vector<std::string>{"a", "b", "c", "d"}));
+
+	/* Tail follows erasing the last element and pushes still append */
+	auto after = list.erase_after(list.before_begin());
+	cr_assert_eq(std::string("b"), *after);
+	cr_assert(list.erase_after(std::next(after)) == list.end());
+	cr_assert_eq(RESULT_OK, list.push_back("e"));
+	cr_assert(std::ranges::equal(list, std::vector<std::string>{"b", "c", "e"}));
+
+	while(list.begin() != list.end())
+	{
+		list.erase_after(list.before_begin());
+	}
+	cr_assert_eq(0, list.count());
+	cr_assert_eq(RESULT_OK, list.push_back("f"));
+	cr_assert_eq(std::string("f"), *list.begin());
+}
+
+Test(list_template_suite, time_measurements, .disabled = false)
+{
+	const unsigned int rounds = 1000;
+	const unsigned int count = 10000;
+
+	cr_log_info("Measure cycles for %d rounds of emplace_back "
+			    "and clear of %d ints:", rounds, count);
+	clock_t start = clock();
+	List<int> pooled;
+	for(unsigned int round = 0; round < rounds; ++round)
+	{
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			cr_assert_eq(RESULT_OK, pooled.emplace_back(i));
+		}
+		pooled.clear();
+	}
+	clock_t end = clock();
+	cr_log_info("NodePool          CPU ticks used: %9ld", (long)(end - start));
+
+	start = clock();
+	List<int, std::allocator<int>> standard;
+	for(unsigned int round = 0; round < rounds; ++round)
+	{
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			cr_assert_eq(RESULT_OK, standard.emplace_back(i));
+		}
+		standard.clear();
+	}
+	end = clock();
+	cr_log_info("std::allocator    CPU ticks used: %9ld", (long)(end - start));
+
+	start = clock();
+	for(unsigned int round = 0; round < rounds; ++round)
+	{
+		std::pmr::monotonic_buffer_resource arena;
+		List<int, std::pmr::polymorphic_allocator<int>> pmr(&arena);
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			cr_assert_eq(RESULT_OK, pmr.emplace_back(i));
+		}
+	}
+	end = clock();
+	cr_log_info("monotonic arena   CPU ticks used: %9ld", (long)(end - start));
+}
+
+Test(list_template_suite, count_time_measurements, .disabled = IS_COUNT_CHECKED)
+{
+	const unsigned int calls = 10000000;
+	List<char> list;
+
+	cr_log_info("Measure cycles for %d calls of count:", calls);
+	for(unsigned int length = 1000; length <= 10000000; length *= 100)
+	{
+		while(list.count() < length)
+		{
+			cr_assert_eq(RESULT_OK, list.push_front('\0'));
+		}
+
+		/* volatile keeps calls from being merged */
+		volatile unsigned int counted = 0;
+		clock_t start = clock();
+		for(unsigned int i = 0; i < calls; ++i)
+		{
+			counted = list.count();
+		}
+		clock_t end = clock();
+		cr_assert_eq(length, counted);
+		cr_log_info("length %8d CPU ticks used: %9ld", length, (long)(end - start));
+	}
+
+	/* Moves hand the size over together with nodes */
+	List<char> moved(std::move(list));
+	cr_assert_eq(0, list.count());
+	cr_assert_eq(10000000, moved.count());
+	moved.clear();
+	cr_assert_eq(0, moved.count());
+}
@@ -0,0 +1,452 @@
+#ifndef SKIP_LIST_H_
+#define SKIP_LIST_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "node_pool.h"
+
+#define RESULT_OK   0
+#define RESULT_NOK -1
+
+/* Ordered set of unique keys. Every key sits in a node linked at level 0,
+ * and with probability 1/2 also at each next level, so searches skip
+ * ahead on upper levels and insert, find and erase are O(log n) expected.
+ *
+ * Nodes with towers of different heights come from separate NodePools,
+ * one per height.
+ *
+ * In the concurrent mode insert, erase and clear may be called from any
+ * thread and are serialised by a lock, while find, contains and scan
+ * never lock: links are published with release stores after a node is
+ * fully built, and erased nodes are freed only once every read which
+ * could still see them is over. A read writes only to a reader counter
+ * on its thread's own cache line, one of reader_stripes, so readers on
+ * different threads don't contend until there are more threads than
+ * stripes.
+ */
+template <typename Key, typename Compare = std::less<Key>, bool concurrent = false>
+class SkipList {
+public:
+	static constexpr unsigned int max_height = 24;
+	/* Erased nodes kept before waiting for readers to free them at once */
+	static constexpr std::size_t retired_max = 64;
+	/* Cache lines of reader counters, threads take them round robin */
+	static constexpr unsigned int reader_stripes = concurrent ? 16 : 1;
+
+	SkipList() = default;
+	explicit SkipList(const Compare& compare) : compare{compare} {}
+	SkipList(const SkipList&) = delete;
+	SkipList& operator=(const SkipList&) = delete;
+
+	~SkipList()
+	{
+		clear();
+	}
+
+	/* @return RESULT_NOK when the key is already there or out of memory */
+	int insert(const Key& key)
+	{
+		return emplace(key);
+	}
+
+	int insert(Key&& key)
+	{
+		return emplace(std::move(key));
+	}
+
+	template <typename... Args>
+	int emplace(Args&&... args)
+	{
+		auto guard = write_lock();
+		auto new_p = new_node(std::forward<Args>(args)...);
+		if(!new_p) return RESULT_NOK;
+
+		Link* preds[max_height];
+		auto found_p = find_preds(new_p->key, preds);
+		if(found_p && is_equal(found_p->key, new_p->key))
+		{
+			delete_node(new_p);
+			return RESULT_NOK;
+		}
+
+		/* Node is complete before it's reachable, lowest level first */
+		auto levels_p = new_p->levels();
+		for(unsigned int level = 0; level < new_p->height; ++level)
+		{
+			levels_p[level].store(preds[level][level].load(std::memory_order_relaxed),
+				std::memory_order_relaxed);
+		}
+		for(unsigned int level = 0; level < new_p->height; ++level)
+		{
+			preds[level][level].store(new_p, std::memory_order_release);
+		}
+		size.fetch_add(1, std::memory_order_relaxed);
+		return RESULT_OK;
+	}
+
+	/* @return RESULT_NOK when there is no such key */
+	int erase(const Key& key)
+	{
+		auto guard = write_lock();
+		Link* preds[max_height];
+		auto found_p = find_preds(key, preds);
+		if(!found_p || !is_equal(found_p->key, key)) return RESULT_NOK;
+
+		/* Readers already on the node still follow its links */
+		auto levels_p = found_p->levels();
+		for(unsigned int level = found_p->height; level-- > 0;)
+		{
+			preds[level][level].store(levels_p[level].load(std::memory_order_relaxed),
+				std::memory_order_release);
+		}
+		size.fetch_sub(1, std::memory_order_relaxed);
+		retire(found_p);
+		return RESULT_OK;
+	}
+
+	/* Copies the key equal to key, which matters when Compare looks
+	 * only at a part of it
+	 * @return RESULT_NOK when there is no such key
+	 */
+	int find(const Key& key, Key& data_storage) const
+	{
+		ReadGuard guard{*this};
+		auto found_p = lower_bound(key);
+		if(!found_p || !is_equal(found_p->key, key)) return RESULT_NOK;
+
+		data_storage = found_p->key;
+		return RESULT_OK;
+	}
+
+	bool contains(const Key& key) const
+	{
+		ReadGuard guard{*this};
+		auto found_p = lower_bound(key);
+		return found_p && is_equal(found_p->key, key);
+	}
+
+	/* Calls visit with every key from from up to, but without, to in order
+	 * @return number of keys visited
+	 */
+	template <typename Visit>
+	unsigned int scan(const Key& from, const Key& to, Visit&& visit) const
+	{
+		ReadGuard guard{*this};
+		unsigned int visited_c = 0;
+		for(auto node_p = lower_bound(from);
+			node_p && compare(node_p->key, to);
+			node_p = node_p->levels()[0].load(std::memory_order_acquire))
+		{
+			visit(std::as_const(node_p->key));
+			++visited_c;
+		}
+		return visited_c;
+	}
+
+	/* O(1), in the concurrent mode it may be outdated as soon as read */
+	unsigned int count() const noexcept
+	{
+		return size.load(std::memory_order_relaxed);
+	}
+
+	void clear()
+	{
+		auto guard = write_lock();
+		auto node_p = heads[0].load(std::memory_order_relaxed);
+		for(auto& head : heads)
+		{
+			head.store(nullptr, std::memory_order_release);
+		}
+		size.store(0, std::memory_order_relaxed);
+
+		while(node_p)
+		{
+			auto next_p = node_p->levels()[0].load(std::memory_order_relaxed);
+			retire(node_p);
+			node_p = next_p;
+		}
+		reclaim();
+	}
+
+private:
+	struct Node;
+	using Link = std::atomic<Node*>;
+
+	/* Tower of height links follows the node in the same pooled block */
+	struct Node {
+		Key key;
+		unsigned int height;
+
+		template <typename... Args>
+		Node(unsigned int height, Args&&... args) :
+			key(std::forward<Args>(args)...), height{height} {}
+
+		Link* levels() noexcept
+		{
+			return std::launder(reinterpret_cast<Link*>(
+				reinterpret_cast<std::byte*>(this) + levels_offset));
+		}
+	};
+
+	static constexpr std::size_t levels_offset =
+		(sizeof(Node) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+
+	template <std::size_t height>
+	struct alignas(Node) alignas(Link) Block {
+		std::byte bytes[levels_offset + height * sizeof(Link)];
+	};
+	static_assert(alignof(Block<1>) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+		"NodePool slabs are aligned by operator new only");
+
+	using AllocFn = void* (*)();
+	using FreeFn = void (*)(void*);
+
+	template <std::size_t... heights>
+	static constexpr std::array<AllocFn, max_height> make_allocs(std::index_sequence<heights...>)
+	{
+		return {+[]() -> void* { return NodePool<Block<heights + 1>>::alloc(); }...};
+	}
+
+	template <std::size_t... heights>
+	static constexpr std::array<FreeFn, max_height> make_frees(std::index_sequence<heights...>)
+	{
+		return {+[](void* p) { NodePool<Block<heights + 1>>::free(static_cast<Block<heights + 1>*>(p)); }...};
+	}
+
+	/* @return storage for a node of height from its pool, or nullptr */
+	static void* alloc_block(unsigned int height)
+	{
+		static constexpr auto allocs = make_allocs(std::make_index_sequence<max_height>());
+		return allocs[height - 1]();
+	}
+
+	static void free_block(unsigned int height, void* block_p)
+	{
+		static constexpr auto frees = make_frees(std::make_index_sequence<max_height>());
+		frees[height - 1](block_p);
+	}
+
+	/* Reader counters of both phases, alone on their cache line */
+	struct alignas(64) ReaderStripe
+	{
+		std::atomic<unsigned int> counts[2] = {};
+	};
+
+	/* @return stripe of the calling thread, the same for all lists */
+	static unsigned int reader_stripe()
+	{
+		static std::atomic<unsigned int> threads_c = 0;
+		thread_local unsigned int stripe =
+			threads_c.fetch_add(1, std::memory_order_relaxed) % reader_stripes;
+		return stripe;
+	}
+
+	/* Read side of the grace period: readers count themselves in their
+	 * stripe's counter of the current phase, a writer flips the phase and
+	 * waits until the old counter of every stripe drains. Two flips make
+	 * sure a reader which took the phase before the first flip is waited
+	 * for too.
+	 */
+	class ReadGuard {
+	public:
+		explicit ReadGuard(const SkipList& list)
+		{
+			if constexpr(concurrent)
+			{
+				auto phase = list.phase.load(std::memory_order_relaxed) & 1;
+				count_p = &list.readers[reader_stripe()].counts[phase];
+				count_p->fetch_add(1, std::memory_order_seq_cst);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+		}
+
+		~ReadGuard()
+		{
+			if constexpr(concurrent)
+			{
+				count_p->fetch_sub(1, std::memory_order_release);
+			}
+		}
+
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+
+	private:
+		std::atomic<unsigned int>* count_p = nullptr;
+	};
+
+	Link heads[max_height] = {};
+	std::atomic<unsigned int> size = 0;
+	[[no_unique_address]] Compare compare;
+	/* Used only by the concurrent mode */
+	std::mutex write_mutex;
+	std::vector<Node*> retired;
+	alignas(64) std::atomic<unsigned int> phase = 0;
+	mutable ReaderStripe readers[reader_stripes];
+
+	std::unique_lock<std::mutex> write_lock()
+	{
+		if constexpr(concurrent) return std::unique_lock<std::mutex>{write_mutex};
+		else return std::unique_lock<std::mutex>{};
+	}
+
+	bool is_equal(const Key& a, const Key& b) const
+	{
+		return !compare(a, b) && !compare(b, a);
+	}
+
+	/* @return first node not less than key, or nullptr */
+	Node* lower_bound(const Key& key) const
+	{
+		auto level_p = const_cast<Link*>(heads);
+		Node* next_p = nullptr;
+		for(unsigned int level = max_height; level-- > 0;)
+		{
+			while((next_p = level_p[level].load(std::memory_order_acquire)) &&
+				compare(next_p->key, key))
+			{
+				level_p = next_p->levels();
+			}
+		}
+		return next_p;
+	}
+
+	/* Sets links of the last nodes less than key on each level,
+	 * heads where there is none
+	 * @return first node not less than key, or nullptr
+	 */
+	Node* find_preds(const Key& key, Link** preds)
+	{
+		auto level_p = heads;
+		Node* next_p = nullptr;
+		for(unsigned int level = max_height; level-- > 0;)
+		{
+			while((next_p = level_p[level].load(std::memory_order_relaxed)) &&
+				compare(next_p->key, key))
+			{
+				level_p = next_p->levels();
+			}
+			preds[level] = level_p;
+		}
+		return next_p;
+	}
+
+	/* @return height from 1 to max_height, each next one half as likely */
+	static unsigned int random_height()
+	{
+		thread_local std::uint64_t state =
+			0x9e3779b97f4a7c15ULL ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return static_cast<unsigned int>(__builtin_ctzll(state | (1ULL << (max_height - 1)))) + 1;
+	}
+
+	/* @return node or nullptr when out of memory */
+	template <typename... Args>
+	Node* new_node(Args&&... args)
+	{
+		auto height = random_height();
+		auto block_p = alloc_block(height);
+		if(!block_p) return nullptr;
+
+		Node* new_p;
+		try
+		{
+			new_p = ::new(block_p) Node(height, std::forward<Args>(args)...);
+		}
+		catch(...)
+		{
+			free_block(height, block_p);
+			throw;
+		}
+		auto levels_p = new_p->levels();
+		for(unsigned int level = 0; level < height; ++level)
+		{
+			::new(&levels_p[level]) Link(nullptr);
+		}
+		return new_p;
+	}
+
+	void delete_node(Node* node_p) noexcept
+	{
+		auto height = node_p->height;
+		node_p->~Node();
+		free_block(height, node_p);
+	}
+
+	/* Called with the write lock held */
+	void retire(Node* node_p)
+	{
+		if constexpr(!concurrent)
+		{
+			delete_node(node_p);
+		}
+		else
+		{
+			try
+			{
+				retired.push_back(node_p);
+			}
+			catch(const std::bad_alloc&)
+			{
+				/* No room to defer it, wait for readers now */
+				synchronize();
+				delete_node(node_p);
+				return;
+			}
+			if(retired.size() >= retired_max) reclaim();
+		}
+	}
+
+	void reclaim()
+	{
+		if constexpr(concurrent)
+		{
+			if(retired.empty()) return;
+
+			synchronize();
+			for(auto node_p : retired)
+			{
+				delete_node(node_p);
+			}
+			retired.clear();
+		}
+	}
+
+	/* @return once every read started before the call is over */
+	void synchronize()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		for(unsigned int flip = 0; flip < 2; ++flip)
+		{
+			auto old_phase = phase.fetch_add(1, std::memory_order_seq_cst) & 1;
+			/* A stripe's counter never goes below zero, so a reader which
+			 * enters one after it was seen drained came after the flip
+			 */
+			for(auto& stripe : readers)
+			{
+				while(stripe.counts[old_phase].load(std::memory_order_seq_cst))
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+};
+
+/* Skip list whose reads are lock-free and safe along writes */
+template <typename Key, typename Compare = std::less<Key>>
+using ConcurrentSkipList = SkipList<Key, Compare, true>;
+
+#endif /* SKIP_LIST_H_ */
@@ -0,0 +1,292 @@
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <criterion.h>
+#include "linked_list.h"
+#include "skip_list.h"
+
+/* Keys of benchmarks and randomised tests, same sequence every run */
+static std::uint32_t next_random(std::uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+Test(skip_list_suite, basic_scenario)
+{
+	SkipList<int> list;
+	cr_assert_eq(0, list.count());
+	cr_assert_not(list.contains(1));
+
+	for(int key : {5, 1, 3, 9, 7})
+	{
+		cr_assert_eq(RESULT_OK, list.insert(key));
+	}
+	cr_assert_eq(RESULT_NOK, list.insert(3));
+	cr_assert_eq(5, list.count());
+
+	int found = 0;
+	cr_assert_eq(RESULT_OK, list.find(7, found));
+	cr_assert_eq(7, found);
+	cr_assert_eq(RESULT_NOK, list.find(4, found));
+
+	cr_assert_eq(RESULT_OK, list.erase(1));
+	cr_assert_eq(RESULT_NOK, list.erase(1));
+	cr_assert_not(list.contains(1));
+	cr_assert_eq(4, list.count());
+
+	std::vector<int> scanned;
+	cr_assert_eq(3, list.scan(2, 9, [&](int key) { scanned.push_back(key); }));
+	cr_assert(scanned == std::vector<int>({3, 5, 7}));
+	cr_assert_eq(0, list.scan(10, 20, [](int) {}));
+
+	list.clear();
+	cr_assert_eq(0, list.count());
+	cr_assert_not(list.contains(5));
+	cr_assert_eq(RESULT_OK, list.insert(5));
+}
+
+/* Elements compared by the first member only, find copies the stored one */
+Test(skip_list_suite, find_by_partial_key)
+{
+	auto by_first = [](const std::pair<int, std::string>& a,
+		const std::pair<int, std::string>& b) { return a.first < b.first; };
+	SkipList<std::pair<int, std::string>, decltype(by_first)> list{by_first};
+	cr_assert_eq(RESULT_OK, list.emplace(2, "two"));
+	cr_assert_eq(RESULT_OK, list.emplace(1, std::string(100, 'x')));
+	cr_assert_eq(RESULT_NOK, list.emplace(2, "again"));
+
+	std::pair<int, std::string> found{2, ""};
+	cr_assert_eq(RESULT_OK, list.find(found, found));
+	cr_assert(found.second == "two");
+	found.first = 1;
+	cr_assert_eq(RESULT_OK, list.find(found, found));
+	cr_assert_eq(100, found.second.size());
+}
+
+/* Same random inserts and erases on std::set must leave the same keys */
+Test(skip_list_suite, matches_std_set)
+{
+	SkipList<int> list;
+	std::set<int> expected;
+	std::uint32_t state = 1;
+	for(unsigned int i = 0; i < 200000; ++i)
+	{
+		int key = next_random(state) % 10000;
+		if(next_random(state) % 3)
+		{
+			bool is_new = expected.insert(key).second;
+			cr_assert_eq(is_new ? RESULT_OK : RESULT_NOK, list.insert(key));
+		}
+		else
+		{
+			bool is_there = expected.erase(key);
+			cr_assert_eq(is_there ? RESULT_OK : RESULT_NOK, list.erase(key));
+		}
+	}
+
+	cr_assert_eq(expected.size(), list.count());
+	std::vector<int> scanned;
+	list.scan(0, 10000, [&](int key) { scanned.push_back(key); });
+	cr_assert(std::ranges::equal(expected, scanned));
+}
+
+/* Even keys stay all the time, a writer keeps inserting and erasing odd
+ * ones, readers must always find every even key in order. There are more
+ * readers than counter stripes, so some of them share one.
+ */
+Test(skip_list_suite, threads_readers_with_writer)
+{
+	const int keys_c = 20000;
+	const unsigned int readers_c = ConcurrentSkipList<int>::reader_stripes + 2;
+	ConcurrentSkipList<int> list;
+	for(int key = 0; key < keys_c; key += 2)
+	{
+		cr_assert_eq(RESULT_OK, list.insert(key));
+	}
+
+	std::atomic<bool> is_done = false;
+	std::thread writer([&]()
+	{
+		std::uint32_t state = 7;
+		for(unsigned int i = 0; i < 200000; ++i)
+		{
+			int key = (next_random(state) % (keys_c / 2)) * 2 + 1;
+			if(list.insert(key)) list.erase(key);
+		}
+		is_done = true;
+	});
+
+	std::atomic<unsigned int> errors_c = 0;
+	std::vector<std::thread> readers;
+	for(unsigned int i = 0; i < readers_c; ++i)
+	{
+		readers.emplace_back([&, i]()
+		{
+			std::uint32_t state = 11 + i;
+			do
+			{
+				for(unsigned int j = 0; j < 1000; ++j)
+				{
+					if(!list.contains((next_random(state) % (keys_c / 2)) * 2)) ++errors_c;
+				}
+
+				int last = -1;
+				int evens_c = 0;
+				list.scan(0, keys_c, [&](int key)
+				{
+					if(key <= last) ++errors_c;
+					if(key % 2 == 0) ++evens_c;
+					last = key;
+				});
+				if(evens_c != keys_c / 2) ++errors_c;
+			} while(!is_done);
+		});
+	}
+
+	writer.join();
+	for(auto& reader : readers)
+	{
+		reader.join();
+	}
+	cr_assert_eq(0, errors_c.load());
+	cr_assert_geq(list.count(), keys_c / 2);
+}
+
+Test(skip_list_suite, time_measurements, .disabled = false)
+{
+	const unsigned int lookups = 1000000;
+	/* Linear scans take too long to do as many */
+	const unsigned int scan_lookups = 100;
+
+	for(unsigned int keys_c = 1000000; keys_c <= 10000000; keys_c *= 10)
+	{
+		cr_log_info("Measure cycles for %d random inserts:", keys_c);
+		SkipList<int> skip_list;
+		std::uint32_t state = 1;
+		clock_t start = clock();
+		for(unsigned int i = 0; i < keys_c; ++i)
+		{
+			skip_list.insert(next_random(state));
+		}
+		clock_t end = clock();
+		cr_log_info("SkipList CPU ticks used: %9ld", (long)(end - start));
+
+		std::set<int> set;
+		state = 1;
+		start = clock();
+		for(unsigned int i = 0; i < keys_c; ++i)
+		{
+			set.insert(next_random(state));
+		}
+		end = clock();
+		cr_log_info("std::set CPU ticks used: %9ld", (long)(end - start));
+		cr_assert_eq(set.size(), skip_list.count());
+
+		/* Half of lookups hit, the other half very likely miss */
+		cr_log_info("Measure cycles for %d random lookups:", lookups);
+		state = 1;
+		unsigned int found_c = 0;
+		start = clock();
+		for(unsigned int i = 0; i < lookups; ++i)
+		{
+			auto key = next_random(state);
+			found_c += skip_list.contains(i % 2 ? key : key ^ 1);
+		}
+		end = clock();
+		cr_log_info("SkipList CPU ticks used: %9ld", (long)(end - start));
+
+		state = 1;
+		unsigned int set_found_c = 0;
+		start = clock();
+		for(unsigned int i = 0; i < lookups; ++i)
+		{
+			auto key = next_random(state);
+			set_found_c += set.contains(i % 2 ? key : key ^ 1);
+		}
+		end = clock();
+		cr_log_info("std::set CPU ticks used: %9ld", (long)(end - start));
+		cr_assert_eq(set_found_c, found_c);
+		set.clear();
+
+		List<int> list;
+		state = 1;
+		for(unsigned int i = 0; i < keys_c; ++i)
+		{
+			cr_assert_eq(RESULT_OK, list.push_front(next_random(state)));
+		}
+		state = 1;
+		unsigned int scan_found_c = 0;
+		start = clock();
+		for(unsigned int i = 0; i < scan_lookups; ++i)
+		{
+			int key = next_random(state);
+			scan_found_c += std::find(list.begin(), list.end(), i % 2 ? key : key ^ 1) != list.end();
+		}
+		end = clock();
+		cr_assert_geq(scan_found_c, scan_lookups / 2);
+		cr_log_info("List linear scan CPU ticks used: %9ld for %d lookups, "
+			"%ld per %d lookups", (long)(end - start), scan_lookups,
+			(long)(end - start) * (lookups / scan_lookups), lookups);
+	}
+
+	const unsigned int keys_c = 1000000;
+	const unsigned int reads_per_thread = 1000000;
+	ConcurrentSkipList<int> list;
+	std::uint32_t state = 1;
+	for(unsigned int i = 0; i < keys_c; ++i)
+	{
+		list.insert(next_random(state));
+	}
+
+	cr_log_info("Measure wall clock of %d lookups per reader thread "
+		"along one writer:", reads_per_thread);
+	for(unsigned int readers_c = 1; readers_c <= 8; readers_c *= 2)
+	{
+		std::atomic<bool> is_done = false;
+		std::thread writer([&]()
+		{
+			std::uint32_t writer_state = 3;
+			while(!is_done)
+			{
+				auto key = next_random(writer_state);
+				if(!list.insert(key)) list.erase(key);
+			}
+		});
+
+		struct timespec wall_start, wall_end;
+		clock_gettime(CLOCK_MONOTONIC, &wall_start);
+		std::vector<std::thread> readers;
+		for(unsigned int i = 0; i < readers_c; ++i)
+		{
+			readers.emplace_back([&, i]()
+			{
+				std::uint32_t reader_state = 1 + i;
+				for(unsigned int j = 0; j < reads_per_thread; ++j)
+				{
+					list.contains(next_random(reader_state));
+				}
+			});
+		}
+		for(auto& reader : readers)
+		{
+			reader.join();
+		}
+		clock_gettime(CLOCK_MONOTONIC, &wall_end);
+		is_done = true;
+		writer.join();
+
+		double seconds = (wall_end.tv_sec - wall_start.tv_sec) +
+			(wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+		cr_log_info("readers %d lookups per second: %.2f M", readers_c,
+			readers_c * reads_per_thread / seconds / 1e6);
+	}
+}
@@ -0,0 +1,55 @@
+#include "dlinked_list.h"
+#include "list_core.h"
+#include "node_pool.h"
+
+using Core = ListCore<dlist_t>;
+using Nodes = PoolNodes<struct dnode, NodePool<struct dnode>>;
+
+dlist_t make_new_dlist(char data)
+{
+	dlist_t list;
+	Core::init(list);
+	Core::push_front(list, Nodes{}, data);
+	return list;
+}
+
+int push_front(dlist_t& list, char new_data)
+{
+	return Core::push_front(list, Nodes{}, new_data);
+}
+
+int push_back(dlist_t& list, char new_data)
+{
+	return Core::push_back(list, Nodes{}, new_data);
+}
+
+int pop_front(dlist_t& list, char& data_storage)
+{
+	return Core::pop_front(list, Nodes{}, data_storage);
+}
+
+int pop_back(dlist_t& list, char& data_storage)
+{
+	return Core::pop_back(list, Nodes{}, data_storage);
+}
+
+unsigned int count(const dlist_t& list)
+{
+	return Core::count(list);
+}
+
+void clear(dlist_t& list)
+{
+	Core::clear(list, Nodes{});
+}
+
+dlist_iterator insert(dlist_t& list, dlist_iterator pos, char new_data)
+{
+	auto new_p = Core::insert(list, Nodes{}, pos.node_p, new_data);
+	return new_p ? dlist_iterator{new_p, &list} : end(list);
+}
+
+dlist_iterator erase(dlist_t& list, dlist_iterator pos)
+{
+	return {Core::erase(list, Nodes{}, pos.node_p), &list};
+}
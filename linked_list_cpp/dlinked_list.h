@@ -0,0 +1,113 @@
+#ifndef DLINKED_LIST_H_
+#define DLINKED_LIST_H_
+
+#include "linked_list.h"
+
+struct dnode
+{
+	struct dnode* next;
+	struct dnode* prev;
+	char data;
+};
+
+/* Handles to both ends, so every push and pop is O(1) */
+struct dlist
+{
+	struct dnode* head;
+	struct dnode* tail;
+	unsigned int size;
+};
+
+typedef struct dlist dlist_t;
+
+dlist_t make_new_dlist(char data);
+int push_front(dlist_t& list, char new_data);
+int push_back(dlist_t& list, char new_data);
+int pop_front(dlist_t& list, char& data_storage);
+int pop_back(dlist_t& list, char& data_storage);
+void clear(dlist_t& list);
+unsigned int count(const dlist_t& list);
+
+/* Bidirectional iterator over dlist_t, end can be decremented
+ * as it knows the list it belongs to
+ */
+template <typename Value>
+class basic_dlist_iterator {
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = char;
+	using difference_type = std::ptrdiff_t;
+	using pointer = Value*;
+	using reference = Value&;
+
+	basic_dlist_iterator() = default;
+	basic_dlist_iterator(struct dnode* node_p, const dlist_t* list_p) :
+		node_p{node_p}, list_p{list_p} {}
+
+	/* Mutable iterator is usable wherever a const one is expected */
+	operator basic_dlist_iterator<const char>() const
+	{
+		return basic_dlist_iterator<const char>{node_p, list_p};
+	}
+
+	reference operator*() const { return node_p->data; }
+	pointer operator->() const { return &node_p->data; }
+
+	basic_dlist_iterator& operator++()
+	{
+		node_p = node_p->next;
+		return *this;
+	}
+
+	basic_dlist_iterator operator++(int)
+	{
+		auto old = *this;
+		++*this;
+		return old;
+	}
+
+	basic_dlist_iterator& operator--()
+	{
+		node_p = node_p ? node_p->prev : list_p->tail;
+		return *this;
+	}
+
+	basic_dlist_iterator operator--(int)
+	{
+		auto old = *this;
+		--*this;
+		return old;
+	}
+
+	friend bool operator==(const basic_dlist_iterator& a, const basic_dlist_iterator& b)
+	{
+		return a.node_p == b.node_p;
+	}
+
+private:
+	friend basic_dlist_iterator<char> insert(dlist_t& list,
+		basic_dlist_iterator<char> pos, char new_data);
+	friend basic_dlist_iterator<char> erase(dlist_t& list, basic_dlist_iterator<char> pos);
+
+	struct dnode* node_p = nullptr;
+	const dlist_t* list_p = nullptr;
+};
+
+typedef basic_dlist_iterator<char> dlist_iterator;
+typedef basic_dlist_iterator<const char> dlist_const_iterator;
+
+inline dlist_iterator begin(dlist_t& list) { return {list.head, &list}; }
+inline dlist_iterator end(dlist_t& list) { return {nullptr, &list}; }
+inline dlist_const_iterator begin(const dlist_t& list) { return {list.head, &list}; }
+inline dlist_const_iterator end(const dlist_t& list) { return {nullptr, &list}; }
+inline dlist_const_iterator cbegin(const dlist_t& list) { return begin(list); }
+inline dlist_const_iterator cend(const dlist_t& list) { return end(list); }
+
+/* Both are O(1), insert() adds the new element before pos
+ * @return iterator to the new element, or end when out of memory
+ */
+dlist_iterator insert(dlist_t& list, dlist_iterator pos, char new_data);
+/* @return iterator to the element after the erased one */
+dlist_iterator erase(dlist_t& list, dlist_iterator pos);
+
+#endif /* DLINKED_LIST_H_ */
@@ -0,0 +1,188 @@
+#include <time.h>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <criterion.h>
+#include "dlinked_list.h"
+
+Test(doubly_linked_list_suite, basic_scenario)
+{
+	const char initial_char = 'x';
+	dlist_t list = make_new_dlist(initial_char);
+	cr_assert_eq(count(list), 1);
+	cr_assert_eq(list.head, list.tail);
+
+	char char_to_push = 'a';
+	char char_popped = '\0';
+	cr_assert_eq(RESULT_OK, push_back(list, char_to_push));
+	cr_assert_eq(RESULT_OK, pop_back(list, char_popped));
+	cr_assert_eq(char_to_push, char_popped);
+
+	char_to_push = 'b';
+	char_popped = '\0';
+	cr_assert_eq(RESULT_OK, push_front(list, char_to_push));
+	cr_assert_eq(RESULT_OK, pop_front(list, char_popped));
+	cr_assert_eq(char_to_push, char_popped);
+
+	cr_assert_eq(RESULT_OK, pop_back(list, char_popped));
+	cr_assert_eq(initial_char, char_popped);
+	cr_expect_eq(nullptr, list.head);
+	cr_expect_eq(nullptr, list.tail);
+}
+
+Test(doubly_linked_list_suite, pop_more_than_pushed)
+{
+	const char to_push = 'f';
+	dlist_t list = make_new_dlist(to_push);
+	char to_pop_into = '\0';
+	cr_assert_eq(RESULT_OK, pop_front(list, to_pop_into));
+	cr_assert_eq(to_push, to_pop_into);
+
+	for(int i = 0; i < 3; ++i)
+	{
+		// trying to pop more than pushed should return error
+		cr_expect_eq(RESULT_NOK, pop_back(list, to_pop_into));
+		cr_expect_eq(RESULT_NOK, pop_front(list, to_pop_into));
+	}
+
+	// buffer should not be altered after wrong pops
+	cr_assert_eq(to_push, to_pop_into);
+}
+
+Test(doubly_linked_list_suite, both_ends_order)
+{
+	dlist_t letters = make_new_dlist('a');
+
+	// d c b a x y z
+	for (char c = 'b'; c <= 'd'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, push_front(letters, c));
+	}
+	for (char c = 'x'; c <= 'z'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, push_back(letters, c));
+	}
+	cr_assert_eq(count(letters), 7);
+
+	char storage = 0;
+	cr_assert_eq(RESULT_OK, pop_back(letters, storage));
+	cr_assert_eq('z', storage);
+	cr_assert_eq(RESULT_OK, pop_front(letters, storage));
+	cr_assert_eq('d', storage);
+
+	// prev links must be consistent with next links
+	const char expected[] = "cbaxy";
+	unsigned int idx = 0;
+	for(auto node_p = letters.head; node_p; node_p = node_p->next, ++idx)
+	{
+		cr_assert_eq(expected[idx], node_p->data);
+		if(node_p->next) cr_assert_eq(node_p, node_p->next->prev);
+	}
+	for(auto node_p = letters.tail; node_p; node_p = node_p->prev)
+	{
+		cr_assert_eq(expected[--idx], node_p->data);
+	}
+	cr_assert_eq(0, idx);
+
+	clear(letters);
+	cr_assert_eq(nullptr, letters.head);
+	cr_assert_eq(nullptr, letters.tail);
+	cr_assert_eq(count(letters), 0);
+}
+
+Test(doubly_linked_list_suite, iterate_both_ways)
+{
+	static_assert(std::bidirectional_iterator<dlist_iterator>);
+	static_assert(std::bidirectional_iterator<dlist_const_iterator>);
+	static_assert(std::ranges::bidirectional_range<dlist_t>);
+
+	dlist_t list = make_new_dlist('a');
+	for(char c = 'b'; c <= 'e'; ++c)
+	{
+		cr_assert_eq(RESULT_OK, push_back(list, c));
+	}
+
+	cr_assert_eq('e', *std::prev(end(list)));
+	cr_assert(std::equal(std::make_reverse_iterator(end(list)),
+		std::make_reverse_iterator(begin(list)), "edcba"));
+
+	std::reverse(begin(list), end(list));
+	const dlist_t& const_list = list;
+	cr_assert(std::equal(cbegin(const_list), cend(const_list), "edcba"));
+	cr_assert_eq('e', list.head->data);
+
+	auto reversed = list | std::views::reverse;
+	cr_assert(std::ranges::equal(reversed, std::string_view("abcde")));
+	cr_assert_eq(5, count(list));
+	clear(list);
+}
+
+Test(doubly_linked_list_suite, insert_and_erase)
+{
+	dlist_t list = make_new_dlist('c');
+
+	auto head = insert(list, begin(list), 'a');
+	cr_assert_eq(list.head, list.tail->prev);
+	insert(list, std::next(head), 'b');
+	auto tail = insert(list, end(list), 'd');
+	cr_assert_eq(list.tail, list.head->next->next->next);
+	cr_assert_eq('d', *tail);
+	cr_assert(std::equal(begin(list), end(list), "abcd"));
+
+	cr_assert(erase(list, tail) == end(list));
+	cr_assert_eq('c', list.tail->data);
+	auto after = erase(list, begin(list));
+	cr_assert_eq('b', *after);
+	cr_assert_eq(nullptr, list.head->prev);
+	after = erase(list, after);
+	cr_assert_eq(list.head, list.tail);
+	erase(list, after);
+	cr_assert_eq(nullptr, list.head);
+	cr_assert_eq(nullptr, list.tail);
+}
+
+Test(doubly_linked_list_suite, time_measurements, .disabled = false)
+{
+	const unsigned int count = 10000000;
+
+	cr_log_info("Measure cycles for the push_back "
+			    "and pop_back of %d elements:", count);
+	clock_t start = clock();
+
+	dlist_t list = make_new_dlist('\0');
+	for(unsigned int i = 1; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_back(list, '\0'));
+	}
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		char dummy = 0;
+		cr_assert_eq(RESULT_OK, pop_back(list, dummy));
+	}
+	cr_assert_eq(nullptr, list.head);
+
+	clock_t end = clock();
+	unsigned int ticks = end - start;
+	cr_log_info("CPU ticks used: %9d", ticks);
+
+	cr_log_info("Measure cycles for the push_front "
+			    "and pop_front of %d elements:", count);
+	start = clock();
+
+	list = make_new_dlist('\0');
+	for(unsigned int i = 1; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, push_front(list, '\0'));
+	}
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		char dummy = 0;
+		cr_assert_eq(RESULT_OK, pop_front(list, dummy));
+	}
+	cr_assert_eq(nullptr, list.head);
+
+	end = clock();
+	ticks = end - start;
+	cr_log_info("CPU ticks used: %9d", ticks);
+}
@@ -1,128 +1,54 @@
 #include "linked_list.h"
+#include "list_core.h"
+#include "node_pool.h"
 
-static struct node** get_tail_pp(list_t& list);
-static struct node* get_tail_p(list_t& list);
-static struct node* new_node(const char new_data);
+using Core = ListCore<list_t>;
+using Nodes = PoolNodes<struct node, NodePool<struct node>>;
 
 list_t make_new(char data)
 {
-	return new_node(data);
+	list_t list;
+	Core::init(list);
+	Core::push_front(list, Nodes{}, data);
+	return list;
 }
 
 int push_front(list_t& list, char new_data)
 {
-	auto new_p = new_node(new_data);
-	if(!new_p) return RESULT_NOK;
-
-	if(list)
-	{
-		new_p->next = list;
-	}
-	list = new_p;
-	return RESULT_OK;
+	return Core::push_front(list, Nodes{}, new_data);
 }
 
 int push_back(list_t& list, char new_data)
 {
-	auto new_p = new_node(new_data);
-	if(!new_p) return RESULT_NOK;
-
-	auto tail_p = get_tail_p(list);
-	if(tail_p)
-	{
-		tail_p->next = new_p;
-	}
-	else
-	{
-		list = new_p;
-	}
-	return RESULT_OK;
+	return Core::push_back(list, Nodes{}, new_data);
 }
 
 int pop_front(list_t& list, char& data_storage)
 {
-	if(!list) return RESULT_NOK;
-
-	data_storage = list->data;
-	struct node* to_free_p = list;
-	list = list->next;
-	delete to_free_p;
-	return RESULT_OK;
+	return Core::pop_front(list, Nodes{}, data_storage);
 }
 
 int pop_back(list_t& list, char& data_storage)
 {
-	auto tail_pp = get_tail_pp(list);
-	if(tail_pp)
-	{
-		data_storage = (*tail_pp)->data;
-		delete *tail_pp;
-		*tail_pp = nullptr;
-		return RESULT_OK;
-	}
-	else
-	{
-		return RESULT_NOK;
-	}
+	return Core::pop_back(list, Nodes{}, data_storage);
 }
 
 unsigned int count(const list_t& list)
 {
-	if(!list) return 0;
-
-	auto next = list;
-	auto elements_c = 0;
-	while(next)
-	{
-		++elements_c;
-		next = next->next;
-	}
-	return elements_c;
+	return Core::count(list);
 }
 
 void clear(list_t& list)
 {
-	while(list)
-	{
-		auto to_free = list;
-		list = list->next;
-		delete to_free;
-	}
-}
-
-static struct node** get_tail_pp(list_t& list)
-{
-	if(!list) return nullptr;
-
-	auto next_pp = &list;
-	while ((*next_pp)->next)
-	{
-		next_pp = &((*next_pp)->next);
-	}
-	return next_pp;
+	Core::clear(list, Nodes{});
 }
 
-static struct node* get_tail_p(list_t& list)
+list_iterator insert_after(list_t& list, list_iterator pos, char new_data)
 {
-	auto tail_pp = get_tail_pp(list);
-	if(tail_pp)
-	{
-		return *tail_pp;
-	}
-	else
-	{
-		return nullptr;
-	}
+	return list_iterator{Core::insert_after(list, Nodes{}, pos.node_p, new_data)};
 }
 
-static struct node* new_node(const char new_data)
+list_iterator erase_after(list_t& list, list_iterator pos)
 {
-	auto new_p = new struct node;
-	if(!new_p) return nullptr;
-	else
-	{
-		new_p->data = new_data;
-		new_p->next = nullptr;
-		return new_p;
-	}
+	return list_iterator{Core::erase_after(list, Nodes{}, pos.node_p)};
 }
@@ -1,9 +1,12 @@
 #ifndef LINKED_LIST_H_
 #define LINKED_LIST_H_
 
+#include <cstddef>
+#include <iterator>
+
 #define RESULT_OK   0
 #define RESULT_NOK -1
-#define is_empty(list) (list == nullptr)
+#define is_empty(list) ((list).head == nullptr)
 
 struct node
 {
@@ -11,7 +14,17 @@ struct node
 	char data;
 };
 
-typedef struct node* list_t;
+/* Tail and size are kept up to date by every operation,
+ * so counting and pushing back are O(1)
+ */
+struct list
+{
+	struct node* head;
+	struct node* tail;
+	unsigned int size;
+};
+
+typedef struct list list_t;
 
 list_t make_new(char data);
 int push_front(list_t& list, char new_data);
@@ -21,4 +34,79 @@ int pop_back(list_t& list, char& data_storage);
 void clear(list_t& list);
 unsigned int count(const list_t& list);
 
+/* Forward iterator over list_t. Besides elements it can point before the
+ * first one, which is where insert_after() adds a new head.
+ */
+template <typename Value>
+class basic_list_iterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = char;
+	using difference_type = std::ptrdiff_t;
+	using pointer = Value*;
+	using reference = Value&;
+
+	basic_list_iterator() = default;
+	explicit basic_list_iterator(struct node* node_p) : node_p{node_p} {}
+	explicit basic_list_iterator(list_t* before_p) : before_p{before_p} {}
+
+	/* Mutable iterator is usable wherever a const one is expected */
+	operator basic_list_iterator<const char>() const
+	{
+		basic_list_iterator<const char> converted{node_p};
+		converted.before_p = before_p;
+		return converted;
+	}
+
+	reference operator*() const { return node_p->data; }
+	pointer operator->() const { return &node_p->data; }
+
+	basic_list_iterator& operator++()
+	{
+		node_p = before_p ? before_p->head : node_p->next;
+		before_p = nullptr;
+		return *this;
+	}
+
+	basic_list_iterator operator++(int)
+	{
+		auto old = *this;
+		++*this;
+		return old;
+	}
+
+	friend bool operator==(const basic_list_iterator& a, const basic_list_iterator& b)
+	{
+		return a.node_p == b.node_p && a.before_p == b.before_p;
+	}
+
+private:
+	template <typename> friend class basic_list_iterator;
+	friend basic_list_iterator<char> insert_after(list_t& list,
+		basic_list_iterator<char> pos, char new_data);
+	friend basic_list_iterator<char> erase_after(list_t& list, basic_list_iterator<char> pos);
+
+	struct node* node_p = nullptr;
+	/* Set only for the position before the first element */
+	list_t* before_p = nullptr;
+};
+
+typedef basic_list_iterator<char> list_iterator;
+typedef basic_list_iterator<const char> list_const_iterator;
+
+inline list_iterator begin(list_t& list) { return list_iterator{list.head}; }
+inline list_iterator end(list_t&) { return list_iterator{}; }
+inline list_const_iterator begin(const list_t& list) { return list_const_iterator{list.head}; }
+inline list_const_iterator end(const list_t&) { return list_const_iterator{}; }
+inline list_const_iterator cbegin(const list_t& list) { return begin(list); }
+inline list_const_iterator cend(const list_t& list) { return end(list); }
+inline list_iterator before_begin(list_t& list) { return list_iterator{&list}; }
+
+/* Both are O(1), pos may be before_begin()
+ * @return iterator to the new element, or end when out of memory
+ */
+list_iterator insert_after(list_t& list, list_iterator pos, char new_data);
+/* @return iterator to the element after the erased one */
+list_iterator erase_after(list_t& list, list_iterator pos);
+
 #endif /* LINKED_LIST_H_ */
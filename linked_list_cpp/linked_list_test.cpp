@@ -1,7 +1,18 @@
 #include <time.h>
+#include <algorithm>
+#include <cctype>
+#include <ranges>
+#include <string>
 #include <criterion.h>
 #include "linked_list.h"
 
+/* Cross-checked count() walks the list, timing it is pointless */
+#ifdef CHECK_COUNT
+#define IS_COUNT_CHECKED true
+#else
+#define IS_COUNT_CHECKED false
+#endif
+
 Test(singly_linked_list_suite, basic_scenario)
 {
 	const char initial_char = 'x';
@@ -22,7 +33,7 @@ Test(singly_linked_list_suite, basic_scenario)
 
 	cr_assert_eq(RESULT_OK, pop_front(list, char_popped));
 	cr_assert_eq(initial_char, char_popped);
-	cr_expect_eq(nullptr, list);
+	cr_expect_eq(nullptr, list.head);
 }
 
 Test(singly_linked_list_suite, pop_more_than_pushed)
@@ -130,7 +141,61 @@ Test(singly_linked_list_suite, push_clear_test)
 	);
 
 	clear(list);
-	cr_assert_eq(nullptr, list);
+	cr_assert_eq(nullptr, list.head);
+}
+
+Test(singly_linked_list_suite, iterate_without_popping)
+{
+	static_assert(std::forward_iterator<list_iterator>);
+	static_assert(std::forward_iterator<list_const_iterator>);
+	static_assert(std::ranges::forward_range<list_t>);
+
+	list_t list = make_new('a');
+	cr_assert_eq(RESULT_OK, push_back(list, 'b'));
+	cr_assert_eq(RESULT_OK, push_back(list, 'c'));
+
+	std::string seen;
+	for(char c : list)
+	{
+		seen += c;
+	}
+	cr_assert_eq(std::string("abc"), seen);
+	cr_assert_eq(3, count(list));
+
+	for(char& c : list)
+	{
+		c = std::toupper(c);
+	}
+	const list_t& const_list = list;
+	cr_assert(std::equal(cbegin(const_list), cend(const_list), "ABC"));
+	cr_assert(std::find(begin(list), end(list), 'B') != end(list));
+	cr_assert_eq(1, std::count(begin(list), end(list), 'C'));
+
+	cr_assert_eq('C', *std::ranges::find(list, 'C'));
+	cr_assert(std::ranges::is_sorted(list));
+	clear(list);
+	cr_assert(begin(list) == end(list));
+}
+
+Test(singly_linked_list_suite, insert_and_erase_after)
+{
+	list_t list = make_new('b');
+
+	auto head = insert_after(list, before_begin(list), 'a');
+	cr_assert_eq('a', *head);
+	cr_assert_eq('a', list.head->data);
+	auto tail = insert_after(list, std::next(head), 'd');
+	insert_after(list, std::next(head), 'c');
+	cr_assert_eq('d', *tail);
+	cr_assert(std::equal(begin(list), end(list), "abcd"));
+
+	/* Erase head, then the last element */
+	auto after = erase_after(list, before_begin(list));
+	cr_assert_eq('b', *after);
+	cr_assert(erase_after(list, std::next(after)) == end(list));
+	cr_assert(std::equal(begin(list), end(list), "bc"));
+	cr_assert_eq(2, count(list));
+	clear(list);
 }
 
 Test(singly_linked_list_suite, time_measurements, .disabled = false)
@@ -151,7 +216,7 @@ Test(singly_linked_list_suite, time_measurements, .disabled = false)
 		char dummy = 0;
 		cr_assert_eq(RESULT_OK, pop_back(list, dummy));
 	}
-	cr_assert_eq(nullptr, list);
+	cr_assert_eq(nullptr, list.head);
 
 	clock_t end = clock();
 	unsigned int ticks = end - start;
@@ -171,9 +236,37 @@ Test(singly_linked_list_suite, time_measurements, .disabled = false)
 		char dummy = 0;
 		cr_assert_eq(RESULT_OK, pop_front(list, dummy));
 	}
-	cr_assert_eq(nullptr, list);
+	cr_assert_eq(nullptr, list.head);
 
 	end = clock();
 	ticks = end - start;
 	cr_log_info("CPU ticks used: %9d", ticks);
 }
+
+Test(singly_linked_list_suite, count_time_measurements, .disabled = IS_COUNT_CHECKED)
+{
+	const unsigned int calls = 10000000;
+	list_t list = make_new('\0');
+
+	cr_log_info("Measure cycles for %d calls of count:", calls);
+	for(unsigned int length = 1000; length <= 10000000; length *= 100)
+	{
+		while(count(list) < length)
+		{
+			cr_assert_eq(RESULT_OK, push_front(list, '\0'));
+		}
+
+		/* volatile keeps calls from being merged */
+		volatile unsigned int counted = 0;
+		clock_t start = clock();
+		for(unsigned int i = 0; i < calls; ++i)
+		{
+			counted = count(list);
+		}
+		clock_t end = clock();
+		cr_assert_eq(length, counted);
+		cr_log_info("length %8d CPU ticks used: %9ld", length, (long)(end - start));
+	}
+	clear(list);
+	cr_assert_eq(0, count(list));
+}
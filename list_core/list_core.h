@@ -0,0 +1,309 @@
+#ifndef LIST_CORE_H_
+#define LIST_CORE_H_
+
+#include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#define RESULT_OK   0
+#define RESULT_NOK -1
+
+/* Algorithms of every list flavour, specialised at compile time by the
+ * layout of List, so a flavour pays only for what it keeps:
+ * - head, the first node or nullptr,
+ * - tail, optional, the last node, makes push_back() O(1),
+ * - size, optional, makes count() O(1),
+ * - prev in nodes, optional, makes the list doubly linked and pop_back() O(1).
+ * Nodes keep the element in data and their next pointer first.
+ *
+ * Nodes come from a Nodes object passed by value, which is empty for
+ * static pools and holds a reference to a stateful allocator otherwise:
+ *   Node* new_node(args...)  constructs data from args, nullptr when out
+ *                            of memory, links are set by the caller
+ *   void delete_node(Node*)
+ *   void delete_chain(Node*) optional, frees a nullptr terminated chain
+ * Flavours wrap it with their own API, C ones through extern "C".
+ */
+template <typename List>
+class ListCore {
+public:
+	using Node = std::remove_pointer_t<decltype(List::head)>;
+
+	static constexpr bool has_tail = requires(List& list) { list.tail; };
+	static constexpr bool has_size = requires(List& list) { list.size; };
+	static constexpr bool is_doubly = requires(Node& node) { node.prev; };
+
+	ListCore() = delete;
+
+	static void init(List& list) noexcept
+	{
+		list.head = nullptr;
+		if constexpr(has_tail) list.tail = nullptr;
+		if constexpr(has_size) list.size = 0;
+	}
+
+	template <typename Nodes, typename... Args>
+	static int push_front(List& list, Nodes nodes, Args&&... args)
+	{
+		auto new_p = nodes.new_node(std::forward<Args>(args)...);
+		if(!new_p) return RESULT_NOK;
+
+		link_after(list, nullptr, new_p);
+		return RESULT_OK;
+	}
+
+	template <typename Nodes, typename... Args>
+	static int push_back(List& list, Nodes nodes, Args&&... args)
+	{
+		auto new_p = nodes.new_node(std::forward<Args>(args)...);
+		if(!new_p) return RESULT_NOK;
+
+		link_after(list, last(list), new_p);
+		return RESULT_OK;
+	}
+
+	/* Data is moved out before anything is unlinked, so the list is
+	 * unchanged when that throws
+	 */
+	template <typename Nodes, typename Data>
+	static int pop_front(List& list, Nodes nodes, Data& data_storage)
+	{
+		if(!list.head) return RESULT_NOK;
+
+		data_storage = std::move(list.head->data);
+		nodes.delete_node(unlink_after(list, nullptr));
+		return RESULT_OK;
+	}
+
+	/* O(n) when singly linked, the new tail is searched from the head */
+	template <typename Nodes, typename Data>
+	static int pop_back(List& list, Nodes nodes, Data& data_storage)
+	{
+		if(!list.head) return RESULT_NOK;
+
+		auto prev_p = before_last(list);
+		data_storage = std::move((prev_p ? prev_p->next : list.head)->data);
+		nodes.delete_node(unlink_after(list, prev_p));
+		return RESULT_OK;
+	}
+
+	/* Nodes are chained by next, so with delete_chain the whole list
+	 * goes back at once
+	 */
+	template <typename Nodes>
+	static void clear(List& list, Nodes nodes) noexcept
+	{
+		if constexpr(requires { nodes.delete_chain(list.head); })
+		{
+			nodes.delete_chain(list.head);
+		}
+		else
+		{
+			while(list.head)
+			{
+				auto to_free_p = list.head;
+				list.head = list.head->next;
+				nodes.delete_node(to_free_p);
+			}
+		}
+		init(list);
+	}
+
+	/* O(1) with size, which every operation keeps up to date,
+	 * otherwise the list is walked
+	 */
+	static unsigned int count(const List& list) noexcept
+	{
+		if constexpr(has_size)
+		{
+#ifdef CHECK_COUNT
+			/* Cross-check the cached size and tail against a full walk */
+			assert(walk_count(list) == list.size);
+			if constexpr(has_tail) assert(walk_last(list) == list.tail);
+#endif
+			return list.size;
+		}
+		else
+		{
+			return walk_count(list);
+		}
+	}
+
+	/* pos_p is a node of the list or nullptr for the front
+	 * @return new node, nullptr when out of memory
+	 */
+	template <typename Nodes, typename... Args>
+	static Node* insert_after(List& list, Nodes nodes, Node* pos_p, Args&&... args)
+	{
+		auto new_p = nodes.new_node(std::forward<Args>(args)...);
+		if(!new_p) return nullptr;
+
+		link_after(list, pos_p, new_p);
+		return new_p;
+	}
+
+	/* pos_p is a node of the list or nullptr for the front,
+	 * a node must follow it
+	 * @return node after the erased one
+	 */
+	template <typename Nodes>
+	static Node* erase_after(List& list, Nodes nodes, Node* pos_p)
+	{
+		auto to_free_p = unlink_after(list, pos_p);
+		auto next_p = to_free_p->next;
+		nodes.delete_node(to_free_p);
+		return next_p;
+	}
+
+	/* O(1) for doubly linked lists only, next_p is a node of the list
+	 * or nullptr for the end
+	 * @return new node, nullptr when out of memory
+	 */
+	template <typename Nodes, typename... Args>
+	static Node* insert(List& list, Nodes nodes, Node* next_p, Args&&... args)
+		requires is_doubly && has_tail
+	{
+		return insert_after(list, nodes, next_p ? next_p->prev : list.tail,
+			std::forward<Args>(args)...);
+	}
+
+	/* @return node after the erased one */
+	template <typename Nodes>
+	static Node* erase(List& list, Nodes nodes, Node* node_p) requires is_doubly
+	{
+		return erase_after(list, nodes, node_p->prev);
+	}
+
+private:
+	static void link_after(List& list, Node* prev_p, Node* new_p) noexcept
+	{
+		auto& next_p = prev_p ? prev_p->next : list.head;
+		new_p->next = next_p;
+		if constexpr(is_doubly)
+		{
+			new_p->prev = prev_p;
+			if(next_p) next_p->prev = new_p;
+		}
+		if constexpr(has_tail)
+		{
+			if(list.tail == prev_p) list.tail = new_p;
+		}
+		next_p = new_p;
+		if constexpr(has_size) ++list.size;
+	}
+
+	/* @return unlinked node */
+	static Node* unlink_after(List& list, Node* prev_p) noexcept
+	{
+		auto& next_p = prev_p ? prev_p->next : list.head;
+		auto node_p = next_p;
+		next_p = node_p->next;
+		if constexpr(is_doubly)
+		{
+			if(next_p) next_p->prev = prev_p;
+		}
+		if constexpr(has_tail)
+		{
+			if(list.tail == node_p) list.tail = prev_p;
+		}
+		if constexpr(has_size) --list.size;
+		return node_p;
+	}
+
+	static Node* last(const List& list) noexcept
+	{
+		if constexpr(has_tail) return list.tail;
+		else return walk_last(list);
+	}
+
+	/* @return node before the last one, nullptr when there is one node only */
+	static Node* before_last(const List& list) noexcept
+	{
+		if constexpr(is_doubly && has_tail)
+		{
+			return list.tail->prev;
+		}
+		else
+		{
+			Node* prev_p = nullptr;
+			for(auto node_p = list.head; node_p->next; node_p = node_p->next)
+			{
+				prev_p = node_p;
+			}
+			return prev_p;
+		}
+	}
+
+	static Node* walk_last(const List& list) noexcept
+	{
+		Node* last_p = nullptr;
+		for(auto node_p = list.head; node_p; node_p = node_p->next)
+		{
+			last_p = node_p;
+		}
+		return last_p;
+	}
+
+	static unsigned int walk_count(const List& list) noexcept
+	{
+		unsigned int elements_c = 0;
+		for(auto node_p = list.head; node_p; node_p = node_p->next)
+		{
+			++elements_c;
+		}
+		return elements_c;
+	}
+};
+
+/* Nodes from Pool with static alloc(), free() and free_chain(),
+ * like NodePool<Node>
+ */
+template <typename Node, typename Pool>
+struct PoolNodes {
+	template <typename... Args>
+	static Node* new_node(Args&&... args)
+	{
+		auto new_p = Pool::alloc();
+		if(!new_p) return nullptr;
+
+		if constexpr(std::is_nothrow_constructible_v<decltype(new_p->data), Args...>)
+		{
+			std::construct_at(std::addressof(new_p->data), std::forward<Args>(args)...);
+		}
+		else
+		{
+			try
+			{
+				std::construct_at(std::addressof(new_p->data), std::forward<Args>(args)...);
+			}
+			catch(...)
+			{
+				Pool::free(new_p);
+				throw;
+			}
+		}
+		return new_p;
+	}
+
+	static void delete_node(Node* node_p) noexcept
+	{
+		std::destroy_at(std::addressof(node_p->data));
+		Pool::free(node_p);
+	}
+
+	static void delete_chain(Node* head_p) noexcept
+	{
+		if constexpr(!std::is_trivially_destructible_v<decltype(head_p->data)>)
+		{
+			for(auto node_p = head_p; node_p; node_p = node_p->next)
+			{
+				std::destroy_at(std::addressof(node_p->data));
+			}
+		}
+		Pool::free_chain(head_p);
+	}
+};
+
+#endif /* LIST_CORE_H_ */
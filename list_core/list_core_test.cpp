@@ -0,0 +1,345 @@
+#include <time.h>
+#include <cstdint>
+#include <deque>
+#include <forward_list>
+#include <new>
+#include <criterion.h>
+#include "list_core.h"
+
+struct snode
+{
+	struct snode* next;
+	int data;
+};
+
+struct dnode
+{
+	struct dnode* next;
+	struct dnode* prev;
+	int data;
+};
+
+/* Every combination of what a list may keep */
+template <typename Node>
+struct HeadOnly
+{
+	Node* head;
+};
+
+template <typename Node>
+struct WithTail
+{
+	Node* head;
+	Node* tail;
+};
+
+template <typename Node>
+struct WithSize
+{
+	Node* head;
+	unsigned int size;
+};
+
+template <typename Node>
+struct WithBoth
+{
+	Node* head;
+	Node* tail;
+	unsigned int size;
+};
+
+static_assert(!ListCore<HeadOnly<snode>>::has_tail && !ListCore<HeadOnly<snode>>::has_size);
+static_assert(ListCore<WithTail<snode>>::has_tail && !ListCore<WithTail<snode>>::has_size);
+static_assert(!ListCore<WithSize<snode>>::has_tail && ListCore<WithSize<snode>>::has_size);
+static_assert(!ListCore<WithBoth<snode>>::is_doubly && ListCore<WithBoth<dnode>>::is_doubly);
+/* Policies cost nothing they don't use */
+static_assert(sizeof(HeadOnly<snode>) == sizeof(snode*));
+
+/* Nodes from new, counted to find leaked or doubly freed ones */
+template <typename Node>
+struct NewNodes {
+	static inline int live_c = 0;
+
+	static Node* new_node(int data)
+	{
+		auto new_p = new(std::nothrow) Node;
+		if(!new_p) return nullptr;
+		new_p->data = data;
+		++live_c;
+		return new_p;
+	}
+
+	static void delete_node(Node* node_p)
+	{
+		--live_c;
+		delete node_p;
+	}
+};
+
+/* Same with a free list, so benchmarks measure links rather than malloc */
+template <typename Node>
+struct FreeListNodes {
+	static inline Node* free_p = nullptr;
+
+	static Node* new_node(int data)
+	{
+		auto new_p = free_p;
+		if(new_p) free_p = new_p->next;
+		else new_p = new(std::nothrow) Node;
+		if(!new_p) return nullptr;
+		new_p->data = data;
+		return new_p;
+	}
+
+	static void delete_node(Node* node_p)
+	{
+		node_p->next = free_p;
+		free_p = node_p;
+	}
+
+	static void delete_chain(Node* head_p)
+	{
+		if(!head_p) return;
+		auto last_p = head_p;
+		while(last_p->next) last_p = last_p->next;
+		last_p->next = free_p;
+		free_p = head_p;
+	}
+};
+
+/* Keys of randomised tests, same sequence every run */
+static std::uint32_t next_random(std::uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+/* Walks links both ways and compares them with expected */
+template <typename List>
+static void assert_equal(const List& list, const std::deque<int>& expected)
+{
+	using Core = ListCore<List>;
+	typename Core::Node* prev_p = nullptr;
+	auto node_p = list.head;
+	for(int data : expected)
+	{
+		cr_assert_not_null(node_p);
+		cr_assert_eq(data, node_p->data);
+		if constexpr(Core::is_doubly) cr_assert_eq(prev_p, node_p->prev);
+		prev_p = node_p;
+		node_p = node_p->next;
+	}
+	cr_assert_null(node_p);
+	if constexpr(Core::has_tail) cr_assert_eq(prev_p, list.tail);
+	cr_assert_eq(expected.size(), Core::count(list));
+}
+
+/* Same random operations on std::deque must leave the same elements */
+template <typename List>
+static void check_against_deque()
+{
+	using Core = ListCore<List>;
+	using Nodes = NewNodes<typename Core::Node>;
+	List list;
+	Core::init(list);
+	std::deque<int> expected;
+	std::uint32_t state = 1;
+
+	for(int i = 0; i < 20000; ++i)
+	{
+		int data = 0;
+		switch(next_random(state) % 6)
+		{
+		case 0:
+			cr_assert_eq(RESULT_OK, Core::push_front(list, Nodes{}, i));
+			expected.push_front(i);
+			break;
+		case 1:
+			cr_assert_eq(RESULT_OK, Core::push_back(list, Nodes{}, i));
+			expected.push_back(i);
+			break;
+		case 2:
+			cr_assert_eq(expected.empty() ? RESULT_NOK : RESULT_OK,
+				Core::pop_front(list, Nodes{}, data));
+			if(!expected.empty())
+			{
+				cr_assert_eq(expected.front(), data);
+				expected.pop_front();
+			}
+			break;
+		case 3:
+			cr_assert_eq(expected.empty() ? RESULT_NOK : RESULT_OK,
+				Core::pop_back(list, Nodes{}, data));
+			if(!expected.empty())
+			{
+				cr_assert_eq(expected.back(), data);
+				expected.pop_back();
+			}
+			break;
+		default:
+		{
+			/* Insert after or erase after a random position, front included */
+			unsigned int index = next_random(state) % (expected.size() + 1);
+			typename Core::Node* pos_p = nullptr;
+			for(unsigned int j = 0; j < index; ++j)
+			{
+				pos_p = pos_p ? pos_p->next : list.head;
+			}
+			if(index < expected.size() && next_random(state) % 2)
+			{
+				auto next_p = Core::erase_after(list, Nodes{}, pos_p);
+				expected.erase(expected.begin() + index);
+				if(index < expected.size()) cr_assert_eq(expected[index], next_p->data);
+				else cr_assert_null(next_p);
+			}
+			else
+			{
+				auto new_p = Core::insert_after(list, Nodes{}, pos_p, i);
+				cr_assert_not_null(new_p);
+				expected.insert(expected.begin() + index, i);
+			}
+			break;
+		}
+		}
+		if(i % 1000 == 0) assert_equal(list, expected);
+	}
+	assert_equal(list, expected);
+
+	Core::clear(list, Nodes{});
+	cr_assert_null(list.head);
+	cr_assert_eq(0, Core::count(list));
+	cr_assert_eq(0, Nodes::live_c);
+}
+
+Test(list_core_suite, singly_linked_layouts)
+{
+	check_against_deque<HeadOnly<snode>>();
+	check_against_deque<WithTail<snode>>();
+	check_against_deque<WithSize<snode>>();
+	check_against_deque<WithBoth<snode>>();
+}
+
+Test(list_core_suite, doubly_linked_layouts)
+{
+	check_against_deque<HeadOnly<dnode>>();
+	check_against_deque<WithSize<dnode>>();
+	check_against_deque<WithBoth<dnode>>();
+}
+
+Test(list_core_suite, insert_and_erase_at_node)
+{
+	using Core = ListCore<WithBoth<dnode>>;
+	using Nodes = NewNodes<dnode>;
+	WithBoth<dnode> list;
+	Core::init(list);
+
+	/* Inserting before the end appends */
+	auto b_p = Core::insert(list, Nodes{}, nullptr, 'b');
+	auto a_p = Core::insert(list, Nodes{}, b_p, 'a');
+	auto d_p = Core::insert(list, Nodes{}, nullptr, 'd');
+	Core::insert(list, Nodes{}, d_p, 'c');
+	assert_equal(list, {'a', 'b', 'c', 'd'});
+
+	cr_assert_eq(b_p, Core::erase(list, Nodes{}, a_p));
+	cr_assert_null(Core::erase(list, Nodes{}, d_p));
+	assert_equal(list, {'b', 'c'});
+
+	Core::clear(list, Nodes{});
+	cr_assert_eq(0, Nodes::live_c);
+}
+
+Test(list_core_suite, clear_gives_chain_back)
+{
+	using Core = ListCore<WithBoth<snode>>;
+	using Nodes = FreeListNodes<snode>;
+	WithBoth<snode> list;
+	Core::init(list);
+	for(int i = 0; i < 3; ++i)
+	{
+		cr_assert_eq(RESULT_OK, Core::push_back(list, Nodes{}, i));
+	}
+	auto head_p = list.head;
+	Core::clear(list, Nodes{});
+	assert_equal(list, {});
+	cr_assert_eq(head_p, Nodes::free_p);
+}
+
+/* push_back and pop_back of length elements, then count calls */
+template <typename List>
+static void measure_layout(const char* name, unsigned int length)
+{
+	using Core = ListCore<List>;
+	using Nodes = FreeListNodes<typename Core::Node>;
+	List list;
+	Core::init(list);
+
+	clock_t start = clock();
+	for(unsigned int i = 0; i < length; ++i)
+	{
+		cr_assert_eq(RESULT_OK, Core::push_back(list, Nodes{}, i));
+	}
+	/* volatile keeps calls from being merged */
+	volatile unsigned int counted = 0;
+	for(unsigned int i = 0; i < length; ++i)
+	{
+		counted = Core::count(list);
+	}
+	cr_assert_eq(length, counted);
+	int data;
+	while(Core::pop_back(list, Nodes{}, data) == RESULT_OK);
+	clock_t end = clock();
+	cr_log_info("%-12s CPU ticks used: %9ld", name, (long)(end - start));
+}
+
+Test(list_core_suite, time_measurements, .disabled = false)
+{
+	const unsigned int length = 10000;
+
+	cr_log_info("Measure cycles for push_back, count and pop_back "
+		"of %d elements by layout:", length);
+	measure_layout<HeadOnly<snode>>("head", length);
+	measure_layout<WithTail<snode>>("head, tail", length);
+	measure_layout<WithSize<snode>>("head, size", length);
+	measure_layout<WithBoth<snode>>("all", length);
+	measure_layout<WithBoth<dnode>>("all, doubly", length);
+
+	const unsigned int elements_c = 10000000;
+	cr_log_info("Measure cycles for push_front and pop_front "
+		"of %d elements:", elements_c);
+	using Core = ListCore<WithBoth<snode>>;
+	using Nodes = NewNodes<snode>;
+	WithBoth<snode> list;
+	Core::init(list);
+	int data;
+	/* First touch of the heap costs page faults, the first round
+	 * is not timed so that both see reused memory
+	 */
+	for(unsigned int round = 0; round < 2; ++round)
+	{
+		clock_t start = clock();
+		for(unsigned int i = 0; i < elements_c; ++i)
+		{
+			cr_assert_eq(RESULT_OK, Core::push_front(list, Nodes{}, i));
+		}
+		while(Core::pop_front(list, Nodes{}, data) == RESULT_OK);
+		clock_t end = clock();
+		if(round) cr_log_info("ListCore          CPU ticks used: %9ld", (long)(end - start));
+	}
+
+	/* Both take every node from new, it keeps neither tail nor size */
+	std::forward_list<int> forward_list;
+	clock_t start = clock();
+	for(unsigned int i = 0; i < elements_c; ++i)
+	{
+		forward_list.push_front(i);
+	}
+	while(!forward_list.empty())
+	{
+		data = forward_list.front();
+		forward_list.pop_front();
+	}
+	clock_t end = clock();
+	cr_log_info("std::forward_list CPU ticks used: %9ld", (long)(end - start));
+}
@@ -0,0 +1,239 @@
+#ifndef NODE_POOL_H_
+#define NODE_POOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/* Slab allocator of nodes with a free list cache per thread.
+ * Free nodes are chained through their first bytes, so a whole list of
+ * nodes starting with their next pointer goes back to the pool in O(1).
+ */
+template <typename Node>
+class NodePool {
+public:
+	static constexpr std::size_t slab_nodes = 1024;
+	/* Chains kept by one thread before half of them go to the shared stack */
+	static constexpr std::size_t cache_chains = 64;
+	/* Net number of single frees kept by one thread before giving back */
+	static constexpr std::size_t cache_nodes = 4096;
+	static constexpr std::size_t refill_chains = 8;
+
+	NodePool() = delete;
+
+	/* @return uninitialised storage for a node or nullptr when out of memory */
+	static Node* alloc()
+	{
+		auto& cache = get_cache();
+		if(!cache.chains_c && !cache.refill()) return nullptr;
+
+		auto& top_p = cache.chains[cache.chains_c - 1];
+		auto link_p = top_p;
+		top_p = link_p->next;
+		if(!top_p) --cache.chains_c;
+		if(cache.net_frees) --cache.net_frees;
+		return reinterpret_cast<Node*>(link_p);
+	}
+
+	static void free(Node* node_p)
+	{
+		if(!node_p) return;
+
+		auto& cache = get_cache();
+		auto link_p = reinterpret_cast<Link*>(node_p);
+		if(cache.chains_c)
+		{
+			link_p->next = cache.chains[cache.chains_c - 1];
+			cache.chains[cache.chains_c - 1] = link_p;
+		}
+		else
+		{
+			link_p->next = nullptr;
+			cache.chains[cache.chains_c++] = link_p;
+		}
+
+		/* A thread only freeing nodes allocated by others would grow forever */
+		if(++cache.net_frees >= cache_nodes)
+		{
+			cache.give_back(1);
+			cache.net_frees = 0;
+		}
+	}
+
+	/* Gives back a whole nullptr terminated chain of nodes in O(1),
+	 * next pointer must be the first member of Node
+	 */
+	static void free_chain(Node* head_p)
+	{
+		if(!head_p) return;
+
+		auto& cache = get_cache();
+		if(cache.chains_c == cache_chains)
+		{
+			cache.give_back(cache_chains / 2);
+		}
+		cache.chains[cache.chains_c++] = reinterpret_cast<Link*>(head_p);
+	}
+
+	/* @return number of slabs allocated so far */
+	static std::size_t slabs_count()
+	{
+		auto& shared = get_shared();
+		std::lock_guard<std::mutex> guard(shared.lock);
+		return shared.slabs.size();
+	}
+
+private:
+	struct Link {
+		Link* next;
+	};
+
+	/* Nodes too small to hold a link are spaced as links */
+	static constexpr std::size_t node_size =
+		sizeof(Node) < sizeof(Link) ? sizeof(Link) : sizeof(Node);
+
+	/* Chains given back by threads and every slab, freed at exit */
+	struct Shared {
+		std::mutex lock;
+		std::vector<Link*> chains;
+		std::vector<void*> slabs;
+
+		~Shared()
+		{
+			for(auto slab_p : slabs) ::operator delete(slab_p);
+		}
+
+		/* Must be called with lock held */
+		void push(Link* chain_p)
+		{
+			try
+			{
+				chains.push_back(chain_p);
+			}
+			catch(const std::bad_alloc&)
+			{
+				/* No room for another chain, append it to the last one */
+				if(chains.empty()) return;
+				auto tail_p = chain_p;
+				while(tail_p->next) tail_p = tail_p->next;
+				tail_p->next = chains.back();
+				chains.back() = chain_p;
+			}
+		}
+	};
+
+	/* Free nodes of one thread: a stack of nullptr terminated chains.
+	 * Nodes are taken from the top chain and single frees are prepended to it.
+	 */
+	struct Cache {
+		Link* chains[cache_chains];
+		std::size_t chains_c = 0;
+		std::size_t net_frees = 0;
+
+		/* Shared state is constructed first, so it outlives every cache */
+		Cache() { get_shared(); }
+		~Cache() { give_back(chains_c); }
+
+		/* Moves top chains_num chains to the shared stack */
+		void give_back(std::size_t chains_num)
+		{
+			auto& shared = get_shared();
+			std::lock_guard<std::mutex> guard(shared.lock);
+			while(chains_num-- && chains_c)
+			{
+				shared.push(chains[--chains_c]);
+			}
+		}
+
+		/* Takes chains given back by other threads, or carves a new slab
+		 * @return false when out of memory
+		 */
+		bool refill()
+		{
+			auto& shared = get_shared();
+			std::lock_guard<std::mutex> guard(shared.lock);
+			while(!shared.chains.empty() && chains_c < refill_chains)
+			{
+				chains[chains_c++] = shared.chains.back();
+				shared.chains.pop_back();
+			}
+			if(chains_c) return true;
+
+			auto slab_p = static_cast<char*>(
+				::operator new(slab_nodes * node_size, std::nothrow));
+			if(!slab_p) return false;
+			try
+			{
+				shared.slabs.push_back(slab_p);
+			}
+			catch(const std::bad_alloc&)
+			{
+				::operator delete(slab_p);
+				return false;
+			}
+
+			for(std::size_t i = 0; i < slab_nodes; ++i)
+			{
+				auto link_p = reinterpret_cast<Link*>(slab_p + i * node_size);
+				link_p->next = (i + 1 < slab_nodes) ?
+					reinterpret_cast<Link*>(slab_p + (i + 1) * node_size) : nullptr;
+			}
+			chains[chains_c++] = reinterpret_cast<Link*>(slab_p);
+			return true;
+		}
+	};
+
+	static Shared& get_shared()
+	{
+		static Shared shared;
+		return shared;
+	}
+
+	static Cache& get_cache()
+	{
+		thread_local Cache cache;
+		return cache;
+	}
+};
+
+/* Standard allocator taking single objects from NodePool, so containers
+ * rebinding it to their node type get pooled nodes
+ */
+template <typename T>
+struct PoolAllocator {
+	using value_type = T;
+
+	PoolAllocator() noexcept = default;
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+	T* allocate(std::size_t n)
+	{
+		if(n != 1) return static_cast<T*>(::operator new(n * sizeof(T)));
+
+		auto p = NodePool<T>::alloc();
+		if(!p) throw std::bad_alloc();
+		return p;
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		if(n != 1) ::operator delete(p);
+		else NodePool<T>::free(p);
+	}
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept
+{
+	return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept
+{
+	return false;
+}
+
+#endif /* NODE_POOL_H_ */
@@ -0,0 +1,169 @@
+#include <time.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <criterion.h>
+#include "list_core.h"
+#include "node_pool.h"
+
+constexpr unsigned int threads_num = 4;
+
+struct test_node
+{
+	struct test_node* next;
+	unsigned long value;
+};
+
+Test(node_pool_suite, freed_node_is_reused)
+{
+	auto first_p = NodePool<test_node>::alloc();
+	cr_assert_neq(nullptr, first_p);
+	NodePool<test_node>::free(first_p);
+	auto second_p = NodePool<test_node>::alloc();
+	cr_assert_eq(first_p, second_p);
+	NodePool<test_node>::free(second_p);
+}
+
+/* List laid out like every flavour's, with the pool they share */
+struct char_node
+{
+	struct char_node* next;
+	char data;
+};
+
+struct char_list
+{
+	struct char_node* head;
+	struct char_node* tail;
+};
+
+Test(node_pool_suite, clear_returns_list_to_pool)
+{
+	using Core = ListCore<char_list>;
+	using Nodes = PoolNodes<char_node, NodePool<char_node>>;
+	const unsigned int count = 5 * NodePool<char_node>::slab_nodes;
+
+	char_list list;
+	Core::init(list);
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, Core::push_front(list, Nodes{}, '\0'));
+	}
+	auto slabs_c = NodePool<char_node>::slabs_count();
+	Core::clear(list, Nodes{});
+	cr_assert_eq(0, Core::count(list));
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		cr_assert_eq(RESULT_OK, Core::push_front(list, Nodes{}, '\0'));
+	}
+	cr_assert_eq(slabs_c, NodePool<char_node>::slabs_count());
+	Core::clear(list, Nodes{});
+}
+
+/* Every thread keeps depth nodes alive, checks nobody else touched them
+ * @return number of corrupted or missing nodes
+ */
+static unsigned int pool_churn(unsigned long id, unsigned int rounds, unsigned int depth)
+{
+	unsigned int errors_c = 0;
+	for(unsigned int round = 0; round < rounds; ++round)
+	{
+		test_node* head_p = nullptr;
+		for(unsigned int i = 0; i < depth; ++i)
+		{
+			auto new_p = NodePool<test_node>::alloc();
+			if(!new_p)
+			{
+				++errors_c;
+				break;
+			}
+			new_p->value = id;
+			new_p->next = head_p;
+			head_p = new_p;
+		}
+		for(auto node_p = head_p; node_p; node_p = node_p->next)
+		{
+			if(node_p->value != id) ++errors_c;
+		}
+		/* Give back alternately one by one and as a whole */
+		if(round % 2)
+		{
+			NodePool<test_node>::free_chain(head_p);
+			continue;
+		}
+		while(head_p)
+		{
+			auto to_free = head_p;
+			head_p = head_p->next;
+			NodePool<test_node>::free(to_free);
+		}
+	}
+	return errors_c;
+}
+
+static unsigned int new_churn(unsigned long id, unsigned int rounds, unsigned int depth)
+{
+	for(unsigned int round = 0; round < rounds; ++round)
+	{
+		test_node* head_p = nullptr;
+		for(unsigned int i = 0; i < depth; ++i)
+		{
+			auto new_p = new test_node;
+			new_p->value = id;
+			new_p->next = head_p;
+			head_p = new_p;
+		}
+		while(head_p)
+		{
+			auto to_free = head_p;
+			head_p = head_p->next;
+			delete to_free;
+		}
+	}
+	return 0;
+}
+
+/* @return wall clock milliseconds of running churn in threads_num threads */
+static long long run_threads(unsigned int (*churn)(unsigned long, unsigned int, unsigned int),
+	unsigned int rounds, unsigned int depth)
+{
+	std::vector<std::thread> threads;
+	std::vector<unsigned int> errors(threads_num);
+	auto start = std::chrono::steady_clock::now();
+	for(unsigned int i = 0; i < threads_num; ++i)
+	{
+		threads.emplace_back([&, i] { errors[i] = churn(i + 1, rounds, depth); });
+	}
+	for(auto& thread : threads) thread.join();
+	auto end = std::chrono::steady_clock::now();
+	for(auto errors_c : errors) cr_assert_eq(0, errors_c);
+	return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+Test(node_pool_suite, threads_stress)
+{
+	run_threads(pool_churn, 200, 3 * NodePool<test_node>::slab_nodes);
+}
+
+Test(node_pool_suite, time_measurements, .disabled = false)
+{
+	const unsigned int rounds = 10000;
+	const unsigned int depth = 1000;
+
+	cr_log_info("Measure cycles for %d rounds of allocating and freeing "
+			    "%d nodes:", rounds, depth);
+	clock_t start = clock();
+	cr_assert_eq(0, pool_churn(1, rounds, depth));
+	clock_t end = clock();
+	cr_log_info("node pool  CPU ticks used: %9ld", (long)(end - start));
+
+	start = clock();
+	new_churn(1, rounds, depth);
+	end = clock();
+	cr_log_info("new/delete CPU ticks used: %9ld", (long)(end - start));
+
+	cr_log_info("Measure wall clock of the same churn in %d threads:", threads_num);
+	cr_log_info("node pool  ms: %9lld", run_threads(pool_churn, rounds, depth));
+	cr_log_info("new/delete ms: %9lld", run_threads(new_churn, rounds, depth));
+}
@@ -0,0 +1,402 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "algos.h"
+#include "../heap/heap.h"
+#include "../prof/prof.h"
+#include "../sample/sample_sort.h"
+
+#define SWAP_BUF_SIZE 64U
+
+static void swap(void* a, void* b, size_t size)
+{
+    /* For comparing complexity */
+    PROF_INC(PROF_SWAPS);
+
+    /* Swap in chunks through the stack, no malloc on the hot path */
+    char tmp[SWAP_BUF_SIZE];
+    while(size)
+    {
+        size_t chunk = size < SWAP_BUF_SIZE ? size : SWAP_BUF_SIZE;
+        memcpy(tmp, a, chunk);
+        memcpy(a, b, chunk);
+        memcpy(b, tmp, chunk);
+        a += chunk;
+        b += chunk;
+        size -= chunk;
+    }
+}
+
+void bubble_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    bool rerun_flag = true;
+    size_t num_in_position = 0;
+    size_t rerun_idx = 0;
+
+    while(rerun_flag)
+    {
+        rerun_flag = false;
+        for(size_t c = rerun_idx; c + 1 < nmemb - num_in_position; ++c)
+        {
+            if(compar(base + c * size, base + (c + 1) * size) > 0)
+            {
+                swap(base + c * size, base + (c + 1) * size, size);
+                // no point to rerun if we swapped only 1st elem
+                if(c > 0)
+                {
+                    // skip non-modified elements in front next time
+                    if(!rerun_flag) rerun_idx = c - 1;
+                    rerun_flag = true;
+                }
+            }
+        }
+        // each loop shifts next largest element to the final position
+        ++num_in_position;
+    }
+}
+
+void insertion_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    /* Take first element from the unsorted part (i to nmemb - 1) */
+    for(size_t i = 1; i < nmemb; ++i)
+    {
+        /* Compare it with elements of the sorted part (i - 1 to 0) */
+        for(size_t j = i; j > 0; --j)
+        {
+            if(compar(base + (j - 1) * size, base + j * size) > 0)
+            {
+                /* Shift it before larger element of the sorted array */
+                swap(base + (j - 1) * size, base + j * size, size);
+            }
+            else
+            {
+                /* The element is in the right place now */
+                break;
+            }
+        }
+    }
+}
+
+static size_t find_smallest_lin(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    size_t smallest_idx = 0;
+    for(size_t idx = 1; idx < nmemb; ++idx)
+    {
+        /* New smallest? */
+        if(compar(base + idx * size, base + smallest_idx * size) < 0)
+        {
+            smallest_idx = idx;
+        }
+    }
+
+    return smallest_idx;
+}
+
+void selection_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    /* idx + 1 as there must be at least one more element to compare */
+    for(size_t idx = 0; idx + 1 < nmemb; ++idx)
+    {
+        /* Find smallest element in the sub-array  */
+        size_t smallest_idx =
+            idx + find_smallest_lin(base + idx * size, nmemb - idx, size, compar);
+        if(idx == smallest_idx) continue;
+        swap(base + idx * size, base + smallest_idx * size, size);
+    }
+}
+
+static void merge(void* base, size_t numa, size_t numb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    void* merged_p = malloc((numa + numb) * size);
+    void* a = base;
+    void* b = base + numa * size;
+    size_t idxa = 0;
+    size_t idxb = 0;
+
+    for(size_t i = 0; i < numa + numb; ++i)
+    {
+        /* For comparing complexity, merge moves instead of swapping */
+        PROF_INC(PROF_MOVES);
+
+        if(numa - idxa == 0)
+        {
+            // no more items in "a"
+            memcpy(merged_p + i * size, b + idxb * size, size);
+            ++idxb;
+            continue;
+        }
+
+        if(numb - idxb == 0)
+        {
+            // no more items in "b"
+            memcpy(merged_p + i * size, a + idxa * size, size);
+            ++idxa;
+            continue;
+        }
+
+        /* Take "a" on ties, so equal elements keep their order */
+        if(compar(a + idxa * size, b + idxb * size) <= 0)
+        {
+            memcpy(merged_p + i * size, a + idxa * size, size);
+            ++idxa;
+        }
+        else
+        {
+            memcpy(merged_p + i * size, b + idxb * size, size);
+            ++idxb;
+        }
+    }
+
+    memcpy(base, merged_p, (numa + numb) * size);
+    free(merged_p);
+}
+
+void merge_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    if(nmemb > 2)
+    {
+        merge_sort(base, nmemb - nmemb / 2, size, compar);
+        merge_sort(base + (nmemb - nmemb / 2) * size, nmemb / 2, size, compar);
+    }
+
+    merge(base,
+          nmemb - nmemb / 2,
+          nmemb / 2,
+          size,
+          compar);
+}
+
+/* Same as merge(), but halves don't have to be adjacent and an element
+ * of "b" equal to the current one of "a" is dropped. Halves have no
+ * duplicates themselves, so the result has none either.
+ * @return number of elements left in base
+ */
+static size_t merge_unique(void* base, size_t numa, void* b, size_t numb,
+    size_t size, int (*compar)(const void*, const void*))
+{
+    void* merged_p = malloc((numa + numb) * size);
+    void* a = base;
+    size_t idxa = 0;
+    size_t idxb = 0;
+    size_t merged = 0;
+
+    while(idxa < numa || idxb < numb)
+    {
+        /* For comparing complexity, merge moves instead of swapping */
+        PROF_INC(PROF_MOVES);
+
+        int result;
+        if(numa - idxa == 0) result = 1;        // no more items in "a"
+        else if(numb - idxb == 0) result = -1;  // no more items in "b"
+        else result = compar(a + idxa * size, b + idxb * size);
+
+        if(result <= 0)
+        {
+            memcpy(merged_p + merged * size, a + idxa * size, size);
+            ++idxa;
+            // skip the duplicate in "b"
+            if(result == 0) ++idxb;
+        }
+        else
+        {
+            memcpy(merged_p + merged * size, b + idxb * size, size);
+            ++idxb;
+        }
+        ++merged;
+    }
+
+    memcpy(base, merged_p, merged * size);
+    free(merged_p);
+    return merged;
+}
+
+/* @return number of unique elements, sorted in front of base
+ */
+size_t merge_sort_unique(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    if(nmemb < 2) return nmemb;
+
+    size_t half = nmemb - nmemb / 2;
+    size_t numa = merge_sort_unique(base, half, size, compar);
+    size_t numb = merge_sort_unique(base + half * size, nmemb / 2, size, compar);
+
+    return merge_unique(base, numa, base + half * size, numb, size, compar);
+}
+
+/* Cheap stateless hash, so pivot positions are spread pseudo-randomly */
+static size_t pivot_hash(const void* base, size_t nmemb, size_t salt)
+{
+    uint64_t z = (uintptr_t)base ^ ((uint64_t)nmemb << 16) ^ (salt * 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (size_t)(z ^ (z >> 31));
+}
+
+/* Moves median of three pseudo-randomly picked elements to the front.
+ * Fixed positions (first, middle, last) degrade to quadratic time,
+ * as the partitioning below reorders presorted runs in a regular way.
+ */
+static void median_to_front(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    void* first = base + (pivot_hash(base, nmemb, 1) % nmemb) * size;
+    void* mid = base + (pivot_hash(base, nmemb, 2) % nmemb) * size;
+    void* last = base + (pivot_hash(base, nmemb, 3) % nmemb) * size;
+
+    void* median;
+    if(compar(first, mid) < 0)
+    {
+        if(compar(mid, last) < 0) median = mid;
+        else median = compar(first, last) < 0 ? last : first;
+    }
+    else
+    {
+        if(compar(first, last) < 0) median = first;
+        else median = compar(mid, last) < 0 ? last : mid;
+    }
+
+    if(median != base) swap(base, median, size);
+}
+
+/* Dutch national flag partitioning (Dijkstra) around the first element
+ * Sets [0, lt) less than pivot, [lt, gt) equal and [gt, nmemb) greater.
+ */
+static void partition3(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*), size_t* lt_p, size_t* gt_p)
+{
+    median_to_front(base, nmemb, size, compar);
+
+    /* Element under lt is always the first one equal to pivot */
+    size_t lt = 0;
+    size_t idx = 1;
+    size_t gt = nmemb;
+    while(idx < gt)
+    {
+        int result = compar(base + idx * size, base + lt * size);
+        if(result < 0)
+        {
+            swap(base + lt * size, base + idx * size, size);
+            ++lt;
+            ++idx;
+        }
+        else if(result > 0)
+        {
+            --gt;
+            swap(base + idx * size, base + gt * size, size);
+        }
+        else
+        {
+            ++idx;
+        }
+    }
+
+    *lt_p = lt;
+    *gt_p = gt;
+}
+
+void quick3_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    while(nmemb > 1)
+    {
+        size_t lt, gt;
+        partition3(base, nmemb, size, compar, &lt, &gt);
+
+        /* Equal run is in place already. Recurse into the smaller side
+         * and loop on the larger one, so stack depth stays logarithmic.
+         */
+        if(lt < nmemb - gt)
+        {
+            quick3_sort(base, lt, size, compar);
+            base += gt * size;
+            nmemb -= gt;
+        }
+        else
+        {
+            quick3_sort(base + gt * size, nmemb - gt, size, compar);
+            nmemb = lt;
+        }
+    }
+}
+
+/* Keeps one element of each equal run found by partitioning. Like
+ * quick3_sort() it recurses into the smaller side only. Unique elements
+ * of a smaller left side are packed after those already in front, of a
+ * smaller right side before those already at the back, so the larger
+ * side stays between both and is looped on.
+ * @return number of unique elements, sorted in front of base
+ */
+size_t quick3_sort_unique(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    void* front = base;
+    void* back = base + nmemb * size;
+    size_t front_c = 0;
+    size_t back_c = 0;
+    while(nmemb > 1)
+    {
+        size_t lt, gt;
+        partition3(base, nmemb, size, compar, &lt, &gt);
+
+        if(lt < nmemb - gt)
+        {
+            size_t num = quick3_sort_unique(base, lt, size, compar);
+            PROF_ADD(PROF_MOVES, num + 1);
+            memmove(front + front_c * size, base, num * size);
+            memmove(front + (front_c + num) * size, base + lt * size, size);
+            front_c += num + 1;
+            base += gt * size;
+            nmemb -= gt;
+        }
+        else
+        {
+            size_t num = quick3_sort_unique(base + gt * size, nmemb - gt, size, compar);
+            PROF_ADD(PROF_MOVES, num + 1);
+            back_c += num + 1;
+            memmove(back - (back_c - 1) * size, base + gt * size, num * size);
+            memmove(back - back_c * size, base + lt * size, size);
+            nmemb = lt;
+        }
+    }
+
+    /* Last element left in the middle, then the back closes the gap */
+    PROF_ADD(PROF_MOVES, nmemb + back_c);
+    memmove(front + front_c * size, base, nmemb * size);
+    front_c += nmemb;
+    memmove(front + front_c * size, back - back_c * size, back_c * size);
+
+    return front_c + back_c;
+}
+
+const struct algorithm algorithms[] =
+{
+    {'b', "bubble",    true,  bubble_sort,    NULL},
+    /* Swaps done inside stdlib can't be counted */
+    {'q', "quick",     false, qsort,          NULL},
+    {'i', "insertion", true,  insertion_sort, NULL},
+    {'s', "selection", false, selection_sort, NULL},
+    {'m', "merge",     true,  merge_sort,     merge_sort_unique},
+    {'h', "heap",      false, heap_sort,      NULL},
+    {'d', "quick3",    false, quick3_sort,    quick3_sort_unique},
+    {'p', "sample",    false, sample_sort,    NULL},
+};
+
+const size_t algorithms_num = sizeof(algorithms) / sizeof(algorithms[0]);
+
+const struct algorithm* algorithm_by_flag(char flag)
+{
+    for(size_t i = 0; i < algorithms_num; ++i)
+    {
+        if(algorithms[i].flag == flag) return &algorithms[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,46 @@
+#ifndef ALGOS_H_
+#define ALGOS_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef int (*compar_fn)(const void*, const void*);
+
+void bubble_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+void insertion_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+void selection_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+void merge_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+size_t merge_sort_unique(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+void quick3_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+size_t quick3_sort_unique(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+
+/* Algorithm selectable by a single letter flag of mysort */
+struct algorithm
+{
+    char flag;
+    const char* name;
+    /* Equal elements keep their relative order */
+    bool is_stable;
+    void (*sort)(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+    /* Drops duplicates while sorting, NULL if the algorithm can't.
+     * Stable ones keep the first of equal elements, the rest any of them.
+     */
+    size_t (*sort_unique)(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+};
+
+extern const struct algorithm algorithms[];
+extern const size_t algorithms_num;
+
+/* @return NULL for unknown flag */
+const struct algorithm* algorithm_by_flag(char flag);
+
+#endif /* ALGOS_H_ */
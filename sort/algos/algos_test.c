@@ -0,0 +1,217 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "algos.h"
+#include "../keys/keys.h"
+
+#define TRIALS      30U
+#define MAX_LINES   300U
+#define LINE_LEN    16U
+#define SEED        2022U
+
+struct sample
+{
+    char buf[MAX_LINES * LINE_LEN];
+    char* lines[MAX_LINES];
+    struct keyed_line recs[MAX_LINES];
+    struct key_arena arena;
+    size_t nmemb;
+};
+
+/* Lines "KEY IDX" sit in one buffer in their original order, as in mysort,
+ * few distinct keys make long runs of equal ones
+ */
+static void make_sample(struct sample* sample_p)
+{
+    sample_p->nmemb = rand() % (MAX_LINES + 1);
+    unsigned int keys = 1 + rand() % (sample_p->nmemb / 4 + 1);
+    for(size_t i = 0; i < sample_p->nmemb; ++i)
+    {
+        sample_p->lines[i] = sample_p->buf + i * LINE_LEN;
+        snprintf(sample_p->lines[i], LINE_LEN, "%u %zu", rand() % keys, i);
+    }
+
+    struct key_opts opts = {.field = 1, .is_numeric = true};
+    sample_p->arena.head_p = NULL;
+    cr_assert_eq(0, keys_build(sample_p->recs, sample_p->lines, sample_p->nmemb,
+        &opts, &sample_p->arena));
+}
+
+static size_t original_idx(const struct sample* sample_p, const char* line)
+{
+    return (line - sample_p->buf) / LINE_LEN;
+}
+
+/* Every line is present once, keys don't descend and equal keys keep
+ * original order of their lines
+ */
+static void check_sorted(const struct sample* sample_p, size_t nmemb,
+    bool is_stable, const char* name)
+{
+    bool seen[MAX_LINES] = {false};
+    for(size_t i = 0; i < nmemb; ++i)
+    {
+        size_t idx = original_idx(sample_p, sample_p->recs[i].line);
+        cr_assert_not(seen[idx], "%s: line %zu twice", name, idx);
+        seen[idx] = true;
+
+        if(i == 0) continue;
+        int result = keycmp(&sample_p->recs[i - 1], &sample_p->recs[i]);
+        cr_assert_leq(result, 0, "%s: not sorted at %zu", name, i);
+        if(is_stable && result == 0)
+        {
+            cr_assert_lt(sample_p->recs[i - 1].line, sample_p->recs[i].line,
+                "%s: not stable at %zu", name, i);
+        }
+    }
+}
+
+Test(algos_functionals, stable_mode_all_algorithms)
+{
+    srand(SEED);
+    for(size_t a = 0; a < algorithms_num; ++a)
+    {
+        const struct algorithm* alg_p = &algorithms[a];
+        for(unsigned int t = 0; t < TRIALS; ++t)
+        {
+            struct sample sample;
+            make_sample(&sample);
+
+            // same choice as mysort --stable does
+            alg_p->sort(sample.recs, sample.nmemb, sizeof(*sample.recs),
+                alg_p->is_stable ? keycmp : keycmp_stable);
+            check_sorted(&sample, sample.nmemb, true, alg_p->name);
+
+            key_arena_free(&sample.arena);
+        }
+    }
+}
+
+Test(algos_functionals, natively_stable_algorithms)
+{
+    srand(SEED + 1);
+    for(size_t a = 0; a < algorithms_num; ++a)
+    {
+        const struct algorithm* alg_p = &algorithms[a];
+        for(unsigned int t = 0; t < TRIALS; ++t)
+        {
+            struct sample sample;
+            make_sample(&sample);
+
+            // no tie breaking, stability has to come from the algorithm
+            alg_p->sort(sample.recs, sample.nmemb, sizeof(*sample.recs), keycmp);
+            check_sorted(&sample, sample.nmemb, alg_p->is_stable, alg_p->name);
+
+            key_arena_free(&sample.arena);
+        }
+    }
+}
+
+Test(algos_functionals, unique_variants)
+{
+    srand(SEED + 2);
+    for(size_t a = 0; a < algorithms_num; ++a)
+    {
+        const struct algorithm* alg_p = &algorithms[a];
+        if(!alg_p->sort_unique) continue;
+
+        for(unsigned int t = 0; t < TRIALS; ++t)
+        {
+            struct sample sample;
+            make_sample(&sample);
+
+            // first occurrence of every key, computed the slow way
+            bool is_first[MAX_LINES];
+            size_t unique_c = 0;
+            for(size_t i = 0; i < sample.nmemb; ++i)
+            {
+                is_first[i] = true;
+                for(size_t j = 0; j < i && is_first[i]; ++j)
+                {
+                    if(keycmp(&sample.recs[j], &sample.recs[i]) == 0) is_first[i] = false;
+                }
+                if(is_first[i]) ++unique_c;
+            }
+
+            size_t sorted = alg_p->sort_unique(sample.recs, sample.nmemb,
+                sizeof(*sample.recs), keycmp);
+            cr_assert_eq(sorted, unique_c, "%s: %zu != %zu", alg_p->name, sorted, unique_c);
+            for(size_t i = 1; i < sorted; ++i)
+            {
+                cr_assert_lt(keycmp(&sample.recs[i - 1], &sample.recs[i]), 0);
+            }
+
+            // stable ones keep the first of equal lines
+            for(size_t i = 0; alg_p->is_stable && i < sorted; ++i)
+            {
+                cr_assert(is_first[original_idx(&sample, sample.recs[i].line)]);
+            }
+
+            key_arena_free(&sample.arena);
+        }
+    }
+}
+
+static int compar_uint(const void* a, const void* b)
+{
+    unsigned int k1 = *(const unsigned int*)a;
+    unsigned int k2 = *(const unsigned int*)b;
+    return (k1 > k2) - (k1 < k2);
+}
+
+/* Ascending, descending and random keys make either side of a partition
+ * the smaller one, every key must come out once and in order
+ */
+Test(algos_functionals, unique_variants_shapes)
+{
+    const size_t nmemb = 1U << 16;
+    const unsigned int key_counts[] = {1, 2, 100, 1U << 16};
+    unsigned int* keys = malloc(nmemb * sizeof(*keys));
+    bool* is_present = malloc(nmemb * sizeof(*is_present));
+    cr_assert_not_null(keys);
+    cr_assert_not_null(is_present);
+
+    srand(SEED + 3);
+    for(size_t a = 0; a < algorithms_num; ++a)
+    {
+        const struct algorithm* alg_p = &algorithms[a];
+        if(!alg_p->sort_unique) continue;
+
+        for(size_t k = 0; k < sizeof(key_counts) / sizeof(key_counts[0]); ++k)
+        {
+            for(unsigned int shape = 0; shape < 3; ++shape)
+            {
+                memset(is_present, 0, nmemb * sizeof(*is_present));
+                size_t unique_c = 0;
+                for(size_t i = 0; i < nmemb; ++i)
+                {
+                    size_t rank = shape == 0 ? i : shape == 1 ? nmemb - 1 - i : (size_t)rand();
+                    keys[i] = rank % key_counts[k];
+                    if(!is_present[keys[i]]) ++unique_c;
+                    is_present[keys[i]] = true;
+                }
+
+                size_t sorted = alg_p->sort_unique(keys, nmemb, sizeof(*keys), compar_uint);
+                cr_assert_eq(sorted, unique_c, "%s: %zu != %zu", alg_p->name, sorted, unique_c);
+                for(size_t i = 0; i < sorted; ++i)
+                {
+                    cr_assert(is_present[keys[i]]);
+                    if(i) cr_assert_lt(keys[i - 1], keys[i], "%s: not sorted at %zu", alg_p->name, i);
+                }
+            }
+        }
+    }
+    free(is_present);
+    free(keys);
+}
+
+Test(algos_units, algorithm_by_flag)
+{
+    cr_assert_str_eq(algorithm_by_flag('m')->name, "merge");
+    cr_assert(algorithm_by_flag('m')->is_stable);
+    cr_assert_not(algorithm_by_flag('h')->is_stable);
+    cr_assert_null(algorithm_by_flag('x'));
+}
+#endif
@@ -7,7 +7,12 @@ from matplotlib import pyplot
 SEC_TO_MS = 1000
 
 PROGRAM_PATH = "./mysort"
-DATA_PATH = "./data.txt"
+DATA_PATH = "./data_{}.txt" # generated by gen_data.sh
+
+DISTRIBUTIONS = ("uniform", "zipf", "sorted", "reverse",
+                 "organ", "few", "prefix", "mixed")
+PLOT_ROWS = 2
+PLOT_COLS = 4
 
 ALGORITHMS = (('bq', "bubblesort"),
               ('iq', "insertionsort"),
@@ -15,6 +20,8 @@ ALGORITHMS = (('bq', "bubblesort"),
               ('hq', "heapsort"),
               ('mq', "mergesort"),
               ('qq', "quicksort"),
+              ('dq', "quick3sort"),
+              ('pq', "samplesort"),
               )
 
 ALG_FLAG_IDX = 0
@@ -30,34 +37,44 @@ SAMPLES = [list(range(X_START, 18001, 2000)), # bubble
            list(range(X_START, 1000001, 100000)), # merge
            list(range(X_START, 1000001, 100000)), # quick
            list(range(X_START, 1000001, 100000)), # heap
+           list(range(X_START, 1000001, 100000)), # quick3
+           list(range(X_START, 1000001, 100000)), # sample
           ]
 
 # print start time
 print("Start: " + str(datetime.datetime.now()))
 
+# one subplot per distribution, every algorithm is run on each of them
+figure, axes = pyplot.subplots(PLOT_ROWS, PLOT_COLS, figsize=(20, 10))
+figure.suptitle("Comparison of sorting algorithms")
+
 # the benchmark loop
-for i, alg in enumerate(ALGORITHMS):
-	tmp_algorithm_results = []
-	for j, n in enumerate(SAMPLES[i], start = 1):
-		cmd = f"head -n {n} {DATA_PATH} | /usr/bin/time -f %e {PROGRAM_PATH} {alg[ALG_FLAG_IDX]}"
-		print(f"* Running {alg[ALG_NAME_IDX]} for n = {n}... [{j}/{len(SAMPLES[i])}]")
-		if j == 1: # don't spam too much
-			print(f"  {cmd}")
-		ps = subprocess.Popen(cmd, shell=True, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
-		_, stderr = ps.communicate() # usr/bin/time prints results on stderr
-		tmp_algorithm_results.append(float(stderr) * SEC_TO_MS)
-	pyplot.plot(SAMPLES[i], tmp_algorithm_results)
+for d, dist in enumerate(DISTRIBUTIONS):
+	data_path = DATA_PATH.format(dist)
+	axis = axes[d // PLOT_COLS][d % PLOT_COLS]
+	for i, alg in enumerate(ALGORITHMS):
+		tmp_algorithm_results = []
+		for j, n in enumerate(SAMPLES[i], start = 1):
+			cmd = f"head -n {n} {data_path} | /usr/bin/time -f %e {PROGRAM_PATH} {alg[ALG_FLAG_IDX]}"
+			print(f"* Running {alg[ALG_NAME_IDX]} on {dist} for n = {n}... [{j}/{len(SAMPLES[i])}]")
+			if j == 1: # don't spam too much
+				print(f"  {cmd}")
+			ps = subprocess.Popen(cmd, shell=True, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+			_, stderr = ps.communicate() # usr/bin/time prints results on stderr
+			tmp_algorithm_results.append(float(stderr) * SEC_TO_MS)
+		axis.plot(SAMPLES[i], tmp_algorithm_results)
+
+	# decorate subplot
+	axis.set_title(dist)
+	axis.set_ylabel("Time [ms]")
+	axis.set_xlabel("Items to sort [lines of text]")
+	axis.set_xscale("log")
+	axis.grid(True)
 
 # print end time
 print("End: " + str(datetime.datetime.now()))
 
-# decorate plot
-pyplot.title("Comparison of sorting algorithms")
-pyplot.ylabel("Time [ms]")
-pyplot.legend([i[ALG_NAME_IDX] for i in ALGORITHMS], loc="upper right")
-pyplot.xlabel("Items to sort [lines of text]")
-pyplot.xscale("log")
-pyplot.grid(True)
+figure.legend([i[ALG_NAME_IDX] for i in ALGORITHMS], loc="upper right")
 
 # done
 pyplot.show()
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+
+import os
+import json
+import subprocess
+import datetime
+
+PROGRAM_PATH = "./mysort"
+DATA_PATH = "./data_{}.txt" # generated by gen_data.sh
+
+DISTRIBUTIONS = ("uniform", "zipf", "few", "prefix")
+ALGORITHMS = (('dq', "quick3"),
+              ('mq', "mergesort"),
+              ('pq', "samplesort"),
+              )
+
+ALG_FLAG_IDX = 0
+ALG_NAME_IDX = 1
+
+def peak_rss_kb(options, data_path):
+	cmd = [PROGRAM_PATH] + options + [data_path]
+	ps = subprocess.run(cmd, stdout=subprocess.PIPE, check=True)
+	return json.loads(ps.stdout)["peak_rss_kb"]
+
+def output_len(options, data_path):
+	cmd = [PROGRAM_PATH] + options + ["d", data_path]
+	ps = subprocess.run(cmd, stdout=subprocess.PIPE, check=True)
+	return len(ps.stdout)
+
+# print start time
+print("Start: " + str(datetime.datetime.now()))
+
+print(f"{'data':<10}{'algorithm':<12}{'input':>10}{'peak RSS':>12}{'lean':>12}{'saved':>8}")
+for dist in DISTRIBUTIONS:
+	data_path = DATA_PATH.format(dist)
+	input_kb = os.path.getsize(data_path) // 1024
+	for alg in ALGORITHMS:
+		normal = peak_rss_kb([alg[ALG_FLAG_IDX]], data_path)
+		lean = peak_rss_kb(["--lean", alg[ALG_FLAG_IDX]], data_path)
+		print(f"{dist:<10}{alg[ALG_NAME_IDX]:<12}{input_kb:>8}kB{normal:>10}kB{lean:>10}kB"
+		      f"{(normal - lean) / normal:>8.0%}")
+
+# sorted output is what runs of an external sort are made of
+print(f"\n{'data':<10}{'plain output':>14}{'front coded':>14}{'saved':>8}")
+for dist in DISTRIBUTIONS:
+	data_path = DATA_PATH.format(dist)
+	plain = output_len([], data_path)
+	coded = output_len(["--front-coded"], data_path)
+	print(f"{dist:<10}{plain // 1024:>12}kB{coded // 1024:>12}kB{(plain - coded) / plain:>8.0%}")
+
+# print end time
+print("End: " + str(datetime.datetime.now()))
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+
+import os
+import json
+import tempfile
+import subprocess
+import datetime
+from matplotlib import pyplot
+
+NS_TO_MS = 1e-6
+
+PROGRAM_PATH = "./mysort"
+DATA_PATH = "./data_uniform.txt" # generated by gen_data.sh
+
+MERGERS = (("loser", "loser tree"),
+           ("heap", "binary heap"),
+           )
+
+MERGER_FLAG_IDX = 0
+MERGER_NAME_IDX = 1
+
+# number of sorted files merged at once
+K_VALUES = [2 ** i for i in range(1, 11)]
+
+def split_sorted(lines, k, dir_path):
+	"""Deals lines to k files like cards, each of them sorted"""
+	paths = []
+	for i in range(k):
+		path = os.path.join(dir_path, f"run_{i}.txt")
+		with open(path, "wb") as run_file:
+			run_file.writelines(sorted(lines[i::k]))
+		paths.append(path)
+	return paths
+
+# print start time
+print("Start: " + str(datetime.datetime.now()))
+
+with open(DATA_PATH, "rb") as data_file:
+	lines = data_file.readlines()
+
+figure, (time_axis, compars_axis) = pyplot.subplots(1, 2, figsize=(16, 6))
+figure.suptitle(f"Merging {len(lines)} lines from k sorted files")
+
+results = {merger[MERGER_FLAG_IDX]: ([], []) for merger in MERGERS}
+for k in K_VALUES:
+	with tempfile.TemporaryDirectory() as dir_path:
+		paths = split_sorted(lines, k, dir_path)
+		for merger in MERGERS:
+			cmd = [PROGRAM_PATH, "-q", f"--merge={merger[MERGER_FLAG_IDX]}"] + paths
+			print(f"* Running {merger[MERGER_NAME_IDX]} merge for k = {k}...")
+			ps = subprocess.run(cmd, stdout=subprocess.PIPE, check=True)
+			stats = json.loads(ps.stdout)
+			times, compars = results[merger[MERGER_FLAG_IDX]]
+			times.append(stats["time_ns"]["sort"] * NS_TO_MS)
+			compars.append(stats["compars"] / stats["lines"])
+			print(f"  {times[-1]:.0f} ms, {compars[-1]:.2f} compars per line")
+
+# print end time
+print("End: " + str(datetime.datetime.now()))
+
+for merger in MERGERS:
+	times, compars = results[merger[MERGER_FLAG_IDX]]
+	time_axis.plot(K_VALUES, times, marker="o")
+	compars_axis.plot(K_VALUES, compars, marker="o")
+
+time_axis.set_ylabel("Time [ms]")
+compars_axis.set_ylabel("Compars per line")
+for axis in (time_axis, compars_axis):
+	axis.set_xlabel("Files merged (k)")
+	axis.set_xscale("log", base=2)
+	axis.grid(True)
+figure.legend([merger[MERGER_NAME_IDX] for merger in MERGERS], loc="upper right")
+
+# done
+pyplot.show()
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+
+import os
+import json
+import subprocess
+import datetime
+
+NS_TO_S = 1e-9
+BYTES_TO_GB = 1e-9
+
+PROGRAM_PATH = "./mysort"
+GEN_PATH = "./gen/gen_data"
+DATA_PATH = "./records_{}_{}.bin"
+
+# sortbenchmark.org layout, 100 byte records with a 10 byte key first
+RECORD_SIZE = 100
+KEY_LEN = 10
+RECORDS = (1000000, 10000000)
+DISTRIBUTIONS = ("uniform", "zipf", "few")
+
+ALGORITHMS = (('rq', "radix"),
+              ('dq', "quick3"),
+              ('pq', "samplesort"),
+              ('qq', "quicksort"),
+              )
+
+ALG_FLAG_IDX = 0
+ALG_NAME_IDX = 1
+
+def generate(dist, records):
+	data_path = DATA_PATH.format(dist, records)
+	if not os.path.exists(data_path):
+		with open(data_path, "wb") as data_file:
+			subprocess.run([GEN_PATH, f"-r{RECORD_SIZE}:{KEY_LEN}", dist, str(records)],
+			               stdout=data_file, check=True)
+	return data_path
+
+# print start time
+print("Start: " + str(datetime.datetime.now()))
+
+subprocess.run(["make", "-C", "gen", "gen_data"], stdout=subprocess.DEVNULL, check=True)
+print(f"{'data':<10}{'records':>10}  {'algorithm':<12}{'sort GB/s':>10}{'total GB/s':>12}")
+for records in RECORDS:
+	for dist in DISTRIBUTIONS:
+		data_path = generate(dist, records)
+		data_gb = os.path.getsize(data_path) * BYTES_TO_GB
+		for alg in ALGORITHMS:
+			cmd = [PROGRAM_PATH, f"--record={RECORD_SIZE}:0:{KEY_LEN}", alg[ALG_FLAG_IDX], data_path]
+			ps = subprocess.run(cmd, stdout=subprocess.PIPE, check=True)
+			phases = json.loads(ps.stdout)["time_ns"]
+			# sort covers key extraction, sorting pairs and permuting records
+			sort_s = (phases["index"] + phases["sort"]) * NS_TO_S
+			total_s = sum(phases.values()) * NS_TO_S
+			print(f"{dist:<10}{records:>10}  {alg[ALG_NAME_IDX]:<12}"
+			      f"{data_gb / sort_s:>10.2f}{data_gb / total_s:>12.2f}")
+
+# print end time
+print("End: " + str(datetime.datetime.now()))
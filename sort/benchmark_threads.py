@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+
+import os
+import json
+import subprocess
+import datetime
+from matplotlib import pyplot
+
+NS_TO_S = 1e-9
+
+PROGRAM_PATH = "./mysort"
+# generated by e.g. LINES=100000000 ./gen_data.sh, needs about 4 GB of memory
+DATA_PATH = "./data_{}.txt"
+
+DISTRIBUTIONS = ("uniform", "zipf", "few")
+# sample sort against single threaded 3-way quick sort as the baseline
+ALGORITHM = "pq"
+BASELINE = "dq"
+
+# 1, 2, 4... up to every CPU the process may run on
+CPUS = len(os.sched_getaffinity(0))
+THREADS = [t for t in (2 ** i for i in range(CPUS.bit_length())) if t < CPUS] + [CPUS]
+
+def sort_seconds(flags, data_path):
+	cmd = f"{PROGRAM_PATH} {flags} {data_path}"
+	print(f"  {cmd}")
+	ps = subprocess.run(cmd, shell=True, stdout=subprocess.PIPE, check=True)
+	return json.loads(ps.stdout)["time_ns"]["sort"] * NS_TO_S
+
+# print start time
+print("Start: " + str(datetime.datetime.now()))
+
+figure, axis = pyplot.subplots(figsize=(10, 6))
+figure.suptitle("Sample sort scaling by threads")
+
+for dist in DISTRIBUTIONS:
+	data_path = DATA_PATH.format(dist)
+	print(f"* Running baseline on {dist}...")
+	baseline = sort_seconds(BASELINE, data_path)
+	speedups = []
+	for t in THREADS:
+		print(f"* Running sample sort on {dist} with {t} threads...")
+		seconds = sort_seconds(f"-j {t} {ALGORITHM}", data_path)
+		speedups.append(baseline / seconds)
+		print(f"  {seconds:.2f} s, {speedups[-1]:.2f}x of 3-way quick sort")
+	axis.plot(THREADS, speedups, marker="o")
+
+# print end time
+print("End: " + str(datetime.datetime.now()))
+
+axis.set_ylabel("Speedup over single threaded 3-way quick sort")
+axis.set_xlabel("Threads")
+axis.set_xscale("log", base=2)
+axis.grid(True)
+figure.legend(DISTRIBUTIONS, loc="upper right")
+
+# done
+pyplot.show()
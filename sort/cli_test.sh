@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Compares output of mysort with GNU sort, run by make cli_test
+
+MYSORT=./mysort
+DATA=$(mktemp)
+trap 'rm -f "$DATA"' EXIT
+failed=0
+
+# Lines "DIGIT xIDX" have few distinct keys, but differ as a whole
+for i in $(seq 0 1999); do
+	printf "%d x%04d\n" $(( (i * 7919) % 3 )) "$i"
+done > "$DATA"
+
+# Unique mode keeps the first of lines with equal keys, like sort -s -u
+expected=$(LC_ALL=C sort -s -u -k1,1 "$DATA")
+for alg in b q i s m h d p; do
+	actual=$($MYSORT -u -k 1 $alg "$DATA")
+	if [ "$actual" != "$expected" ]; then
+		echo "FAIL unique with key: $alg printed" $actual
+		failed=1
+	fi
+done
+
+# Without keys equal lines are the same, the whole line decides
+expected=$(LC_ALL=C sort -u "$DATA")
+for alg in m d p; do
+	if [ "$($MYSORT -u $alg "$DATA")" != "$expected" ]; then
+		echo "FAIL unique: $alg"
+		failed=1
+	fi
+done
+
+# Records of 16 bytes sorted by a 4 byte key, same first of equal keys
+for i in $(seq 0 1999); do
+	printf "%04d x%09d\n" $(( (i * 7919) % 5 )) "$i"
+done > "$DATA"
+expected=$(LC_ALL=C sort -s -u -k1.1,1.4 "$DATA")
+for alg in r q m h d p; do
+	actual=$($MYSORT -u --record=16:0:4 $alg "$DATA")
+	if [ "$actual" != "$expected" ]; then
+		echo "FAIL unique records: $alg printed" $actual
+		failed=1
+	fi
+done
+
+[ $failed -eq 0 ] && echo "PASS"
+exit $failed
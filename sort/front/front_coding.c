@@ -0,0 +1,119 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "front_coding.h"
+
+#define VARINT_BITS     7U
+#define VARINT_MASK     0x7FU
+#define VARINT_MORE     0x80U
+#define VARINT_MAX_LEN  10U
+#define NULL_TERM_LEN   1U
+
+static int write_varint(size_t value, FILE* stream)
+{
+    unsigned char buf[VARINT_MAX_LEN];
+    size_t len = 0;
+    do
+    {
+        buf[len] = value & VARINT_MASK;
+        value >>= VARINT_BITS;
+        if(value) buf[len] |= VARINT_MORE;
+        ++len;
+    } while(value);
+    return fwrite(buf, 1, len, stream) == len ? 0 : -1;
+}
+
+/* @return 0 on success, -1 at the end of stream or on a broken varint */
+static int read_varint(size_t* value_p, FILE* stream)
+{
+    size_t value = 0;
+    for(unsigned int shift = 0; shift < VARINT_MAX_LEN * VARINT_BITS; shift += VARINT_BITS)
+    {
+        int byte = getc(stream);
+        if(byte == EOF)
+        {
+            /* Only a stream ending between lines is fine */
+            if(shift) errno = EINVAL;
+            return -1;
+        }
+        value |= (size_t)(byte & VARINT_MASK) << shift;
+        if(!(byte & VARINT_MORE))
+        {
+            *value_p = value;
+            return 0;
+        }
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+int front_write(struct front_writer* writer_p, const char* line, FILE* stream)
+{
+    size_t shared = 0;
+    while(shared < writer_p->prev_len && line[shared] == writer_p->prev[shared]) ++shared;
+    size_t rest_len = strlen(line + shared);
+
+    if(write_varint(shared, stream) ||
+       fwrite(line + shared, 1, rest_len, stream) != rest_len ||
+       putc('\n', stream) == EOF)
+    {
+        return -1;
+    }
+
+    /* Only the rest differs from the kept copy */
+    size_t len = shared + rest_len;
+    if(len + NULL_TERM_LEN > writer_p->cap)
+    {
+        size_t cap = 2 * (len + NULL_TERM_LEN);
+        char* grown_p = realloc(writer_p->prev, cap);
+        if(!grown_p) return -1;
+        writer_p->prev = grown_p;
+        writer_p->cap = cap;
+    }
+    memcpy(writer_p->prev + shared, line + shared, rest_len + NULL_TERM_LEN);
+    writer_p->prev_len = len;
+    return 0;
+}
+
+void front_writer_free(struct front_writer* writer_p)
+{
+    free(writer_p->prev);
+    writer_p->prev = NULL;
+    writer_p->prev_len = 0;
+    writer_p->cap = 0;
+}
+
+ssize_t front_read(char** line_pp, size_t* cap_p, const char* prev, FILE* stream)
+{
+    size_t shared;
+    if(read_varint(&shared, stream)) return -1;
+    if(shared && (!prev || strnlen(prev, shared) < shared))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ssize_t rest_len = getline(line_pp, cap_p, stream);
+    if(rest_len < 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if(rest_len && (*line_pp)[rest_len - 1] == '\n') (*line_pp)[--rest_len] = '\0';
+
+    size_t len = shared + rest_len;
+    if(len + NULL_TERM_LEN > *cap_p)
+    {
+        char* grown_p = realloc(*line_pp, len + NULL_TERM_LEN);
+        if(!grown_p) return -1;
+        *line_pp = grown_p;
+        *cap_p = len + NULL_TERM_LEN;
+    }
+    memmove(*line_pp + shared, *line_pp, rest_len + NULL_TERM_LEN);
+    if(shared) memcpy(*line_pp, prev, shared);
+    return len;
+}
@@ -0,0 +1,35 @@
+#ifndef FRONT_CODING_H_
+#define FRONT_CODING_H_
+
+#include <stdio.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/* Front coded stream of sorted lines: each line is written as the length
+ * of the prefix it shares with the previous line, a LEB128 varint, then
+ * the rest of the line and '\n'. Neighbours of sorted text share long
+ * prefixes, so runs and output shrink.
+ */
+
+/* Keeps a copy of the last written line */
+struct front_writer
+{
+    char* prev;
+    size_t prev_len;
+    size_t cap;
+};
+
+/* @return 0 on success, -1 on allocation or write failure */
+int front_write(struct front_writer* writer_p, const char* line, FILE* stream);
+
+void front_writer_free(struct front_writer* writer_p);
+
+/* Reads the next line of stream like getline(), without the newline.
+ * prev is the previous line of the same stream, NULL for the first one,
+ * and must not be *line_pp.
+ * @return line length, -1 at the end of stream or on error, errno is
+ *         EINVAL for a malformed line
+ */
+ssize_t front_read(char** line_pp, size_t* cap_p, const char* prev, FILE* stream);
+
+#endif /* FRONT_CODING_H_ */
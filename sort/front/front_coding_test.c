@@ -0,0 +1,97 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "front_coding.h"
+
+#define nmemb(arr) (sizeof(arr)/sizeof(arr[0]))
+
+/* Lines written by front_write() come back the same from front_read() */
+static void check_round_trip(const char** lines, size_t lines_num, size_t* coded_len_p)
+{
+    char* coded = NULL;
+    size_t coded_len = 0;
+    FILE* stream = open_memstream(&coded, &coded_len);
+    cr_assert_not_null(stream);
+    struct front_writer writer = {0};
+    for(size_t i = 0; i < lines_num; ++i)
+    {
+        cr_assert_eq(0, front_write(&writer, lines[i], stream));
+    }
+    front_writer_free(&writer);
+    fclose(stream);
+
+    stream = fmemopen(coded, coded_len, "r");
+    cr_assert_not_null(stream);
+    char* bufs[2] = {NULL, NULL};
+    size_t caps[2] = {0, 0};
+    const char* prev = NULL;
+    for(size_t i = 0; i < lines_num; ++i)
+    {
+        char** line_pp = &bufs[i % 2];
+        cr_assert_eq((ssize_t)strlen(lines[i]), front_read(line_pp, &caps[i % 2], prev, stream));
+        cr_assert_str_eq(lines[i], *line_pp);
+        prev = *line_pp;
+    }
+    cr_assert_eq(-1, front_read(&bufs[lines_num % 2], &caps[lines_num % 2], prev, stream));
+    fclose(stream);
+    free(bufs[0]);
+    free(bufs[1]);
+    free(coded);
+    *coded_len_p = coded_len;
+}
+
+Test(front_coding_functionals, round_trip)
+{
+    const char* lines[] = {"", "", "apple", "applesauce", "apply", "b", "banana",
+        "banana", "band", "bandana", ""};
+    size_t coded_len;
+    check_round_trip(lines, nmemb(lines), &coded_len);
+
+    /* Shared prefixes are not repeated */
+    size_t plain_len = 0;
+    for(size_t i = 0; i < nmemb(lines); ++i)
+    {
+        plain_len += strlen(lines[i]) + 1;
+    }
+    cr_assert_lt(coded_len, plain_len);
+}
+
+/* Prefixes of 128 and more take more than one varint byte */
+Test(front_coding_functionals, long_prefixes)
+{
+    char long_a[300];
+    char long_b[300];
+    memset(long_a, 'x', sizeof(long_a) - 1);
+    long_a[sizeof(long_a) - 1] = '\0';
+    memcpy(long_b, long_a, sizeof(long_b));
+    long_b[sizeof(long_b) - 2] = 'y';
+    const char* lines[] = {long_a, long_b, long_b, "x"};
+    size_t coded_len;
+    check_round_trip(lines, nmemb(lines), &coded_len);
+    cr_assert_lt(coded_len, 2 * sizeof(long_a));
+}
+
+Test(front_coding_functionals, malformed)
+{
+    /* First line can't share a prefix */
+    char coded[] = "\x03" "abc\n";
+    FILE* stream = fmemopen(coded, sizeof(coded) - 1, "r");
+    char* line = NULL;
+    size_t cap = 0;
+    errno = 0;
+    cr_assert_eq(-1, front_read(&line, &cap, NULL, stream));
+    cr_assert_eq(EINVAL, errno);
+    fclose(stream);
+
+    /* Nor a longer one than the previous line */
+    stream = fmemopen(coded, sizeof(coded) - 1, "r");
+    errno = 0;
+    cr_assert_eq(-1, front_read(&line, &cap, "ab", stream));
+    cr_assert_eq(EINVAL, errno);
+    fclose(stream);
+    free(line);
+}
+#endif
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gen.h"
+
+#define ALPHABET_LEN 26U
+/* 26^13 keys fit into 64 bits */
+#define KEY_SPACE    2481152873203736576ULL
+/* Space, digits of a 64-bit number, space and terminator */
+#define PAYLOAD_MAX  23U
+
+static const char* const dist_names[GEN_DISTS_NUM] =
+{
+    [GEN_UNIFORM] = "uniform",
+    [GEN_ZIPF]    = "zipf",
+    [GEN_SORTED]  = "sorted",
+    [GEN_REVERSE] = "reverse",
+    [GEN_ORGAN]   = "organ",
+    [GEN_FEW]     = "few",
+    [GEN_PREFIX]  = "prefix",
+    [GEN_MIXED]   = "mixed",
+};
+
+/* splitmix64, good enough and trivially seedable */
+static uint64_t next_rand(uint64_t* state_p)
+{
+    uint64_t z = (*state_p += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static double next_unit(uint64_t* state_p)
+{
+    return (next_rand(state_p) >> 11) * (1.0 / (1ULL << 53));
+}
+
+/* Scrambles key rank, so frequent keys don't come out sorted */
+static uint64_t mix(uint64_t value, uint64_t seed)
+{
+    uint64_t state = value ^ (seed * 0xD1B54A32D192ED03ULL);
+    return next_rand(&state);
+}
+
+/* Fixed width base 26, so numeric order equals lexicographic order */
+static void encode_key(uint64_t value, char* key_p)
+{
+    for(size_t i = GEN_KEY_LEN; i > 0; --i)
+    {
+        key_p[i - 1] = 'a' + value % ALPHABET_LEN;
+        value /= ALPHABET_LEN;
+    }
+}
+
+static void random_chars(uint64_t* state_p, char* chars_p, size_t len)
+{
+    for(size_t i = 0; i < len; ++i)
+    {
+        chars_p[i] = 'a' + next_rand(state_p) % ALPHABET_LEN;
+    }
+}
+
+/* Zipf sampling by rejection-inversion (Hormann, Derflinger), which needs
+ * no tables, so the number of distinct keys can be as large as needed.
+ */
+static double helper1(double x)
+{
+    return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+static double helper2(double x)
+{
+    return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+
+static double zipf_h(const struct gen* gen_p, double x)
+{
+    return exp(-gen_p->exponent * log(x));
+}
+
+static double zipf_h_integral(const struct gen* gen_p, double x)
+{
+    double log_x = log(x);
+    return helper2((1.0 - gen_p->exponent) * log_x) * log_x;
+}
+
+static double zipf_h_integral_inv(const struct gen* gen_p, double x)
+{
+    double t = x * (1.0 - gen_p->exponent);
+    if(t < -1.0) t = -1.0;
+    return exp(helper1(t) * x);
+}
+
+/* @return rank in range 1 to keys */
+static uint64_t zipf_sample(struct gen* gen_p)
+{
+    while(1)
+    {
+        double u = gen_p->h_integral_n +
+            next_unit(&gen_p->state) * (gen_p->h_integral_x1 - gen_p->h_integral_n);
+        double x = zipf_h_integral_inv(gen_p, u);
+        uint64_t k = (uint64_t)(x + 0.5);
+        if(k < 1) k = 1;
+        else if(k > gen_p->keys) k = gen_p->keys;
+
+        if(k - x <= gen_p->s ||
+           u >= zipf_h_integral(gen_p, k + 0.5) - zipf_h(gen_p, k))
+        {
+            return k;
+        }
+    }
+}
+
+/* Ascending key for position idx, jittered within its own slot. Jitter
+ * depends only on idx, so the organ pipe halves mirror each other exactly.
+ */
+static uint64_t sorted_value(struct gen* gen_p, uint64_t idx)
+{
+    return idx * gen_p->step + mix(idx, gen_p->seed) % gen_p->step;
+}
+
+int gen_init(struct gen* gen_p, enum gen_dist dist, uint64_t lines,
+    uint64_t seed, uint64_t keys, double exponent)
+{
+    if(dist >= GEN_DISTS_NUM || keys == 0 || exponent <= 0.0) return -1;
+
+    memset(gen_p, 0, sizeof(*gen_p));
+    gen_p->dist = dist;
+    gen_p->lines = lines;
+    gen_p->keys = keys;
+    gen_p->seed = seed;
+    gen_p->state = seed;
+    gen_p->exponent = exponent;
+    gen_p->step = lines ? KEY_SPACE / lines : 1;
+    if(gen_p->step == 0) gen_p->step = 1;
+
+    gen_p->h_integral_x1 = zipf_h_integral(gen_p, 1.5) - 1.0;
+    gen_p->h_integral_n = zipf_h_integral(gen_p, keys + 0.5);
+    gen_p->s = 2.0 - zipf_h_integral_inv(gen_p,
+        zipf_h_integral(gen_p, 2.5) - zipf_h(gen_p, 2.0));
+
+    uint64_t prefix_state = mix(GEN_PREFIX, seed);
+    random_chars(&prefix_state, gen_p->prefix, GEN_PREFIX_LEN);
+    return 0;
+}
+
+size_t gen_next(struct gen* gen_p, char* line_p)
+{
+    uint64_t idx = gen_p->idx++;
+
+    switch(gen_p->dist)
+    {
+        case GEN_UNIFORM:
+            random_chars(&gen_p->state, line_p, GEN_KEY_LEN);
+            return GEN_KEY_LEN;
+
+        case GEN_ZIPF:
+            encode_key(mix(zipf_sample(gen_p), gen_p->seed) % KEY_SPACE, line_p);
+            return GEN_KEY_LEN;
+
+        case GEN_SORTED:
+            encode_key(sorted_value(gen_p, idx), line_p);
+            return GEN_KEY_LEN;
+
+        case GEN_REVERSE:
+            encode_key(sorted_value(gen_p, gen_p->lines - 1 - idx), line_p);
+            return GEN_KEY_LEN;
+
+        case GEN_ORGAN:
+            if(idx >= gen_p->lines / 2) idx = gen_p->lines - 1 - idx;
+            encode_key(sorted_value(gen_p, idx), line_p);
+            return GEN_KEY_LEN;
+
+        case GEN_FEW:
+            encode_key(mix(next_rand(&gen_p->state) % gen_p->keys, gen_p->seed)
+                % KEY_SPACE, line_p);
+            return GEN_KEY_LEN;
+
+        case GEN_PREFIX:
+            memcpy(line_p, gen_p->prefix, GEN_PREFIX_LEN);
+            random_chars(&gen_p->state, line_p + GEN_PREFIX_LEN, GEN_KEY_LEN);
+            return GEN_PREFIX_LEN + GEN_KEY_LEN;
+
+        case GEN_MIXED:
+        default:
+        {
+            size_t len = 1 + next_rand(&gen_p->state) % GEN_MIXED_MAX_LEN;
+            random_chars(&gen_p->state, line_p, len);
+            return len;
+        }
+    }
+}
+
+void gen_record(struct gen* gen_p, char* rec_p, size_t size, size_t key_len)
+{
+    uint64_t idx = gen_p->idx;
+    char line[GEN_LINE_MAX];
+    size_t len = gen_next(gen_p, line);
+    for(size_t i = 0; i < key_len; ++i)
+    {
+        rec_p[i] = i < len ? line[i] : ' ';
+    }
+
+    /* Payload shows where the record came from, like in gensort */
+    char payload[PAYLOAD_MAX];
+    int payload_len = snprintf(payload, sizeof(payload), " %llu ", (unsigned long long)idx);
+    for(size_t i = key_len; i < size; ++i)
+    {
+        size_t p = i - key_len;
+        rec_p[i] = p < (size_t)payload_len ? payload[p] : 'A' + p % ALPHABET_LEN;
+    }
+    if(size > key_len) rec_p[size - 1] = '\n';
+}
+
+enum gen_dist gen_dist_from_name(const char* name)
+{
+    for(size_t d = 0; d < GEN_DISTS_NUM; ++d)
+    {
+        if(strcmp(name, dist_names[d]) == 0) return d;
+    }
+    return GEN_DISTS_NUM;
+}
+
+const char* gen_dist_name(enum gen_dist dist)
+{
+    return dist < GEN_DISTS_NUM ? dist_names[dist] : NULL;
+}
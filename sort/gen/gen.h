@@ -0,0 +1,69 @@
+#ifndef GEN_H_
+#define GEN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define GEN_KEY_LEN       13U
+#define GEN_PREFIX_LEN    48U
+#define GEN_MIXED_MAX_LEN 60U
+#define GEN_LINE_MAX     (GEN_PREFIX_LEN + GEN_KEY_LEN)
+
+#define GEN_DEFAULT_SEED      1U
+#define GEN_DEFAULT_KEYS      1000000U
+#define GEN_DEFAULT_FEW_KEYS  10U
+#define GEN_DEFAULT_EXPONENT  1.0
+/* sortbenchmark.org records, 100 bytes with a 10 byte key */
+#define GEN_DEFAULT_RECORD_SIZE    100U
+#define GEN_DEFAULT_RECORD_KEY_LEN 10U
+
+enum gen_dist
+{
+    GEN_UNIFORM,    // random 13 char keys, same as the old gen_data.sh
+    GEN_ZIPF,       // keys drawn with Zipfian frequencies
+    GEN_SORTED,     // ascending keys
+    GEN_REVERSE,    // descending keys
+    GEN_ORGAN,      // ascending first half, descending second half
+    GEN_FEW,        // handful of distinct keys, uniformly repeated
+    GEN_PREFIX,     // long prefix shared by all lines, random suffix
+    GEN_MIXED,      // random keys of random length
+    GEN_DISTS_NUM
+};
+
+struct gen
+{
+    enum gen_dist dist;
+    uint64_t lines;
+    uint64_t keys;
+    uint64_t idx;
+    uint64_t state;
+    uint64_t seed;
+    uint64_t step;
+    double exponent;
+    /* Zipf sampler constants */
+    double h_integral_x1;
+    double h_integral_n;
+    double s;
+    char prefix[GEN_PREFIX_LEN];
+};
+
+/* @return 0 on success, -1 on bad parameters */
+int gen_init(struct gen* gen_p, enum gen_dist dist, uint64_t lines,
+    uint64_t seed, uint64_t keys, double exponent);
+
+/* Writes next line without newline into line_p (at least GEN_LINE_MAX long)
+ * @return length of the line
+ */
+size_t gen_next(struct gen* gen_p, char* line_p);
+
+/* Writes next fixed size record into rec_p: the next line as a key of
+ * key_len bytes, cut or padded with spaces, then the record number and
+ * filler, the last byte is a newline. key_len must not exceed size.
+ */
+void gen_record(struct gen* gen_p, char* rec_p, size_t size, size_t key_len);
+
+/* @return distribution or GEN_DISTS_NUM if name is unknown */
+enum gen_dist gen_dist_from_name(const char* name);
+const char* gen_dist_name(enum gen_dist dist);
+
+#endif /* GEN_H_ */
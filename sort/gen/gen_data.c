@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "gen.h"
+
+#define EXPECTED_ARGS   2U
+#define OUT_BUF_SIZE   (1U << 20)
+
+static void print_help(void);
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed = GEN_DEFAULT_SEED;
+    uint64_t keys = 0;
+    double exponent = GEN_DEFAULT_EXPONENT;
+    size_t record_size = 0;
+    size_t record_key_len = GEN_DEFAULT_RECORD_KEY_LEN;
+
+    int opt;
+    while((opt = getopt(argc, argv, "s:k:a:r::")) != -1)
+    {
+        switch(opt)
+        {
+            case 's':
+                seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'k':
+                keys = strtoull(optarg, NULL, 0);
+                break;
+            case 'a':
+                exponent = strtod(optarg, NULL);
+                break;
+            case 'r':
+            {
+                /* SIZE[:KEY_LEN] */
+                char* end_p = optarg;
+                record_size = optarg ? strtoull(optarg, &end_p, 0) : GEN_DEFAULT_RECORD_SIZE;
+                if(optarg && *end_p == ':') record_key_len = strtoull(end_p + 1, NULL, 0);
+                if(!record_size || record_key_len > record_size)
+                {
+                    print_help();
+                    return -1;
+                }
+                break;
+            }
+            default:
+                print_help();
+                return -1;
+        }
+    }
+
+    if(argc - optind != EXPECTED_ARGS)
+    {
+        print_help();
+        return -1;
+    }
+
+    enum gen_dist dist = gen_dist_from_name(argv[optind]);
+    uint64_t lines = strtoull(argv[optind + 1], NULL, 0);
+    if(keys == 0)
+    {
+        keys = (dist == GEN_FEW) ? GEN_DEFAULT_FEW_KEYS : GEN_DEFAULT_KEYS;
+    }
+
+    struct gen gen;
+    if(gen_init(&gen, dist, lines, seed, keys, exponent))
+    {
+        print_help();
+        return -1;
+    }
+
+    /* Lines are streamed, so output size is not limited by memory */
+    static char out_buf[OUT_BUF_SIZE];
+    setvbuf(stdout, out_buf, _IOFBF, sizeof(out_buf));
+
+    if(record_size)
+    {
+        char* rec_p = malloc(record_size);
+        if(!rec_p)
+        {
+            perror("Could not allocate record");
+            return -1;
+        }
+        for(uint64_t i = 0; i < lines; ++i)
+        {
+            gen_record(&gen, rec_p, record_size, record_key_len);
+            if(fwrite(rec_p, 1, record_size, stdout) != record_size)
+            {
+                perror("Could not write output");
+                return -1;
+            }
+        }
+        free(rec_p);
+        return 0;
+    }
+
+    char line[GEN_LINE_MAX + 1];
+    for(uint64_t i = 0; i < lines; ++i)
+    {
+        size_t len = gen_next(&gen, line);
+        line[len] = '\n';
+        if(fwrite(line, sizeof(*line), len + 1, stdout) != len + 1)
+        {
+            perror("Could not write output");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void print_help(void)
+{
+    printf("Syntax:\n\
+    gen_data [-s SEED] [-k KEYS] [-a EXPONENT] [-rSIZE[:KEY_LEN]] DISTRIBUTION LINES\n\n\
+    distributions:\n\
+    uniform - random 13 char lowercase keys\n\
+    zipf    - KEYS distinct keys with Zipfian frequencies of EXPONENT\n\
+    sorted  - ascending keys\n\
+    reverse - descending keys\n\
+    organ   - ascending, then descending keys (organ pipe)\n\
+    few     - KEYS distinct keys (10 by default) repeated uniformly\n\
+    prefix  - 48 char prefix shared by all lines, random suffix\n\
+    mixed   - random keys of 1 to 60 chars\n\
+    \n\
+    -r writes LINES fixed size records instead of lines, keys come from\n\
+    the distribution, 100 byte records with 10 byte keys by default\n\
+    \n\
+    Output is the same for the same SEED, e.g.:\n\
+    ./gen_data -s 42 zipf 1000000 > data_zipf.txt\n\
+    ./gen_data -r100:10 uniform 10000000 > records.bin\n");
+}
@@ -0,0 +1,171 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <string.h>
+#include "gen.h"
+
+#define LINES 1000U
+
+static size_t next_line(struct gen* gen_p, char* line_p)
+{
+    size_t len = gen_next(gen_p, line_p);
+    line_p[len] = '\0';
+    return len;
+}
+
+Test(gen_functionals, same_seed_same_output)
+{
+    for(enum gen_dist d = 0; d < GEN_DISTS_NUM; ++d)
+    {
+        struct gen a, b;
+        cr_assert_eq(0, gen_init(&a, d, LINES, 7, 100, 1.0));
+        cr_assert_eq(0, gen_init(&b, d, LINES, 7, 100, 1.0));
+        for(unsigned int i = 0; i < LINES; ++i)
+        {
+            char line_a[GEN_LINE_MAX + 1], line_b[GEN_LINE_MAX + 1];
+            cr_assert_eq(next_line(&a, line_a), next_line(&b, line_b));
+            cr_assert_str_eq(line_a, line_b);
+        }
+    }
+}
+
+Test(gen_functionals, ordered_distributions)
+{
+    struct gen sorted, reverse, organ;
+    cr_assert_eq(0, gen_init(&sorted, GEN_SORTED, LINES, 1, 1, 1.0));
+    cr_assert_eq(0, gen_init(&reverse, GEN_REVERSE, LINES, 1, 1, 1.0));
+    cr_assert_eq(0, gen_init(&organ, GEN_ORGAN, LINES, 1, 1, 1.0));
+
+    char prev_s[GEN_LINE_MAX + 1], prev_r[GEN_LINE_MAX + 1], prev_o[GEN_LINE_MAX + 1];
+    next_line(&sorted, prev_s);
+    next_line(&reverse, prev_r);
+    next_line(&organ, prev_o);
+    for(unsigned int i = 1; i < LINES; ++i)
+    {
+        char line[GEN_LINE_MAX + 1];
+        next_line(&sorted, line);
+        cr_assert_lt(strcmp(prev_s, line), 0);
+        strcpy(prev_s, line);
+
+        next_line(&reverse, line);
+        cr_assert_gt(strcmp(prev_r, line), 0);
+        strcpy(prev_r, line);
+
+        next_line(&organ, line);
+        if(i < LINES / 2) cr_assert_leq(strcmp(prev_o, line), 0);
+        else cr_assert_geq(strcmp(prev_o, line), 0);
+        strcpy(prev_o, line);
+    }
+}
+
+Test(gen_functionals, few_unique_keys)
+{
+    const unsigned int keys = 5;
+    char seen[keys][GEN_LINE_MAX + 1];
+    unsigned int seen_c = 0;
+
+    struct gen few;
+    cr_assert_eq(0, gen_init(&few, GEN_FEW, LINES, 3, keys, 1.0));
+    for(unsigned int i = 0; i < LINES; ++i)
+    {
+        char line[GEN_LINE_MAX + 1];
+        next_line(&few, line);
+        unsigned int k = 0;
+        while(k < seen_c && strcmp(seen[k], line) != 0) ++k;
+        if(k == seen_c)
+        {
+            cr_assert_lt(seen_c, keys);
+            strcpy(seen[seen_c++], line);
+        }
+    }
+    cr_assert_eq(seen_c, keys);
+}
+
+Test(gen_functionals, zipf_is_skewed)
+{
+    const unsigned int keys = 10;
+    char seen[keys][GEN_LINE_MAX + 1];
+    unsigned int hits[keys];
+    unsigned int seen_c = 0;
+
+    struct gen zipf;
+    cr_assert_eq(0, gen_init(&zipf, GEN_ZIPF, LINES, 5, keys, 1.0));
+    for(unsigned int i = 0; i < LINES; ++i)
+    {
+        char line[GEN_LINE_MAX + 1];
+        next_line(&zipf, line);
+        unsigned int k = 0;
+        while(k < seen_c && strcmp(seen[k], line) != 0) ++k;
+        if(k == seen_c)
+        {
+            cr_assert_lt(seen_c, keys);
+            strcpy(seen[seen_c], line);
+            hits[seen_c++] = 0;
+        }
+        ++hits[k];
+    }
+
+    // most frequent of 10 keys with exponent 1.0 takes ~34% of lines,
+    // uniform distribution would give it 10%
+    unsigned int max_hits = 0;
+    for(unsigned int k = 0; k < seen_c; ++k)
+    {
+        if(hits[k] > max_hits) max_hits = hits[k];
+    }
+    cr_assert_gt(max_hits, LINES / 4);
+}
+
+Test(gen_functionals, prefix_and_mixed_lengths)
+{
+    struct gen prefix, mixed;
+    cr_assert_eq(0, gen_init(&prefix, GEN_PREFIX, LINES, 9, 1, 1.0));
+    cr_assert_eq(0, gen_init(&mixed, GEN_MIXED, LINES, 9, 1, 1.0));
+
+    char first[GEN_LINE_MAX + 1];
+    next_line(&prefix, first);
+    for(unsigned int i = 1; i < LINES; ++i)
+    {
+        char line[GEN_LINE_MAX + 1];
+        cr_assert_eq(next_line(&prefix, line), GEN_PREFIX_LEN + GEN_KEY_LEN);
+        cr_assert_eq(0, memcmp(first, line, GEN_PREFIX_LEN));
+
+        size_t len = next_line(&mixed, line);
+        cr_assert_geq(len, 1);
+        cr_assert_leq(len, GEN_MIXED_MAX_LEN);
+    }
+}
+
+Test(gen_functionals, bad_parameters)
+{
+    struct gen gen;
+    cr_assert_eq(-1, gen_init(&gen, GEN_DISTS_NUM, LINES, 1, 1, 1.0));
+    cr_assert_eq(-1, gen_init(&gen, GEN_ZIPF, LINES, 1, 0, 1.0));
+    cr_assert_eq(GEN_DISTS_NUM, gen_dist_from_name("gaussian"));
+    cr_assert_eq(GEN_ORGAN, gen_dist_from_name("organ"));
+}
+/* Keys are lines of the same seed, cut or padded to the key length */
+Test(gen_functionals, records)
+{
+    struct gen lines_gen, recs_gen;
+    cr_assert_eq(0, gen_init(&lines_gen, GEN_MIXED, LINES, 3, 1, 1.0));
+    cr_assert_eq(0, gen_init(&recs_gen, GEN_MIXED, LINES, 3, 1, 1.0));
+    const size_t key_len = 10;
+    for(unsigned int i = 0; i < LINES; ++i)
+    {
+        char line[GEN_LINE_MAX + 1];
+        char rec[GEN_DEFAULT_RECORD_SIZE];
+        size_t len = next_line(&lines_gen, line);
+        memset(rec, 0, sizeof(rec));
+        gen_record(&recs_gen, rec, sizeof(rec), key_len);
+
+        for(size_t b = 0; b < key_len; ++b)
+        {
+            cr_assert_eq(b < len ? line[b] : ' ', rec[b]);
+        }
+        char payload[32];
+        snprintf(payload, sizeof(payload), " %u ", i);
+        cr_assert_eq(0, memcmp(payload, rec + key_len, strlen(payload)));
+        cr_assert_eq('\n', rec[sizeof(rec) - 1]);
+        cr_assert_null(memchr(rec, '\0', sizeof(rec)));
+    }
+}
+#endif
@@ -1 +1,16 @@
-head -n 1100000 /dev/urandom | base64 | tr -cd [:lower:]\\n | head -n 1000000 | cut -c-13 > data.txt
+#!/usr/bin/env bash
+# Generates one data file per distribution, LINES and SEED can be overridden,
+# e.g. LINES=100000000 SEED=7 ./gen_data.sh
+
+LINES=${LINES:-1000000}
+SEED=${SEED:-1}
+DISTRIBUTIONS="uniform zipf sorted reverse organ few prefix mixed"
+
+make -C gen gen_data || exit 1
+
+for dist in $DISTRIBUTIONS; do
+	./gen/gen_data -s "$SEED" "$dist" "$LINES" > "data_$dist.txt"
+done
+
+# default data set, same shape as before: random 13 char lowercase lines
+cp data_uniform.txt data.txt
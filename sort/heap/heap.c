@@ -3,6 +3,8 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+#include "../prof/prof.h"
+
 #ifndef NO_TEST
 #include <criterion.h>
 #endif
@@ -206,6 +208,9 @@ void heap_sort(void* heap, size_t nmemb, size_t size,
 
 static void swap(void* a, void* b, size_t size)
 {
+    /* Counted the same way as swaps in mysort */
+    PROF_INC(PROF_SWAPS);
+
     void* temp = malloc(size);
     memcpy(temp, a, size);
     memcpy(a, b, size);
@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "keys.h"
+#include "../prof/prof.h"
+
+#define KEY_BLOCK_SIZE      (1U << 20)
+#define KEY_LEN_SIZE         sizeof(uint32_t)
+/* Sign byte and integer digit count in front of numeric key digits */
+#define NUM_HEADER_LEN      (1U + sizeof(uint32_t))
+#define NUM_NEGATIVE        '0'
+#define NUM_ZERO            '1'
+#define NUM_POSITIVE        '2'
+/* Ends negative digits, sorts above every complemented digit */
+#define NUM_NEG_TERM         0xFFU
+
+struct key_block
+{
+    struct key_block* next_p;
+    size_t used;
+    size_t cap;
+    unsigned char data[];
+};
+
+bool keys_needed(const struct key_opts* opts_p)
+{
+    return opts_p->field != KEY_WHOLE_LINE || opts_p->is_numeric ||
+           opts_p->is_fold || opts_p->is_collate;
+}
+
+/* @return room for len bytes, valid until the arena is freed */
+static unsigned char* arena_alloc(struct key_arena* arena_p, size_t len)
+{
+    struct key_block* block_p = arena_p->head_p;
+    if(!block_p || block_p->cap - block_p->used < len)
+    {
+        size_t cap = len > KEY_BLOCK_SIZE ? len : KEY_BLOCK_SIZE;
+        block_p = malloc(sizeof(*block_p) + cap);
+        if(!block_p) return NULL;
+        block_p->next_p = arena_p->head_p;
+        block_p->used = 0;
+        block_p->cap = cap;
+        arena_p->head_p = block_p;
+    }
+
+    unsigned char* mem_p = block_p->data + block_p->used;
+    block_p->used += len;
+    return mem_p;
+}
+
+/* Gives back the tail of the last allocation which was not used */
+static void arena_trim(struct key_arena* arena_p, size_t unused)
+{
+    arena_p->head_p->used -= unused;
+}
+
+void key_arena_free(struct key_arena* arena_p)
+{
+    while(arena_p->head_p)
+    {
+        struct key_block* to_free = arena_p->head_p;
+        arena_p->head_p = to_free->next_p;
+        free(to_free);
+    }
+}
+
+void key_arena_reset(struct key_arena* arena_p)
+{
+    struct key_block* block_p = arena_p->head_p;
+    if(!block_p) return;
+
+    arena_p->head_p = block_p->next_p;
+    key_arena_free(arena_p);
+    block_p->next_p = NULL;
+    block_p->used = 0;
+    arena_p->head_p = block_p;
+}
+
+static bool is_separator(char c, const struct key_opts* opts_p)
+{
+    if(opts_p->separator == KEY_BLANK_SEP) return c == ' ' || c == '\t';
+    return c == opts_p->separator;
+}
+
+/* Finds the selected field, sets its length in len_p. Blank separated
+ * fields skip leading blanks, a missing field gives an empty key.
+ */
+static const char* find_field(const char* line, const struct key_opts* opts_p,
+    size_t* len_p)
+{
+    if(opts_p->field == KEY_WHOLE_LINE)
+    {
+        *len_p = strlen(line);
+        return line;
+    }
+
+    bool is_blank_sep = opts_p->separator == KEY_BLANK_SEP;
+    const char* start_p = line;
+    for(unsigned int f = 1; ; ++f)
+    {
+        if(is_blank_sep)
+        {
+            while(is_separator(*start_p, opts_p)) ++start_p;
+        }
+
+        const char* end_p = start_p;
+        while(*end_p && !is_separator(*end_p, opts_p)) ++end_p;
+
+        if(f == opts_p->field)
+        {
+            *len_p = end_p - start_p;
+            return start_p;
+        }
+        if(!*end_p)
+        {
+            *len_p = 0;
+            return end_p;
+        }
+        start_p = is_blank_sep ? end_p : end_p + 1;
+    }
+}
+
+/* Order preserving encoding of a decimal number: sign byte, count of
+ * integer digits and significant digits without leading and trailing
+ * zeros. Negative numbers have count and digits complemented, so plain
+ * byte comparison orders them by value as well.
+ * @return length of the key
+ */
+static size_t encode_numeric(const char* field, size_t len, unsigned char* key_p)
+{
+    size_t idx = 0;
+    while(idx < len && isblank((unsigned char)field[idx])) ++idx;
+
+    bool is_negative = false;
+    if(idx < len && (field[idx] == '-' || field[idx] == '+'))
+    {
+        is_negative = field[idx] == '-';
+        ++idx;
+    }
+
+    /* Leading zeros don't change the value */
+    while(idx < len && field[idx] == '0') ++idx;
+
+    size_t digits = 0;
+    uint32_t int_digits = 0;
+    unsigned char* digits_p = key_p + NUM_HEADER_LEN;
+    while(idx < len && isdigit((unsigned char)field[idx]))
+    {
+        digits_p[digits++] = field[idx++];
+        ++int_digits;
+    }
+    if(idx < len && field[idx] == '.')
+    {
+        ++idx;
+        /* Zeros right after the point are kept, they order 0.05 below 0.5 */
+        while(idx < len && isdigit((unsigned char)field[idx]))
+        {
+            digits_p[digits++] = field[idx++];
+        }
+    }
+    while(digits && digits_p[digits - 1] == '0') --digits;
+
+    if(digits == 0)
+    {
+        key_p[0] = NUM_ZERO;
+        return 1;
+    }
+
+    key_p[0] = is_negative ? NUM_NEGATIVE : NUM_POSITIVE;
+    uint32_t count = is_negative ? ~int_digits : int_digits;
+    for(size_t b = 0; b < sizeof(count); ++b)
+    {
+        key_p[1 + b] = count >> (8 * (sizeof(count) - 1 - b));
+    }
+    if(is_negative)
+    {
+        for(size_t d = 0; d < digits; ++d) digits_p[d] = ~digits_p[d];
+        digits_p[digits++] = NUM_NEG_TERM;
+    }
+    return NUM_HEADER_LEN + digits;
+}
+
+/* @return key with its length prefix or NULL on allocation failure */
+static unsigned char* build_key(const char* line, const struct key_opts* opts_p,
+    struct key_arena* arena_p)
+{
+    size_t field_len;
+    const char* field = find_field(line, opts_p, &field_len);
+
+    if(opts_p->is_numeric)
+    {
+        /* One more byte for the terminator of negative digits */
+        unsigned char* key_p =
+            arena_alloc(arena_p, KEY_LEN_SIZE + NUM_HEADER_LEN + field_len + 1);
+        if(!key_p) return NULL;
+        uint32_t len = encode_numeric(field, field_len, key_p + KEY_LEN_SIZE);
+        arena_trim(arena_p, NUM_HEADER_LEN + field_len + 1 - len);
+        memcpy(key_p, &len, KEY_LEN_SIZE);
+        return key_p;
+    }
+
+    if(!opts_p->is_collate)
+    {
+        unsigned char* key_p = arena_alloc(arena_p, KEY_LEN_SIZE + field_len);
+        if(!key_p) return NULL;
+        uint32_t len = field_len;
+        memcpy(key_p, &len, KEY_LEN_SIZE);
+        for(size_t i = 0; i < field_len; ++i)
+        {
+            unsigned char c = field[i];
+            key_p[KEY_LEN_SIZE + i] = opts_p->is_fold ? toupper(c) : c;
+        }
+        return key_p;
+    }
+
+    /* strxfrm needs a terminated string */
+    char* src = malloc(field_len + 1);
+    if(!src) return NULL;
+    for(size_t i = 0; i < field_len; ++i)
+    {
+        unsigned char c = field[i];
+        src[i] = opts_p->is_fold ? toupper(c) : c;
+    }
+    src[field_len] = '\0';
+
+    size_t xfrm_len = strxfrm(NULL, src, 0);
+    unsigned char* key_p = arena_alloc(arena_p, KEY_LEN_SIZE + xfrm_len + 1);
+    if(key_p)
+    {
+        strxfrm((char*)key_p + KEY_LEN_SIZE, src, xfrm_len + 1);
+        arena_trim(arena_p, 1);
+        uint32_t len = xfrm_len;
+        memcpy(key_p, &len, KEY_LEN_SIZE);
+    }
+    free(src);
+    return key_p;
+}
+
+int keys_build(struct keyed_line* recs, char** lines, size_t nmemb,
+    const struct key_opts* opts_p, struct key_arena* arena_p)
+{
+    for(size_t i = 0; i < nmemb; ++i)
+    {
+        recs[i].line = lines[i];
+        recs[i].key = build_key(lines[i], opts_p, arena_p);
+        if(!recs[i].key) return -1;
+    }
+    return 0;
+}
+
+/* @return -1 - p1 is less than p2
+ *          0 - p1 is equal to p2
+ *          1 - p1 is greater than p2
+ */
+int keycmp(const void* p1, const void* p2)
+{
+    const unsigned char* a = ((const struct keyed_line*)p1)->key;
+    const unsigned char* b = ((const struct keyed_line*)p2)->key;
+
+    /* For comparing complexity */
+    PROF_INC(PROF_COMPARS);
+
+    uint32_t len_a, len_b;
+    memcpy(&len_a, a, KEY_LEN_SIZE);
+    memcpy(&len_b, b, KEY_LEN_SIZE);
+
+    int result = memcmp(a + KEY_LEN_SIZE, b + KEY_LEN_SIZE, len_a < len_b ? len_a : len_b);
+    if(result) return result < 0 ? -1 : 1;
+
+    /* Shorter key is a prefix of the longer one */
+    if(len_a != len_b) return len_a < len_b ? -1 : 1;
+    return 0;
+}
+
+int keycmp_stable(const void* p1, const void* p2)
+{
+    int result = keycmp(p1, p2);
+    if(result) return result;
+
+    const char* a = ((const struct keyed_line*)p1)->line;
+    const char* b = ((const struct keyed_line*)p2)->line;
+    return (a > b) - (a < b);
+}
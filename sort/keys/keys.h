@@ -0,0 +1,61 @@
+#ifndef KEYS_H_
+#define KEYS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define KEY_WHOLE_LINE    0U
+#define KEY_BLANK_SEP    '\0'
+
+/* How to turn a line into its key */
+struct key_opts
+{
+    unsigned int field;     // 1-based field number, 0 for the whole line
+    char separator;         // field separator, runs of blanks by default
+    bool is_numeric;        // compare leading numbers by value
+    bool is_fold;           // compare upper and lower case as equal
+    bool is_collate;        // compare by LC_COLLATE of current locale
+};
+
+/* Element sorted instead of bare line pointer, key is prefixed by
+ * its length, as numeric keys may contain zero bytes
+ */
+struct keyed_line
+{
+    const unsigned char* key;
+    char* line;
+};
+
+/* Keys are packed into large blocks, freed all at once */
+struct key_block;
+
+struct key_arena
+{
+    struct key_block* head_p;
+};
+
+bool keys_needed(const struct key_opts* opts_p);
+
+/* Builds key of each line once, so sorting does only byte comparisons
+ * @return 0 on success, -1 on allocation failure
+ */
+int keys_build(struct keyed_line* recs, char** lines, size_t nmemb,
+    const struct key_opts* opts_p, struct key_arena* arena_p);
+
+/* Byte comparison of keys, same contract as mystrcmp */
+int keycmp(const void* p1, const void* p2);
+
+/* Equal keys are ordered by line address, i.e. by original position
+ * of lines which come from one input buffer
+ */
+int keycmp_stable(const void* p1, const void* p2);
+
+void key_arena_free(struct key_arena* arena_p);
+
+/* Keeps the newest block only and empties it, so keys of following
+ * lines reuse its memory instead of allocating
+ */
+void key_arena_reset(struct key_arena* arena_p);
+
+#endif /* KEYS_H_ */
@@ -0,0 +1,127 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include "keys.h"
+
+#define nmemb(arr) (sizeof(arr)/sizeof(arr[0]))
+
+/* Sorts lines by their keys and checks they come out in expected order */
+static void check_order(char** lines, size_t n, const struct key_opts* opts_p,
+    const char** expected)
+{
+    struct keyed_line recs[n];
+    struct key_arena arena = {0};
+    cr_assert_eq(0, keys_build(recs, lines, n, opts_p, &arena));
+    qsort(recs, n, sizeof(*recs), keycmp);
+    for(size_t i = 0; i < n; ++i)
+    {
+        cr_assert_str_eq(recs[i].line, expected[i], "%zu: %s != %s",
+            i, recs[i].line, expected[i]);
+    }
+    key_arena_free(&arena);
+}
+
+Test(keys_functionals, numeric)
+{
+    char* lines[] = {"10", "-3.5", "2", "abc", "-10", "0.05", "+7", "0.5",
+                     "-3.25", "007", "100", " 1e3", "-0"};
+    const char* sorted[] = {"-10", "-3.5", "-3.25", "abc", "-0", "0.05", "0.5",
+                            " 1e3", "2", "+7", "007", "10", "100"};
+    struct key_opts opts = {.is_numeric = true};
+
+    // lines without a number and zeros are all equal, sort their block alone
+    struct keyed_line recs[nmemb(lines)];
+    struct key_arena arena = {0};
+    cr_assert_eq(0, keys_build(recs, lines, nmemb(lines), &opts, &arena));
+    qsort(recs, nmemb(recs), sizeof(*recs), keycmp);
+    for(size_t i = 0; i < nmemb(recs); ++i)
+    {
+        if(i == 3 || i == 4)
+        {
+            cr_assert_eq(0, keycmp(&recs[3], &recs[4]));
+            continue;
+        }
+        if(i == 9 || i == 10)
+        {
+            cr_assert_eq(0, keycmp(&recs[9], &recs[10]));
+            continue;
+        }
+        cr_assert_str_eq(recs[i].line, sorted[i]);
+    }
+    key_arena_free(&arena);
+}
+
+Test(keys_functionals, fold_case)
+{
+    char* lines[] = {"b", "A", "a", "B", "_"};
+    struct key_opts opts = {.is_fold = true};
+    struct keyed_line recs[nmemb(lines)];
+    struct key_arena arena = {0};
+    cr_assert_eq(0, keys_build(recs, lines, nmemb(lines), &opts, &arena));
+
+    cr_assert_eq(0, keycmp(&recs[0], &recs[3]));
+    cr_assert_eq(0, keycmp(&recs[1], &recs[2]));
+    cr_assert_lt(keycmp(&recs[2], &recs[0]), 0);
+    // folded to upper case, as sort -f does
+    cr_assert_lt(keycmp(&recs[3], &recs[4]), 0);
+    key_arena_free(&arena);
+}
+
+Test(keys_functionals, fields)
+{
+    char* lines[] = {"x  3 c", "y 1 b", "z\t2 a", "w"};
+    const char* by_second[] = {"w", "y 1 b", "z\t2 a", "x  3 c"};
+    const char* by_third[] = {"w", "z\t2 a", "y 1 b", "x  3 c"};
+    struct key_opts opts = {.field = 2};
+    check_order(lines, nmemb(lines), &opts, by_second);
+    opts.field = 3;
+    check_order(lines, nmemb(lines), &opts, by_third);
+
+    char* csv[] = {"a,,3", "b,2,1", "c,1,2"};
+    const char* csv_second[] = {"a,,3", "c,1,2", "b,2,1"};
+    const char* csv_third_num[] = {"b,2,1", "c,1,2", "a,,3"};
+    struct key_opts csv_opts = {.field = 2, .separator = ','};
+    check_order(csv, nmemb(csv), &csv_opts, csv_second);
+    csv_opts.field = 3;
+    csv_opts.is_numeric = true;
+    check_order(csv, nmemb(csv), &csv_opts, csv_third_num);
+}
+
+Test(keys_functionals, collate_c_locale)
+{
+    // in C locale collation is plain byte order
+    setlocale(LC_COLLATE, "C");
+    char* lines[] = {"b", "B", "a", "ab"};
+    const char* sorted[] = {"B", "a", "ab", "b"};
+    struct key_opts opts = {.is_collate = true};
+    check_order(lines, nmemb(lines), &opts, sorted);
+}
+
+Test(keys_functionals, keys_needed)
+{
+    struct key_opts opts = {0};
+    cr_assert_not(keys_needed(&opts));
+    opts.field = 1;
+    cr_assert(keys_needed(&opts));
+}
+
+/* Keys built after a reset land in the kept block */
+Test(keys_functionals, arena_reset)
+{
+    char* lines[] = {"10 b", "9 a"};
+    struct keyed_line recs[nmemb(lines)];
+    struct key_opts opts = {.field = 1, .is_numeric = true};
+    struct key_arena arena = {0};
+    key_arena_reset(&arena);
+    cr_assert_null(arena.head_p);
+
+    cr_assert_eq(0, keys_build(&recs[0], &lines[0], 1, &opts, &arena));
+    const unsigned char* first_key = recs[0].key;
+    key_arena_reset(&arena);
+    cr_assert_eq(0, keys_build(&recs[1], &lines[1], 1, &opts, &arena));
+    cr_assert_eq(first_key, recs[1].key);
+    key_arena_free(&arena);
+}
+#endif
@@ -0,0 +1,185 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "merge.h"
+
+/* Current elements of all sources, exhausted ones are after all others */
+struct heads
+{
+    void* elems;
+    bool* is_done;
+    size_t size;
+    int (*compar)(const void*, const void*);
+};
+
+static int heads_init(struct heads* heads_p, size_t k, size_t size,
+    int (*compar)(const void*, const void*),
+    merge_next_fn next, void* ctx_p)
+{
+    heads_p->elems = malloc(k * size);
+    heads_p->is_done = malloc(k * sizeof(*heads_p->is_done));
+    heads_p->size = size;
+    heads_p->compar = compar;
+    if(!heads_p->elems || !heads_p->is_done) return -1;
+
+    for(size_t src = 0; src < k; ++src)
+    {
+        heads_p->is_done[src] = !next(ctx_p, src, heads_p->elems + src * size);
+    }
+    return 0;
+}
+
+static void heads_free(struct heads* heads_p)
+{
+    free(heads_p->is_done);
+    free(heads_p->elems);
+}
+
+/* Ties go to the lower source, which keeps merging stable */
+static bool is_before(const struct heads* heads_p, size_t a, size_t b)
+{
+    if(heads_p->is_done[a]) return false;
+    if(heads_p->is_done[b]) return true;
+
+    int result = heads_p->compar(heads_p->elems + a * heads_p->size,
+        heads_p->elems + b * heads_p->size);
+    return result < 0 || (result == 0 && a < b);
+}
+
+/* Emits the head of src and replaces it by the next element of src
+ * @return result of emit
+ */
+static int advance(struct heads* heads_p, size_t src,
+    merge_next_fn next, merge_emit_fn emit, void* ctx_p)
+{
+    void* elem = heads_p->elems + src * heads_p->size;
+    int result = emit(ctx_p, src, elem);
+    if(!result) heads_p->is_done[src] = !next(ctx_p, src, elem);
+    return result;
+}
+
+/* Leaves of sources are nodes k to 2k - 1, inner node n keeps the loser
+ * of the match between winners of its children 2n and 2n + 1, node 0
+ * keeps the overall winner. A new head of the winner only has to play
+ * against losers on its way up, one compare per level.
+ */
+static int play_losers(struct heads* heads_p, size_t k, size_t* losers,
+    size_t* winners, merge_next_fn next, merge_emit_fn emit, void* ctx_p)
+{
+    /* First round bottom up */
+    for(size_t src = 0; src < k; ++src)
+    {
+        winners[k + src] = src;
+    }
+    for(size_t n = k - 1; n >= 1; --n)
+    {
+        size_t a = winners[2 * n];
+        size_t b = winners[2 * n + 1];
+        bool is_a = is_before(heads_p, a, b);
+        winners[n] = is_a ? a : b;
+        losers[n] = is_a ? b : a;
+    }
+    losers[0] = k == 1 ? 0 : winners[1];
+
+    while(!heads_p->is_done[losers[0]])
+    {
+        size_t winner = losers[0];
+        if(advance(heads_p, winner, next, emit, ctx_p)) return -1;
+
+        for(size_t n = (k + winner) / 2; n >= 1; n /= 2)
+        {
+            if(is_before(heads_p, losers[n], winner))
+            {
+                size_t loser = winner;
+                winner = losers[n];
+                losers[n] = loser;
+            }
+        }
+        losers[0] = winner;
+    }
+    return 0;
+}
+
+int loser_tree_merge(size_t k, size_t size,
+    int (*compar)(const void*, const void*),
+    merge_next_fn next, merge_emit_fn emit, void* ctx_p)
+{
+    if(!k) return 0;
+
+    struct heads heads;
+    size_t* losers = malloc(k * sizeof(*losers));
+    size_t* winners = malloc(2 * k * sizeof(*winners));
+    int result = -1;
+    if(!heads_init(&heads, k, size, compar, next, ctx_p) && losers && winners)
+    {
+        result = play_losers(&heads, k, losers, winners, next, emit, ctx_p);
+    }
+
+    free(winners);
+    free(losers);
+    heads_free(&heads);
+    return result;
+}
+
+/* Children of heap[i] are heap[2i + 1] and heap[2i + 2] */
+static void sift_down(const struct heads* heads_p, size_t* heap, size_t i,
+    size_t nmemb)
+{
+    for(;;)
+    {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if(left < nmemb && is_before(heads_p, heap[left], heap[smallest])) smallest = left;
+        if(right < nmemb && is_before(heads_p, heap[right], heap[smallest])) smallest = right;
+        if(smallest == i) return;
+
+        size_t tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+/* Exhausted sources leave the heap, so it holds nmemb <= k of them */
+static int pop_heap(struct heads* heads_p, size_t k, size_t* heap,
+    merge_next_fn next, merge_emit_fn emit, void* ctx_p)
+{
+    size_t nmemb = 0;
+    for(size_t src = 0; src < k; ++src)
+    {
+        if(!heads_p->is_done[src]) heap[nmemb++] = src;
+    }
+    for(size_t i = nmemb / 2; i-- > 0;)
+    {
+        sift_down(heads_p, heap, i, nmemb);
+    }
+
+    while(nmemb)
+    {
+        if(advance(heads_p, heap[0], next, emit, ctx_p)) return -1;
+        if(heads_p->is_done[heap[0]]) heap[0] = heap[--nmemb];
+        sift_down(heads_p, heap, 0, nmemb);
+    }
+    return 0;
+}
+
+int heap_merge(size_t k, size_t size,
+    int (*compar)(const void*, const void*),
+    merge_next_fn next, merge_emit_fn emit, void* ctx_p)
+{
+    if(!k) return 0;
+
+    struct heads heads;
+    size_t* heap = malloc(k * sizeof(*heap));
+    int result = -1;
+    if(!heads_init(&heads, k, size, compar, next, ctx_p) && heap)
+    {
+        result = pop_heap(&heads, k, heap, next, emit, ctx_p);
+    }
+
+    free(heap);
+    heads_free(&heads);
+    return result;
+}
@@ -0,0 +1,34 @@
+#ifndef MERGE_H_
+#define MERGE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/* Writes the next element of source src to elem
+ * @return false when the source has no more elements
+ */
+typedef bool (*merge_next_fn)(void* ctx_p, size_t src, void* elem);
+
+/* Gets merged elements in order, elem is valid until source src
+ * is asked for its next element
+ * @return 0 to go on, anything else stops merging
+ */
+typedef int (*merge_emit_fn)(void* ctx_p, size_t src, const void* elem);
+
+/* Merges k sorted sources through a tournament tree of losers, each
+ * output element costs about log2(k) compares. Equal elements of
+ * different sources come in source order.
+ * @return 0 on success, -1 on allocation failure or when emit stops
+ */
+int loser_tree_merge(size_t k, size_t size,
+    int (*compar)(const void*, const void*),
+    merge_next_fn next, merge_emit_fn emit, void* ctx_p);
+
+/* Same through a binary min heap of sources, each output element costs
+ * about 2 * log2(k) compares, kept for comparison
+ */
+int heap_merge(size_t k, size_t size,
+    int (*compar)(const void*, const void*),
+    merge_next_fn next, merge_emit_fn emit, void* ctx_p);
+
+#endif /* MERGE_H_ */
@@ -0,0 +1,167 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "merge.h"
+
+#define MAX_SOURCES 70U
+#define MAX_LEN     50U
+#define SEED        2022U
+
+struct rec
+{
+    unsigned int key;
+    unsigned int src;
+    unsigned int idx;
+};
+
+/* Sorted runs in memory, merged records are collected in out */
+struct runs
+{
+    struct rec recs[MAX_SOURCES][MAX_LEN];
+    size_t lens[MAX_SOURCES];
+    size_t pos[MAX_SOURCES];
+    struct rec out[MAX_SOURCES * MAX_LEN];
+    size_t out_len;
+    size_t stop_at;
+};
+
+static size_t compars = 0;
+
+static int compar_key(const void* a, const void* b)
+{
+    ++compars;
+    unsigned int k1 = ((const struct rec*)a)->key;
+    unsigned int k2 = ((const struct rec*)b)->key;
+    return (k1 > k2) - (k1 < k2);
+}
+
+static bool next_rec(void* ctx_p, size_t src, void* elem)
+{
+    struct runs* runs_p = ctx_p;
+    if(runs_p->pos[src] == runs_p->lens[src]) return false;
+    memcpy(elem, &runs_p->recs[src][runs_p->pos[src]++], sizeof(struct rec));
+    return true;
+}
+
+static int emit_rec(void* ctx_p, size_t src, const void* elem)
+{
+    struct runs* runs_p = ctx_p;
+    if(runs_p->out_len == runs_p->stop_at) return 1;
+    cr_assert_eq(src, ((const struct rec*)elem)->src);
+    runs_p->out[runs_p->out_len++] = *(const struct rec*)elem;
+    return 0;
+}
+
+/* Some runs are empty, keys repeat within and across them */
+static size_t make_runs(struct runs* runs_p, size_t k)
+{
+    size_t total = 0;
+    for(size_t src = 0; src < k; ++src)
+    {
+        runs_p->lens[src] = rand() % 4 ? rand() % (MAX_LEN + 1) : 0;
+        unsigned int key = 0;
+        for(size_t i = 0; i < runs_p->lens[src]; ++i)
+        {
+            key += rand() % 3 == 0;
+            runs_p->recs[src][i] = (struct rec){key, src, i};
+        }
+        runs_p->pos[src] = 0;
+        total += runs_p->lens[src];
+    }
+    runs_p->out_len = 0;
+    runs_p->stop_at = SIZE_MAX;
+    return total;
+}
+
+/* Keys don't descend, equal ones come by source, then by position */
+static void check_merged(const struct runs* runs_p, size_t total)
+{
+    cr_assert_eq(total, runs_p->out_len);
+    for(size_t i = 1; i < runs_p->out_len; ++i)
+    {
+        const struct rec* a = &runs_p->out[i - 1];
+        const struct rec* b = &runs_p->out[i];
+        cr_assert_leq(a->key, b->key, "not sorted at %zu", i);
+        if(a->key != b->key) continue;
+        cr_assert(a->src < b->src || (a->src == b->src && a->idx < b->idx),
+            "not stable at %zu", i);
+    }
+}
+
+static void check_merger(int (*merger)(size_t, size_t,
+    int (*)(const void*, const void*), merge_next_fn, merge_emit_fn, void*))
+{
+    static struct runs runs;
+    srand(SEED);
+    for(size_t k = 0; k <= MAX_SOURCES; ++k)
+    {
+        size_t total = make_runs(&runs, k);
+        cr_assert_eq(0, merger(k, sizeof(struct rec), compar_key, next_rec, emit_rec, &runs));
+        check_merged(&runs, total);
+    }
+}
+
+Test(merge_functionals, loser_tree_merge)
+{
+    check_merger(loser_tree_merge);
+}
+
+Test(merge_functionals, heap_merge)
+{
+    check_merger(heap_merge);
+}
+
+Test(merge_functionals, emit_stops_merging)
+{
+    static struct runs runs;
+    srand(SEED);
+    make_runs(&runs, MAX_SOURCES);
+    runs.stop_at = 10;
+    cr_assert_eq(-1, loser_tree_merge(MAX_SOURCES, sizeof(struct rec), compar_key,
+        next_rec, emit_rec, &runs));
+    cr_assert_eq(10, runs.out_len);
+
+    make_runs(&runs, MAX_SOURCES);
+    runs.stop_at = 10;
+    cr_assert_eq(-1, heap_merge(MAX_SOURCES, sizeof(struct rec), compar_key,
+        next_rec, emit_rec, &runs));
+    cr_assert_eq(10, runs.out_len);
+}
+
+/* A loser tree of 64 full runs takes 6 compares per element, a heap
+ * up to twice as many
+ */
+Test(merge_functionals, compares_per_element)
+{
+    static struct runs runs;
+    const size_t k = 64;
+    const size_t log_k = 6;
+    for(size_t src = 0; src < k; ++src)
+    {
+        runs.lens[src] = MAX_LEN;
+        for(size_t i = 0; i < MAX_LEN; ++i)
+        {
+            runs.recs[src][i] = (struct rec){(unsigned int)(i * k + (src * 37) % k), src, i};
+        }
+    }
+
+    runs.out_len = 0;
+    runs.stop_at = SIZE_MAX;
+    memset(runs.pos, 0, sizeof(runs.pos));
+    compars = 0;
+    cr_assert_eq(0, loser_tree_merge(k, sizeof(struct rec), compar_key, next_rec, emit_rec, &runs));
+    check_merged(&runs, k * MAX_LEN);
+    size_t tree_compars = compars;
+    cr_assert_leq(tree_compars, k + k * MAX_LEN * log_k);
+
+    runs.out_len = 0;
+    memset(runs.pos, 0, sizeof(runs.pos));
+    compars = 0;
+    cr_assert_eq(0, heap_merge(k, sizeof(struct rec), compar_key, next_rec, emit_rec, &runs));
+    check_merged(&runs, k * MAX_LEN);
+    cr_assert_gt(compars, tree_compars * 3 / 2);
+}
+
+#endif /* NO_TEST */
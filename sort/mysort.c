@@ -1,59 +1,102 @@
 #include <stdio.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
-#include "heap/heap.h"
+#include <stdint.h>
+#include <getopt.h>
+#include <locale.h>
+#include <sys/resource.h>
+#include "algos/algos.h"
+#include "front/front_coding.h"
+#include "keys/keys.h"
+#include "merge/merge.h"
+#include "prof/prof.h"
+#include "records/records.h"
+#include "sample/sample_sort.h"
 
 #define NEWLINE_LEN         1U
 #define NULL_TERM_LEN       1U
-#define MAX_LINE_LEN       (60U + NEWLINE_LEN + NULL_TERM_LEN)
 #define PREALLOC_LINES      1000000U
-
-#define EXPECTED_ARGS_STDIN 2U
-#define EXPECTED_ARGS_FILE  3U
-#define ALGORITHM_FLAG_IDX  1U
-#define FILE_PATH_IDX       2U
+#define READ_CHUNK         (1U << 20)
+
+/* Positional arguments, counted after options */
+#define EXPECTED_ARGS_STDIN 1U
+#define EXPECTED_ARGS_FILE  2U
+#define ALGORITHM_FLAG_IDX  0U
+#define FILE_PATH_IDX       1U
+/* Descriptors besides merged files, stdin, stdout and stderr */
+#define RESERVED_FDS        3U
+/* Radix sort is not in the algorithm table, it sorts records only */
+#define RADIX_FLAG          'r'
 
 enum inputs {input_stdin, input_file};
+enum mergers {merger_none, merger_loser_tree, merger_heap};
 
-int mystrcmp(const void* p1, const void* p2);
+/* Lean mode compares offsets of lines, which are relative to the input
+ * buffer, there is no other way to pass it to a compar function
+ */
+static const char* lean_buf_p = NULL;
 
-void bubble_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*));
-void insertion_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*));
-void selection_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*));
-void merge_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*));
+struct options
+{
+    enum inputs sel_input;
+    const char* alg_flag;
+    const char* file_path;
+    /* Merge mode takes files only, no algorithm */
+    enum mergers merger;
+    char** merge_paths;
+    size_t merge_paths_num;
+    bool is_quiet;
+    bool is_unique;
+    bool is_stable;
+    bool is_lean;
+    bool is_front_in;
+    bool is_front_out;
+    unsigned int threads_num;
+    struct key_opts keys;
+    /* Record mode sorts binary records when the size is set */
+    struct record_layout record;
+};
 
+int mystrcmp(const void* p1, const void* p2);
+int mystrcmp_stable(const void* p1, const void* p2);
+static int leanstrcmp(const void* p1, const void* p2);
+static int leanstrcmp_stable(const void* p1, const void* p2);
+
+static int parse_args(int argc, char* argv[], struct options* opts_p);
+static char* read_stream(FILE* stream, size_t* len_p);
+static void* index_lines(char* buf, size_t len, bool is_lean, size_t* lines_num_p);
+static int write_line(struct front_writer* writer_p, const char* line, bool is_front_coded);
+static int merge_files(const struct options* opts_p);
+static int sort_records(const struct options* opts_p, const struct algorithm* alg_p,
+    const char* buf_p, size_t buf_len);
 static void print_help(void);
 
-/* For comparing complexity */
-static size_t swaps;
-static size_t compars;
-
 int main(int argc, char* argv[])
 {
-    enum inputs sel_input;
+    struct options opts;
+    if(parse_args(argc, argv, &opts))
+    {
+        print_help();
+        return -1;
+    }
+    if(opts.merger != merger_none) return merge_files(&opts);
+    enum inputs sel_input = opts.sel_input;
 
-    switch(argc)
+    const struct algorithm* alg_p = algorithm_by_flag(*opts.alg_flag);
+    bool is_radix = opts.record.size && *opts.alg_flag == RADIX_FLAG;
+    if(!alg_p && !is_radix)
     {
-        case EXPECTED_ARGS_STDIN:
-            sel_input = input_stdin;
-            break;
-        case EXPECTED_ARGS_FILE:
-            sel_input = input_file;
-            break;
-        default:
-            print_help();
-            return -1;
+        printf("Incorrect algorithm selection flag!\n");
+        return -1;
     }
+    sample_sort_set_threads(opts.threads_num);
 
     FILE* file_p = NULL;
     if(sel_input == input_file)
     {
-        file_p = fopen(argv[FILE_PATH_IDX], "r"); // malloc inside
+        file_p = fopen(opts.file_path, "r"); // malloc inside
         if(!file_p)
         {
             perror("Could not open file");
@@ -61,97 +104,139 @@ int main(int argc, char* argv[])
         }
     }
 
-    /* Place pointer to each line in lines_p array */
-    char** lines_p = malloc(PREALLOC_LINES * sizeof(*lines_p));
-    size_t max_lines = PREALLOC_LINES;
+    /* Read the whole input at once, lines are split in place later */
+    prof_phase_begin(PROF_READ);
     FILE* selected_stream = (sel_input == input_file) ? file_p : stdin;
+    size_t buf_len = 0;
+    char* buf_p = read_stream(selected_stream, &buf_len);
+    prof_phase_end(PROF_READ);
+    if(!buf_p)
+    {
+        perror("Could not read input");
+        return -1;
+    }
+    if(opts.record.size)
+    {
+        int result = sort_records(&opts, alg_p, buf_p, buf_len);
+        free(buf_p);
+        if(sel_input == input_file) fclose(file_p);
+        return result;
+    }
+
+    /* Place pointer to each line in lines_p array, or its offset in lean
+     * mode, which keys need pointers for and which can't be past 4 GiB
+     */
+    prof_phase_begin(PROF_INDEX);
+    bool is_lean = opts.is_lean && !keys_needed(&opts.keys) && buf_len <= UINT32_MAX;
     size_t read_lines = 0;
-    while(1)
+    void* index_p = index_lines(buf_p, buf_len, is_lean, &read_lines);
+    if(!index_p)
     {
-        char* line_p = malloc(MAX_LINE_LEN * sizeof(*line_p));
-        char* retval = fgets(line_p, MAX_LINE_LEN, selected_stream); // malloc inside
-        if(retval)
-        {
-            lines_p[read_lines] = line_p;
-            ++read_lines;
-        }
-        /* We got EOF */
-        else
-        {
-            free(line_p);
-            break;
-        }
+        perror("Could not index lines");
+        return -1;
+    }
+    char** lines_p = is_lean ? NULL : index_p;
+    uint32_t* offsets_p = is_lean ? index_p : NULL;
+
+    /* We are moving pointers to lines, or pointers to lines with their keys
+     * built once here, so the sort itself only compares bytes
+     */
+    void* base = index_p;
+    size_t size = sizeof(*lines_p);
+    compar_fn compar = mystrcmp;
+    compar_fn stable_compar = mystrcmp_stable;
+    if(is_lean)
+    {
+        lean_buf_p = buf_p;
+        size = sizeof(*offsets_p);
+        compar = leanstrcmp;
+        stable_compar = leanstrcmp_stable;
+    }
+    struct keyed_line* recs_p = NULL;
+    struct key_arena arena = {0};
+    if(keys_needed(&opts.keys))
+    {
+        if(opts.keys.is_collate) setlocale(LC_COLLATE, "");
 
-        if(read_lines == max_lines)
+        recs_p = malloc(read_lines * sizeof(*recs_p));
+        if(!recs_p || keys_build(recs_p, lines_p, read_lines, &opts.keys, &arena))
         {
-            lines_p = realloc(lines_p, (max_lines + PREALLOC_LINES) * sizeof(*lines_p));
-            max_lines += PREALLOC_LINES;
+            perror("Could not build keys");
+            return -1;
         }
+        base = recs_p;
+        size = sizeof(*recs_p);
+        compar = keycmp;
+        stable_compar = keycmp_stable;
     }
-
-    /* Sort based on selected algorithm */
-    switch(*argv[ALGORITHM_FLAG_IDX])
+    prof_phase_end(PROF_INDEX);
+
+    /* Sort based on selected algorithm. Stable mode breaks ties of the
+     * unstable ones by original position of lines, the rest are left as is.
+     * So does unique mode with keys, lines with equal keys may differ and
+     * the first of them is the one output.
+     */
+    bool is_tie_broken = !alg_p->is_stable &&
+        (opts.is_stable || (opts.is_unique && recs_p));
+    compar_fn sort_compar = is_tie_broken ? stable_compar : compar;
+    /* Algorithms which group equal lines drop duplicates while sorting,
+     * unless broken ties would make all lines distinct
+     */
+    size_t sorted_lines = read_lines;
+    bool is_deduplicated = opts.is_unique && alg_p->sort_unique && !is_tie_broken;
+    prof_phase_begin(PROF_SORT);
+    if(is_deduplicated)
     {
-        case 'b':
-            /* We are moving pointers to lines, not lines themselves */
-            bubble_sort(lines_p, read_lines, sizeof(*lines_p), mystrcmp);
-            break;
-
-        case 'q':
-            qsort(lines_p, read_lines, sizeof(*lines_p), mystrcmp);
-            break;
-
-        case 'i':
-            insertion_sort(lines_p, read_lines, sizeof(*lines_p), mystrcmp);
-            break;
-
-        case 's':
-            selection_sort(lines_p, read_lines, sizeof(*lines_p), mystrcmp);
-            break;
-
-        case 'm':
-            merge_sort(lines_p, read_lines, sizeof(*lines_p), mystrcmp);
-            break;
-
-        case 'h':
-            heap_sort(lines_p, read_lines, sizeof(*lines_p), mystrcmp);
-            break;
-
-        default:
-            printf("Incorrect algorithm selection flag!\n");
-            return -1;
+        sorted_lines = alg_p->sort_unique(base, read_lines, size, compar);
     }
-
-    /* Check for quiet mode */
-    bool is_quiet = false;
-    if(*(argv[ALGORITHM_FLAG_IDX] + sizeof(char)) == 'q')
+    else
     {
-        is_quiet = true;
+        alg_p->sort(base, read_lines, size, sort_compar);
     }
-
-    /* Print results */
-    for(int i = 0; i < read_lines; i++)
+    prof_phase_end(PROF_SORT);
+
+    /* Print results, sorted equal lines are adjacent, so the rest of
+     * algorithms drop duplicates on the fly by looking at the last one
+     */
+    prof_phase_begin(PROF_WRITE);
+    bool is_dedup_on_write = opts.is_unique && !is_deduplicated;
+    size_t written_lines = 0;
+    struct front_writer writer = {0};
+    for(size_t i = 0; i < sorted_lines; i++)
     {
-        if(!is_quiet)
+        if(is_dedup_on_write && written_lines &&
+           compar(base + i * size, base + (i - 1) * size) == 0)
         {
-            printf("%s", lines_p[i]); // malloc inside
+            continue;
         }
-        free(lines_p[i]);
+        if(!opts.is_quiet)
+        {
+            const char* line = recs_p ? recs_p[i].line :
+                is_lean ? buf_p + offsets_p[i] : lines_p[i];
+            if(write_line(&writer, line, opts.is_front_out))
+            {
+                perror("Could not write output");
+                return -1;
+            }
+        }
+        ++written_lines;
     }
+    fflush(stdout);
+    front_writer_free(&writer);
+    prof_phase_end(PROF_WRITE);
 
-    /* For comparing complexity */
-    if(is_quiet)
+    /* For comparing complexity, one JSON object per run */
+    if(opts.is_quiet)
     {
-        printf("\n");
-        printf("Compars: %lu\n", compars);
-        printf("Swaps:   %lu\n", swaps);
-        printf("-------- \n");
-        printf("Sum:     %lu\n", swaps + compars);
-        printf("\n");
+        prof_thread_merge();
+        prof_print_json(stdout, alg_p->name, read_lines, written_lines);
     }
 
     /* Cleanup */
-    free(lines_p);
+    key_arena_free(&arena);
+    free(recs_p);
+    free(index_p);
+    free(buf_p);
     if(sel_input == input_file)
     {
         fclose(file_p);
@@ -159,21 +244,17 @@ int main(int argc, char* argv[])
     return 0;
 }
 
-/* @return -1 - p1 is less than p2
- *          0 - p1 is equal to p2
- *          1 - p1 is greater than p2
+/* @return -1 - a is less than b
+ *          0 - a is equal to b
+ *          1 - a is greater than b
  */
-int mystrcmp(const void* p1, const void* p2)
+static int compare_lines(const char* a, const char* b)
 {
-    /* Convert and dereference into string pointers */
-    const char* a = *(const char**)p1;
-    const char* b = *(const char**)p2;
-
     /* For comparing complexity */
-    ++compars;
+    PROF_INC(PROF_COMPARS);
 
     /* Go along string comparing each character */
-    for(size_t idx = 0; idx < MAX_LINE_LEN; ++idx)
+    for(size_t idx = 0; ; ++idx)
     {
         if(a[idx] < b[idx]) return -1;
         if(a[idx] > b[idx]) return 1;
@@ -186,171 +267,563 @@ int mystrcmp(const void* p1, const void* p2)
     return 0;
 }
 
-static void swap(void* a, void* b, size_t size)
+int mystrcmp(const void* p1, const void* p2)
 {
-    /* For comparing complexity */
-    ++swaps;
+    /* Convert and dereference into string pointers */
+    return compare_lines(*(const char**)p1, *(const char**)p2);
+}
+
+/* Same as mystrcmp, but equal lines are ordered by their position
+ * in the input buffer, which is their original order
+ */
+int mystrcmp_stable(const void* p1, const void* p2)
+{
+    int result = mystrcmp(p1, p2);
+    if(result) return result;
 
-    void* tmp = malloc(size);
-    memcpy(tmp, a, size);
-    memcpy(a, b, size);
-    memcpy(b, tmp, size);
-    free(tmp);
+    const char* a = *(const char**)p1;
+    const char* b = *(const char**)p2;
+    return (a > b) - (a < b);
 }
 
-void bubble_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*))
+/* Same as mystrcmp for 32-bit offsets of lines in lean_buf_p */
+static int leanstrcmp(const void* p1, const void* p2)
 {
-    bool rerun_flag = true;
-    size_t num_in_position = 0;
-    size_t rerun_idx = 0;
+    return compare_lines(lean_buf_p + *(const uint32_t*)p1,
+        lean_buf_p + *(const uint32_t*)p2);
+}
 
-    while(rerun_flag)
+static int leanstrcmp_stable(const void* p1, const void* p2)
+{
+    int result = leanstrcmp(p1, p2);
+    if(result) return result;
+
+    uint32_t a = *(const uint32_t*)p1;
+    uint32_t b = *(const uint32_t*)p2;
+    return (a > b) - (a < b);
+}
+
+/* Read whole stream into one buffer with a spare byte for a terminator
+ * @return buffer to free or NULL on error, its length is set in len_p
+ */
+static char* read_stream(FILE* stream, size_t* len_p)
+{
+    size_t cap = READ_CHUNK;
+    size_t len = 0;
+    char* buf_p = malloc(cap + NULL_TERM_LEN);
+    if(!buf_p) return NULL;
+
+    while(1)
     {
-        rerun_flag = false;
-        for(size_t c = rerun_idx; c + 1 < nmemb - num_in_position; ++c)
+        len += fread(buf_p + len, sizeof(*buf_p), cap - len, stream);
+        /* Short read means EOF or error */
+        if(len < cap) break;
+
+        cap *= 2;
+        char* grown_p = realloc(buf_p, cap + NULL_TERM_LEN);
+        if(!grown_p)
         {
-            if(compar(base + c * size, base + (c + 1) * size) > 0)
-            {
-                swap(base + c * size, base + (c + 1) * size, size);
-                // no point to rerun if we swapped only 1st elem
-                if(c > 0)
-                {
-                    // skip non-modified elements in front next time
-                    if(!rerun_flag) rerun_idx = c - 1;
-                    rerun_flag = true;
-                }
-            }
+            free(buf_p);
+            return NULL;
         }
-        // each loop shifts next largest element to the final position
-        ++num_in_position;
+        buf_p = grown_p;
+    }
+
+    if(ferror(stream))
+    {
+        free(buf_p);
+        return NULL;
     }
+
+    *len_p = len;
+    return buf_p;
 }
 
-void insertion_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*))
+/* Terminate each line in place, newlines are restored on output
+ * @return array of pointers to lines, or of their 32-bit offsets from buf
+ *         in lean mode, NULL on error
+ */
+static void* index_lines(char* buf, size_t len, bool is_lean, size_t* lines_num_p)
 {
-    /* Take first element from the unsorted part (i to nmemb - 1) */
-    for(size_t i = 1; i < nmemb; ++i)
+    size_t size = is_lean ? sizeof(uint32_t) : sizeof(char*);
+    size_t max_lines = PREALLOC_LINES;
+    void* lines_p = malloc(max_lines * size);
+    if(!lines_p) return NULL;
+
+    size_t read_lines = 0;
+    char* line_p = buf;
+    char* end_p = buf + len;
+    while(line_p < end_p)
     {
-        /* Compare it with elements of the sorted part (i - 1 to 0) */
-        for(size_t j = i; j > 0; --j)
+        /* Last line doesn't need to end with a newline */
+        char* newline_p = memchr(line_p, '\n', end_p - line_p);
+        if(!newline_p) newline_p = end_p;
+        *newline_p = '\0';
+
+        if(read_lines == max_lines)
         {
-            if(compar(base + (j - 1) * size, base + j * size) > 0)
-            {
-                /* Shift it before larger element of the sorted array */
-                swap(base + (j - 1) * size, base + j * size, size);
-            }
-            else
+            void* grown_p = realloc(lines_p, (max_lines + PREALLOC_LINES) * size);
+            if(!grown_p)
             {
-                /* The element is in the right place now */
-                break;
+                free(lines_p);
+                return NULL;
             }
+            lines_p = grown_p;
+            max_lines += PREALLOC_LINES;
         }
+
+        if(is_lean) ((uint32_t*)lines_p)[read_lines] = line_p - buf;
+        else ((char**)lines_p)[read_lines] = line_p;
+        ++read_lines;
+        line_p = newline_p + NEWLINE_LEN;
     }
+
+    *lines_num_p = read_lines;
+    return lines_p;
 }
 
-static size_t find_smallest_lin(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*))
+/* Sorts (key prefix, index) pairs of fixed size records in buf_p, then
+ * moves whole records into sorted order in one pass
+ * @return 0 on success, -1 on error
+ */
+static int sort_records(const struct options* opts_p, const struct algorithm* alg_p,
+    const char* buf_p, size_t buf_len)
 {
-    size_t smallest_idx = 0;
-    for(size_t idx = 1; idx < nmemb; ++idx)
+    const struct record_layout* layout_p = &opts_p->record;
+    if(buf_len % layout_p->size)
     {
-        /* New smallest? */
-        if(compar(base + idx * size, base + smallest_idx * size) < 0)
+        fprintf(stderr, "Input is not a whole number of %zu byte records\n", layout_p->size);
+        return -1;
+    }
+    size_t records_num = buf_len / layout_p->size;
+    struct record_key* keys = malloc(records_num * sizeof(*keys));
+    char* out_p = malloc(buf_len);
+    if(records_num && (!keys || !out_p))
+    {
+        perror("Could not sort records");
+        free(out_p);
+        free(keys);
+        return -1;
+    }
+
+    prof_phase_begin(PROF_INDEX);
+    records_index(keys, buf_p, records_num, layout_p);
+    prof_phase_end(PROF_INDEX);
+
+    /* Unique mode outputs the first of equal keys, so it needs their order */
+    prof_phase_begin(PROF_SORT);
+    int result = records_sort_keys(keys, records_num, buf_p, layout_p, alg_p,
+        opts_p->is_stable || opts_p->is_unique);
+    if(!result) records_permute(out_p, buf_p, keys, records_num, layout_p->size);
+    prof_phase_end(PROF_SORT);
+    if(result) perror("Could not sort records");
+
+    /* Sorted equal keys are adjacent, so duplicates go on the fly */
+    prof_phase_begin(PROF_WRITE);
+    size_t written_records = 0;
+    for(size_t i = 0; i < records_num && !result; ++i)
+    {
+        const char* rec_p = out_p + i * layout_p->size;
+        if(opts_p->is_unique && written_records &&
+           !memcmp(rec_p + layout_p->key_offset,
+               rec_p - layout_p->size + layout_p->key_offset, layout_p->key_len))
+        {
+            continue;
+        }
+        if(!opts_p->is_quiet && fwrite(rec_p, layout_p->size, 1, stdout) != 1)
         {
-            smallest_idx = idx;
+            perror("Could not write output");
+            result = -1;
         }
+        ++written_records;
     }
+    fflush(stdout);
+    prof_phase_end(PROF_WRITE);
 
-    return smallest_idx;
+    if(!result && opts_p->is_quiet)
+    {
+        prof_thread_merge();
+        prof_print_json(stdout, alg_p ? alg_p->name : "radix", records_num, written_records);
+    }
+
+    free(out_p);
+    free(keys);
+    return result;
+}
+
+/* @return 0 on success, -1 on error */
+static int write_line(struct front_writer* writer_p, const char* line, bool is_front_coded)
+{
+    if(is_front_coded) return front_write(writer_p, line, stdout);
+
+    fputs(line, stdout);
+    putchar('\n');
+    return 0;
 }
 
-void selection_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*))
+/* Sorted input of merge mode, read line by line. Lines alternate between
+ * two buffers, so the last written line stays valid while the next one
+ * of the same file is read.
+ */
+struct merge_input
+{
+    FILE* file_p;
+    char* lines[2];
+    size_t caps[2];
+    struct key_arena arenas[2];
+    unsigned int cur;
+};
+
+struct merge_ctx
+{
+    struct merge_input* inputs;
+    const struct key_opts* keys_p;
+    compar_fn compar;
+    size_t size;
+    bool is_unique;
+    bool is_quiet;
+    bool is_front_in;
+    bool is_front_out;
+    bool is_failed;
+    struct front_writer writer;
+    /* Last written element */
+    union
+    {
+        char* line;
+        struct keyed_line rec;
+    } last;
+    size_t read_lines;
+    size_t written_lines;
+};
+
+static bool merge_next(void* ctx_p, size_t src, void* elem)
 {
-    /* idx + 1 as there must be at least one more element to compare */
-    for(size_t idx = 0; idx + 1 < nmemb; ++idx)
+    struct merge_ctx* merge_p = ctx_p;
+    struct merge_input* input_p = &merge_p->inputs[src];
+    input_p->cur ^= 1;
+    char** line_pp = &input_p->lines[input_p->cur];
+    size_t* cap_p = &input_p->caps[input_p->cur];
+    if(merge_p->is_front_in)
     {
-        /* Find smallest element in the sub-array  */
-        size_t smallest_idx =
-            idx + find_smallest_lin(base + idx * size, nmemb - idx, size, compar);
-        if(idx == smallest_idx) continue;
-        swap(base + idx * size, base + smallest_idx * size, size);
+        /* Prefix comes from the previous line, still in the other buffer */
+        errno = 0;
+        if(front_read(line_pp, cap_p, input_p->lines[input_p->cur ^ 1], input_p->file_p) < 0)
+        {
+            if(errno == EINVAL) merge_p->is_failed = true;
+            return false;
+        }
     }
+    else
+    {
+        ssize_t len = getline(line_pp, cap_p, input_p->file_p);
+        if(len < 0) return false;
+        if(len && (*line_pp)[len - NEWLINE_LEN] == '\n') (*line_pp)[len - NEWLINE_LEN] = '\0';
+    }
+    ++merge_p->read_lines;
+
+    if(!merge_p->keys_p)
+    {
+        memcpy(elem, line_pp, sizeof(*line_pp));
+        return true;
+    }
+    struct key_arena* arena_p = &input_p->arenas[input_p->cur];
+    key_arena_reset(arena_p);
+    if(keys_build(elem, line_pp, 1, merge_p->keys_p, arena_p))
+    {
+        merge_p->is_failed = true;
+        return false;
+    }
+    return true;
+}
+
+/* The last element is replaced even by a dropped duplicate, the buffer
+ * of the one written before may be reused already
+ */
+static int merge_emit(void* ctx_p, size_t src, const void* elem)
+{
+    struct merge_ctx* merge_p = ctx_p;
+    bool is_duplicate = merge_p->is_unique && merge_p->written_lines &&
+        merge_p->compar(elem, &merge_p->last) == 0;
+    memcpy(&merge_p->last, elem, merge_p->size);
+    if(is_duplicate) return 0;
+
+    if(!merge_p->is_quiet &&
+       write_line(&merge_p->writer, merge_p->keys_p ? merge_p->last.rec.line :
+           merge_p->last.line, merge_p->is_front_out))
+    {
+        return -1;
+    }
+    ++merge_p->written_lines;
+    return 0;
+}
+
+/* Every file needs a descriptor, so their limit is raised up to the hard one */
+static void raise_files_limit(size_t files_num)
+{
+    struct rlimit limit;
+    if(getrlimit(RLIMIT_NOFILE, &limit)) return;
+    rlim_t needed = files_num + RESERVED_FDS;
+    if(limit.rlim_cur >= needed) return;
+
+    limit.rlim_cur = limit.rlim_max == RLIM_INFINITY || needed < limit.rlim_max ?
+        needed : limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
 }
 
-static void merge(void* base, size_t numa, size_t numb, size_t size,
-    int (*compar)(const void*, const void*))
+/* Merges already sorted files into stdout without sorting them again */
+static int merge_files(const struct options* opts_p)
 {
-    void* merged_p = malloc((numa + numb) * size);
-    void* a = base;
-    void* b = base + numa * size;
-    size_t idxa = 0;
-    size_t idxb = 0;
+    size_t k = opts_p->merge_paths_num;
+    struct merge_ctx merge = {.is_unique = opts_p->is_unique, .is_quiet = opts_p->is_quiet,
+        .is_front_in = opts_p->is_front_in, .is_front_out = opts_p->is_front_out};
+    merge.inputs = calloc(k, sizeof(*merge.inputs));
+    if(!merge.inputs)
+    {
+        perror("Could not merge");
+        return -1;
+    }
 
-    for(size_t i = 0; i < numa + numb; ++i)
+    raise_files_limit(k);
+    int result = 0;
+    for(size_t i = 0; i < k && !result; ++i)
     {
-        if(numa - idxa == 0)
+        const char* path = opts_p->merge_paths[i];
+        merge.inputs[i].file_p = strcmp(path, "-") ? fopen(path, "r") : stdin;
+        if(!merge.inputs[i].file_p)
         {
-            // no more items in "a"
-            memcpy(merged_p + i * size, b + idxb * size, size);
-            ++idxb;
-            continue;
+            perror("Could not open file");
+            result = -1;
         }
+    }
+
+    merge.size = sizeof(char*);
+    merge.compar = mystrcmp;
+    if(keys_needed(&opts_p->keys))
+    {
+        if(opts_p->keys.is_collate) setlocale(LC_COLLATE, "");
+        merge.keys_p = &opts_p->keys;
+        merge.size = sizeof(struct keyed_line);
+        merge.compar = keycmp;
+    }
+
+    bool is_heap = opts_p->merger == merger_heap;
+    if(!result)
+    {
+        prof_phase_begin(PROF_SORT);
+        result = (is_heap ? heap_merge : loser_tree_merge)(k, merge.size,
+            merge.compar, merge_next, merge_emit, &merge);
+        prof_phase_end(PROF_SORT);
+        fflush(stdout);
 
-        if(numb - idxb == 0)
+        if(result || merge.is_failed)
         {
-            // no more items in "b"
-            memcpy(merged_p + i * size, a + idxa * size, size);
-            ++idxa;
-            continue;
+            perror("Could not merge");
+            result = -1;
         }
+    }
 
-        if(compar(a + idxa * size, b + idxb * size) < 0)
+    if(!result && opts_p->is_quiet)
+    {
+        prof_thread_merge();
+        prof_print_json(stdout, is_heap ? "heap_merge" : "loser_tree_merge",
+            merge.read_lines, merge.written_lines);
+    }
+
+    for(size_t i = 0; i < k; ++i)
+    {
+        struct merge_input* input_p = &merge.inputs[i];
+        if(input_p->file_p)
         {
-            memcpy(merged_p + i * size, a + idxa * size, size);
-            ++idxa;
+            if(ferror(input_p->file_p))
+            {
+                perror("Could not read input");
+                result = -1;
+            }
+            if(input_p->file_p != stdin) fclose(input_p->file_p);
         }
-        else
+        for(size_t b = 0; b < 2; ++b)
         {
-            memcpy(merged_p + i * size, b + idxb * size, size);
-            ++idxb;
+            free(input_p->lines[b]);
+            key_arena_free(&input_p->arenas[b]);
         }
     }
-
-    memcpy(base, merged_p, (numa + numb) * size);
-    free(merged_p);
+    free(merge.inputs);
+    front_writer_free(&merge.writer);
+    return result;
 }
 
-void merge_sort(void* base, size_t nmemb, size_t size,
-    int (*compar)(const void*, const void*))
+static int parse_args(int argc, char* argv[], struct options* opts_p)
 {
-    if(nmemb > 2)
+    static const struct option long_opts[] =
+    {
+        {"unique", no_argument, NULL, 'u'},
+        {"stable", no_argument, NULL, 's'},
+        {"numeric-sort", no_argument, NULL, 'n'},
+        {"ignore-case", no_argument, NULL, 'f'},
+        {"key", required_argument, NULL, 'k'},
+        {"field-separator", required_argument, NULL, 't'},
+        {"collate", no_argument, NULL, 'L'},
+        {"threads", required_argument, NULL, 'j'},
+        {"merge", optional_argument, NULL, 'm'},
+        {"quiet", no_argument, NULL, 'q'},
+        {"lean", no_argument, NULL, 'l'},
+        {"front-coded", optional_argument, NULL, 'F'},
+        {"record", required_argument, NULL, 'R'},
+        {NULL, 0, NULL, 0}
+    };
+
+    memset(opts_p, 0, sizeof(*opts_p));
+
+    int opt;
+    while((opt = getopt_long(argc, argv, "usnfk:t:Lj:m::qlF::R:", long_opts, NULL)) != -1)
     {
-        merge_sort(base, nmemb - nmemb / 2, size, compar);
-        merge_sort(base + (nmemb - nmemb / 2) * size, nmemb / 2, size, compar);
+        switch(opt)
+        {
+            case 'u':
+                opts_p->is_unique = true;
+                break;
+            case 's':
+                opts_p->is_stable = true;
+                break;
+            case 'n':
+                opts_p->keys.is_numeric = true;
+                break;
+            case 'f':
+                opts_p->keys.is_fold = true;
+                break;
+            case 'k':
+                opts_p->keys.field = strtoul(optarg, NULL, 10);
+                if(opts_p->keys.field == KEY_WHOLE_LINE) return -1;
+                break;
+            case 't':
+                if(strlen(optarg) != 1) return -1;
+                opts_p->keys.separator = optarg[0];
+                break;
+            case 'L':
+                opts_p->keys.is_collate = true;
+                break;
+            case 'j':
+                opts_p->threads_num = strtoul(optarg, NULL, 10);
+                if(!opts_p->threads_num) return -1;
+                break;
+            case 'm':
+                if(!optarg || !strcmp(optarg, "loser")) opts_p->merger = merger_loser_tree;
+                else if(!strcmp(optarg, "heap")) opts_p->merger = merger_heap;
+                else return -1;
+                break;
+            case 'q':
+                opts_p->is_quiet = true;
+                break;
+            case 'l':
+                opts_p->is_lean = true;
+                break;
+            case 'R':
+            {
+                /* SIZE[:OFFSET[:LEN]], key is the rest of the record by default */
+                struct record_layout* layout_p = &opts_p->record;
+                char* end_p;
+                layout_p->size = strtoul(optarg, &end_p, 10);
+                layout_p->key_offset = *end_p == ':' ? strtoul(end_p + 1, &end_p, 10) : 0;
+                layout_p->key_len = *end_p == ':' ? strtoul(end_p + 1, &end_p, 10) :
+                    layout_p->size - layout_p->key_offset;
+                if(*end_p || !records_layout_valid(layout_p)) return -1;
+                break;
+            }
+            case 'F':
+                if(!optarg || !strcmp(optarg, "out")) opts_p->is_front_out = true;
+                else if(!strcmp(optarg, "in")) opts_p->is_front_in = true;
+                else if(!strcmp(optarg, "both")) opts_p->is_front_in = opts_p->is_front_out = true;
+                else return -1;
+                break;
+            default:
+                return -1;
+        }
+    }
+
+    /* Records have no lines to build keys of or to merge */
+    if(opts_p->record.size && (keys_needed(&opts_p->keys) || opts_p->merger != merger_none))
+    {
+        return -1;
+    }
+
+    char** args = argv + optind;
+    if(opts_p->merger != merger_none)
+    {
+        if(argc == optind) return -1;
+        opts_p->merge_paths = args;
+        opts_p->merge_paths_num = argc - optind;
+        return 0;
+    }
+
+    switch(argc - optind)
+    {
+        case EXPECTED_ARGS_STDIN:
+            opts_p->sel_input = input_stdin;
+            break;
+        case EXPECTED_ARGS_FILE:
+            opts_p->sel_input = input_file;
+            opts_p->file_path = args[FILE_PATH_IDX];
+            break;
+        default:
+            return -1;
     }
 
-    merge(base,
-          nmemb - nmemb / 2,
-          nmemb / 2,
-          size,
-          compar);
+    opts_p->alg_flag = args[ALGORITHM_FLAG_IDX];
+    /* Check for quiet mode */
+    opts_p->is_quiet |= opts_p->alg_flag[0] != '\0' && opts_p->alg_flag[1] == 'q';
+    return 0;
 }
 
 static void print_help(void)
 {
     printf("Syntax:\n\
-    mysort ALGORITHM [FILE]\n\n\
+    mysort [OPTIONS] ALGORITHM [FILE]\n\
+    mysort [OPTIONS] --merge[=MERGER] FILE...\n\n\
     algorithms:\n\
     b - bubble\n\
     q - quick (stdlib)\n\
     i - insertion\n\
     s - selection\n\
     m - merge\n\
+    h - heap\n\
+    d - dutch flag quick (3-way partitioning)\n\
+    p - parallel sample sort\n\
+    r - LSD radix sort of key prefixes, records (-R) only\n\
+    \n\
+    options:\n\
+    -u, --unique          - output only the first of equal lines (keys),\n\
+                            merge (m) drops them already while sorting,\n\
+                            so does 3-way quick (d) without keys\n\
+    -s, --stable          - keep original order of equal lines (keys),\n\
+                            b, i and m are stable by themselves, others\n\
+                            break ties by original position of lines\n\
+    -n, --numeric-sort    - compare leading decimal numbers by value\n\
+    -f, --ignore-case     - fold lower case to upper case\n\
+    -k, --key=N           - compare only N-th field, counted from 1\n\
+    -t, --field-separator=C - fields are split by C, not by blanks\n\
+    -L, --collate         - compare by collation order of current locale\n\
+    -j, --threads=N       - sort by N threads, by default one per CPU,\n\
+                            only sample sort (p) uses more than one\n\
+    -m, --merge[=MERGER]  - merge already sorted files, - is stdin,\n\
+                            equal lines come in order of files, MERGER\n\
+                            is loser (tree, default) or heap\n\
+    -q, --quiet           - same as 'q' after algorithm\n\
+    -l, --lean            - refer to lines by 32-bit offsets instead of\n\
+                            pointers, when there are no key options\n\
+    -R, --record=SIZE[:OFFSET[:LEN]] - input is binary records of SIZE\n\
+                            bytes, sorted by LEN bytes of key at OFFSET,\n\
+                            by the rest of the record by default\n\
+    -F, --front-coded[=WHICH] - lines of output (out, default), merged\n\
+                            files (in) or both are front coded: length\n\
+                            of prefix shared with the previous line as\n\
+                            LEB128, then the rest of the line\n\
+    \n\
+    Key options build a byte comparable key of each line once, before\n\
+    sorting, so they don't slow down comparisons.\n\
     \n\
     Add 'q' after algorithm for quiet mode, e.g.:\n\
-    ./mysort bq lines_to_sort.txt\n");
+    ./mysort bq lines_to_sort.txt\n\
+    Quiet mode prints line counts, compars, swaps, moves and time\n\
+    of each phase (read, index, sort, write) as a single line JSON object.\n");
 }
 
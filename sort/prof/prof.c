@@ -0,0 +1,118 @@
+#ifndef NO_PROFILE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "prof.h"
+
+#define NSEC_PER_SEC 1000000000ULL
+
+_Thread_local uint64_t prof_local[PROF_COUNTERS_NUM];
+
+/* Totals merged from all threads */
+static _Atomic uint64_t totals[PROF_COUNTERS_NUM];
+
+/* Phases are sequential and driven by one thread, no need for atomics */
+static uint64_t phase_start_ns[PROF_PHASES_NUM];
+static uint64_t phase_ns[PROF_PHASES_NUM];
+
+static const char* const counter_names[PROF_COUNTERS_NUM] =
+{
+    [PROF_COMPARS] = "compars",
+    [PROF_SWAPS]   = "swaps",
+    [PROF_MOVES]   = "moves",
+};
+
+static const char* const phase_names[PROF_PHASES_NUM] =
+{
+    [PROF_READ]  = "read",
+    [PROF_INDEX] = "index",
+    [PROF_SORT]  = "sort",
+    [PROF_WRITE] = "write",
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+void prof_phase_begin(enum prof_phase phase)
+{
+    phase_start_ns[phase] = now_ns();
+}
+
+void prof_phase_end(enum prof_phase phase)
+{
+    phase_ns[phase] += now_ns() - phase_start_ns[phase];
+}
+
+/* Every thread which counted something must call this before it exits,
+ * the main thread calls it before reading totals.
+ */
+void prof_thread_merge(void)
+{
+    for(size_t c = 0; c < PROF_COUNTERS_NUM; ++c)
+    {
+        atomic_fetch_add_explicit(&totals[c], prof_local[c], memory_order_relaxed);
+        prof_local[c] = 0;
+    }
+}
+
+uint64_t prof_total(enum prof_counter counter)
+{
+    return atomic_load_explicit(&totals[counter], memory_order_relaxed);
+}
+
+uint64_t prof_phase_ns(enum prof_phase phase)
+{
+    return phase_ns[phase];
+}
+
+uint64_t prof_peak_rss_kb(void)
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage)) return 0;
+    return usage.ru_maxrss;
+}
+
+void prof_reset(void)
+{
+    for(size_t c = 0; c < PROF_COUNTERS_NUM; ++c)
+    {
+        atomic_store_explicit(&totals[c], 0, memory_order_relaxed);
+        prof_local[c] = 0;
+    }
+    for(size_t p = 0; p < PROF_PHASES_NUM; ++p)
+    {
+        phase_start_ns[p] = 0;
+        phase_ns[p] = 0;
+    }
+}
+
+/* Single line JSON object, easy to collect from many runs */
+void prof_print_json(FILE* stream, const char* algorithm, size_t lines,
+    size_t out_lines)
+{
+    fprintf(stream, "{\"algorithm\":\"%s\",\"lines\":%zu,\"output_lines\":%zu",
+        algorithm, lines, out_lines);
+    for(size_t c = 0; c < PROF_COUNTERS_NUM; ++c)
+    {
+        fprintf(stream, ",\"%s\":%llu", counter_names[c],
+            (unsigned long long)prof_total(c));
+    }
+    fprintf(stream, ",\"time_ns\":{");
+    for(size_t p = 0; p < PROF_PHASES_NUM; ++p)
+    {
+        fprintf(stream, "%s\"%s\":%llu", p ? "," : "", phase_names[p],
+            (unsigned long long)phase_ns[p]);
+    }
+    fprintf(stream, "},\"peak_rss_kb\":%llu}\n",
+        (unsigned long long)prof_peak_rss_kb());
+}
+
+#endif /* NO_PROFILE */
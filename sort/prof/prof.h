@@ -0,0 +1,67 @@
+#ifndef PROF_H_
+#define PROF_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Operation counters, kept per thread and merged by prof_thread_merge() */
+enum prof_counter
+{
+    PROF_COMPARS,
+    PROF_SWAPS,
+    PROF_MOVES,
+    PROF_COUNTERS_NUM
+};
+
+/* Phases of a single mysort run, timed by the main thread */
+enum prof_phase
+{
+    PROF_READ,
+    PROF_INDEX,
+    PROF_SORT,
+    PROF_WRITE,
+    PROF_PHASES_NUM
+};
+
+#ifndef NO_PROFILE
+
+/* Hot path increments touch only thread-local storage, no atomics */
+extern _Thread_local uint64_t prof_local[PROF_COUNTERS_NUM];
+
+#define PROF_INC(counter)     (++prof_local[(counter)])
+#define PROF_ADD(counter, n)  (prof_local[(counter)] += (n))
+
+void prof_phase_begin(enum prof_phase phase);
+void prof_phase_end(enum prof_phase phase);
+void prof_thread_merge(void);
+uint64_t prof_total(enum prof_counter counter);
+uint64_t prof_phase_ns(enum prof_phase phase);
+/* Largest resident set of the process so far, in KiB */
+uint64_t prof_peak_rss_kb(void);
+void prof_reset(void);
+void prof_print_json(FILE* stream, const char* algorithm, size_t lines,
+    size_t out_lines);
+
+#else /* NO_PROFILE */
+
+#define PROF_INC(counter)     ((void)0)
+#define PROF_ADD(counter, n)  ((void)0)
+
+static inline void prof_phase_begin(enum prof_phase phase) {}
+static inline void prof_phase_end(enum prof_phase phase) {}
+static inline void prof_thread_merge(void) {}
+static inline uint64_t prof_total(enum prof_counter counter) { return 0; }
+static inline uint64_t prof_phase_ns(enum prof_phase phase) { return 0; }
+static inline uint64_t prof_peak_rss_kb(void) { return 0; }
+static inline void prof_reset(void) {}
+/* Counters are compiled out, the rest stays machine readable */
+static inline void prof_print_json(FILE* stream, const char* algorithm,
+    size_t lines, size_t out_lines)
+{
+    fprintf(stream, "{\"algorithm\":\"%s\",\"lines\":%zu,\"output_lines\":%zu}\n",
+        algorithm, lines, out_lines);
+}
+
+#endif /* NO_PROFILE */
+
+#endif /* PROF_H_ */
@@ -0,0 +1,77 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "prof.h"
+
+#define THREADS_NUM     4U
+#define INCS_PER_THREAD 100000U
+
+static void* count_in_thread(void* arg)
+{
+    (void)arg;
+    for(unsigned int i = 0; i < INCS_PER_THREAD; ++i)
+    {
+        PROF_INC(PROF_COMPARS);
+    }
+    PROF_ADD(PROF_SWAPS, 3);
+    prof_thread_merge();
+    return NULL;
+}
+
+Test(prof_functionals, merge_thread_counters)
+{
+    prof_reset();
+    pthread_t threads[THREADS_NUM];
+    for(unsigned int i = 0; i < THREADS_NUM; ++i)
+    {
+        cr_assert_eq(0, pthread_create(&threads[i], NULL, count_in_thread, NULL));
+    }
+    for(unsigned int i = 0; i < THREADS_NUM; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    // nothing is visible until the thread merges its local counters
+    cr_assert_eq(prof_total(PROF_COMPARS), THREADS_NUM * INCS_PER_THREAD);
+    cr_assert_eq(prof_total(PROF_SWAPS), THREADS_NUM * 3);
+    cr_assert_eq(prof_total(PROF_MOVES), 0);
+}
+
+Test(prof_functionals, merge_resets_local)
+{
+    prof_reset();
+    PROF_INC(PROF_MOVES);
+    prof_thread_merge();
+    prof_thread_merge();
+    cr_assert_eq(prof_total(PROF_MOVES), 1);
+}
+
+Test(prof_functionals, phases_accumulate)
+{
+    prof_reset();
+    prof_phase_begin(PROF_SORT);
+    prof_phase_end(PROF_SORT);
+    uint64_t first = prof_phase_ns(PROF_SORT);
+    prof_phase_begin(PROF_SORT);
+    for(volatile int i = 0; i < 100000; ++i);
+    prof_phase_end(PROF_SORT);
+    cr_assert_gt(prof_phase_ns(PROF_SORT), first);
+    cr_assert_eq(prof_phase_ns(PROF_READ), 0);
+}
+/* Touched pages count, peak never goes down */
+Test(prof_functionals, peak_rss_grows)
+{
+    const size_t len = 64U << 20;
+    uint64_t before = prof_peak_rss_kb();
+    cr_assert_gt(before, 0);
+    char* buf = malloc(len);
+    cr_assert_not_null(buf);
+    memset(buf, 1, len);
+    uint64_t peak = prof_peak_rss_kb();
+    free(buf);
+    cr_assert_geq(peak, before + len / 1024 / 2);
+    cr_assert_geq(prof_peak_rss_kb(), peak);
+}
+#endif
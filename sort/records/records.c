@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "records.h"
+#include "../prof/prof.h"
+
+#define RADIX_BITS      8U
+#define RADIX_BUCKETS  (1U << RADIX_BITS)
+#define RADIX_MASK     (RADIX_BUCKETS - 1U)
+#define BITS_PER_BYTE   8U
+
+/* Records and their layout for compar functions, which take no context */
+static const unsigned char* sorted_recs = NULL;
+static const struct record_layout* sorted_layout_p = NULL;
+
+bool records_layout_valid(const struct record_layout* layout_p)
+{
+    return layout_p->size && layout_p->key_len &&
+        layout_p->key_offset <= layout_p->size &&
+        layout_p->key_len <= layout_p->size - layout_p->key_offset;
+}
+
+void records_index(struct record_key* keys, const void* recs, size_t nmemb,
+    const struct record_layout* layout_p)
+{
+    size_t prefix_len = layout_p->key_len < RECORD_PREFIX_LEN ?
+        layout_p->key_len : RECORD_PREFIX_LEN;
+    const unsigned char* key_p = (const unsigned char*)recs + layout_p->key_offset;
+    for(size_t i = 0; i < nmemb; ++i, key_p += layout_p->size)
+    {
+        /* Missing bytes of short keys are zero, they sort first anyway */
+        uint64_t prefix = 0;
+        for(size_t b = 0; b < RECORD_PREFIX_LEN; ++b)
+        {
+            prefix = prefix << BITS_PER_BYTE | (b < prefix_len ? key_p[b] : 0);
+        }
+        keys[i].prefix = prefix;
+        keys[i].idx = i;
+    }
+}
+
+/* Bytes of the key after the prefix */
+static int compare_rest(const struct record_key* a, const struct record_key* b)
+{
+    const struct record_layout* layout_p = sorted_layout_p;
+    if(layout_p->key_len <= RECORD_PREFIX_LEN) return 0;
+
+    size_t offset = layout_p->key_offset + RECORD_PREFIX_LEN;
+    return memcmp(sorted_recs + a->idx * layout_p->size + offset,
+        sorted_recs + b->idx * layout_p->size + offset,
+        layout_p->key_len - RECORD_PREFIX_LEN);
+}
+
+static int record_keycmp(const void* p1, const void* p2)
+{
+    const struct record_key* a = p1;
+    const struct record_key* b = p2;
+
+    /* For comparing complexity */
+    PROF_INC(PROF_COMPARS);
+
+    if(a->prefix != b->prefix) return a->prefix < b->prefix ? -1 : 1;
+    int result = compare_rest(a, b);
+    return (result > 0) - (result < 0);
+}
+
+static int record_keycmp_stable(const void* p1, const void* p2)
+{
+    int result = record_keycmp(p1, p2);
+    if(result) return result;
+
+    uint64_t a = ((const struct record_key*)p1)->idx;
+    uint64_t b = ((const struct record_key*)p2)->idx;
+    return (a > b) - (a < b);
+}
+
+/* Stable LSD radix sort of prefixes, byte by byte from the last one.
+ * Histograms of all bytes come from one pass, bytes equal in every
+ * prefix need no pass at all.
+ * @return 0 on success, -1 on allocation failure
+ */
+static int radix_sort(struct record_key* keys, size_t nmemb)
+{
+    size_t (*counts)[RADIX_BUCKETS] = calloc(RECORD_PREFIX_LEN, sizeof(*counts));
+    struct record_key* tmp = malloc(nmemb * sizeof(*tmp));
+    if(!counts || !tmp)
+    {
+        free(tmp);
+        free(counts);
+        return -1;
+    }
+
+    for(size_t i = 0; i < nmemb; ++i)
+    {
+        for(size_t b = 0; b < RECORD_PREFIX_LEN; ++b)
+        {
+            ++counts[b][keys[i].prefix >> (b * BITS_PER_BYTE) & RADIX_MASK];
+        }
+    }
+
+    struct record_key* from = keys;
+    struct record_key* to = tmp;
+    for(size_t b = 0; b < RECORD_PREFIX_LEN; ++b)
+    {
+        unsigned int shift = b * BITS_PER_BYTE;
+        if(counts[b][from[0].prefix >> shift & RADIX_MASK] == nmemb) continue;
+
+        size_t pos = 0;
+        for(size_t d = 0; d < RADIX_BUCKETS; ++d)
+        {
+            size_t count = counts[b][d];
+            counts[b][d] = pos;
+            pos += count;
+        }
+        for(size_t i = 0; i < nmemb; ++i)
+        {
+            to[counts[b][from[i].prefix >> shift & RADIX_MASK]++] = from[i];
+        }
+
+        /* For comparing complexity, distribution moves instead of swapping */
+        PROF_ADD(PROF_MOVES, nmemb);
+        struct record_key* swap = from;
+        from = to;
+        to = swap;
+    }
+
+    if(from != keys) memcpy(keys, from, nmemb * sizeof(*keys));
+    free(tmp);
+    free(counts);
+    return 0;
+}
+
+int records_sort_keys(struct record_key* keys, size_t nmemb, const void* recs,
+    const struct record_layout* layout_p, const struct algorithm* alg_p,
+    bool is_stable)
+{
+    sorted_recs = recs;
+    sorted_layout_p = layout_p;
+    if(!nmemb) return 0;
+
+    if(alg_p)
+    {
+        bool is_tie_broken = is_stable && !alg_p->is_stable;
+        alg_p->sort(keys, nmemb, sizeof(*keys),
+            is_tie_broken ? record_keycmp_stable : record_keycmp);
+        return 0;
+    }
+
+    if(radix_sort(keys, nmemb)) return -1;
+    if(layout_p->key_len <= RECORD_PREFIX_LEN) return 0;
+
+    /* Keys longer than prefixes are sorted within runs of equal prefixes,
+     * radix sort kept them in order of indexes, so stable mode keeps it
+     */
+    compar_fn compar = is_stable ? record_keycmp_stable : record_keycmp;
+    size_t start = 0;
+    for(size_t i = 1; i <= nmemb; ++i)
+    {
+        if(i < nmemb && keys[i].prefix == keys[start].prefix) continue;
+        if(i - start > 1) quick3_sort(keys + start, i - start, sizeof(*keys), compar);
+        start = i;
+    }
+    return 0;
+}
+
+void records_permute(void* out, const void* recs, const struct record_key* keys,
+    size_t nmemb, size_t size)
+{
+    /* For comparing complexity, records are moved once */
+    PROF_ADD(PROF_MOVES, nmemb);
+    unsigned char* out_p = out;
+    for(size_t i = 0; i < nmemb; ++i, out_p += size)
+    {
+        memcpy(out_p, (const unsigned char*)recs + keys[i].idx * size, size);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef RECORDS_H_
+#define RECORDS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../algos/algos.h"
+
+/* Key bytes held by struct record_key, longer keys are compared
+ * further in the records
+ */
+#define RECORD_PREFIX_LEN sizeof(uint64_t)
+
+/* Fixed size binary records with the key at a fixed place */
+struct record_layout
+{
+    size_t size;
+    size_t key_offset;
+    size_t key_len;
+};
+
+/* Sorted instead of whole records, prefix is the first key bytes in
+ * big endian order, so comparing prefixes as numbers compares bytes
+ */
+struct record_key
+{
+    uint64_t prefix;
+    uint64_t idx;
+};
+
+/* @return true when the key lies within non-empty records */
+bool records_layout_valid(const struct record_layout* layout_p);
+
+void records_index(struct record_key* keys, const void* recs, size_t nmemb,
+    const struct record_layout* layout_p);
+
+/* Sorts keys of recs by the algorithm, or by LSD radix sort of prefixes
+ * when alg_p is NULL. Stable mode orders equal keys by index. Not
+ * reentrant, compar functions find recs through file-scope state.
+ * @return 0 on success, -1 on allocation failure
+ */
+int records_sort_keys(struct record_key* keys, size_t nmemb, const void* recs,
+    const struct record_layout* layout_p, const struct algorithm* alg_p,
+    bool is_stable);
+
+/* Moves records to out in order of keys, a single pass */
+void records_permute(void* out, const void* recs, const struct record_key* keys,
+    size_t nmemb, size_t size);
+
+#endif /* RECORDS_H_ */
@@ -0,0 +1,123 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include "records.h"
+#include "../sample/sample_sort.h"
+
+#define NMEMB   (SAMPLE_SORT_MIN + 1000U)
+#define SEED    2022U
+
+/* Records carry their original index in the payload */
+static unsigned char* make_recs(const struct record_layout* layout_p, size_t nmemb,
+    unsigned int key_values)
+{
+    unsigned char* recs = malloc(nmemb * layout_p->size);
+    cr_assert_not_null(recs);
+    for(size_t i = 0; i < nmemb; ++i)
+    {
+        unsigned char* rec_p = recs + i * layout_p->size;
+        memset(rec_p, 0xEE, layout_p->size);
+        for(size_t b = 0; b < layout_p->key_len; ++b)
+        {
+            rec_p[layout_p->key_offset + b] = rand() % key_values;
+        }
+        size_t payload = layout_p->key_offset ? 0 : layout_p->key_len;
+        memcpy(rec_p + payload, &i, sizeof(i));
+    }
+    return recs;
+}
+
+static size_t rec_idx(const unsigned char* rec_p, const struct record_layout* layout_p)
+{
+    size_t idx;
+    memcpy(&idx, rec_p + (layout_p->key_offset ? 0 : layout_p->key_len), sizeof(idx));
+    return idx;
+}
+
+/* Keys don't descend, every record is there once, equal keys keep
+ * original order in stable mode
+ */
+static void check_sorted(const unsigned char* out, const struct record_layout* layout_p,
+    size_t nmemb, bool is_stable, const char* name)
+{
+    char* seen = calloc(nmemb, 1);
+    cr_assert_not_null(seen);
+    for(size_t i = 0; i < nmemb; ++i)
+    {
+        const unsigned char* rec_p = out + i * layout_p->size;
+        size_t idx = rec_idx(rec_p, layout_p);
+        cr_assert_lt(idx, nmemb, "%s: bad record at %zu", name, i);
+        cr_assert_not(seen[idx], "%s: record %zu twice", name, idx);
+        seen[idx] = 1;
+        if(!i) continue;
+
+        const unsigned char* prev_p = rec_p - layout_p->size;
+        int result = memcmp(prev_p + layout_p->key_offset, rec_p + layout_p->key_offset,
+            layout_p->key_len);
+        cr_assert_leq(result, 0, "%s: not sorted at %zu", name, i);
+        if(is_stable && !result)
+        {
+            cr_assert_lt(rec_idx(prev_p, layout_p), idx, "%s: not stable at %zu", name, i);
+        }
+    }
+    free(seen);
+}
+
+static void check_layout(const struct record_layout* layout_p, unsigned int key_values)
+{
+    cr_assert(records_layout_valid(layout_p));
+    const char flags[] = {'r', 'd', 'm', 'p', 'h'};
+    for(size_t f = 0; f < sizeof(flags); ++f)
+    {
+        const struct algorithm* alg_p = flags[f] == 'r' ? NULL : algorithm_by_flag(flags[f]);
+        const char* name = alg_p ? alg_p->name : "radix";
+        for(int is_stable = 0; is_stable < 2; ++is_stable)
+        {
+            srand(SEED);
+            unsigned char* recs = make_recs(layout_p, NMEMB, key_values);
+            struct record_key* keys = malloc(NMEMB * sizeof(*keys));
+            unsigned char* out = malloc(NMEMB * layout_p->size);
+            cr_assert(keys && out);
+
+            records_index(keys, recs, NMEMB, layout_p);
+            cr_assert_eq(0, records_sort_keys(keys, NMEMB, recs, layout_p, alg_p, is_stable));
+            records_permute(out, recs, keys, NMEMB, layout_p->size);
+            check_sorted(out, layout_p, NMEMB, is_stable, name);
+            free(out);
+            free(keys);
+            free(recs);
+        }
+    }
+}
+
+/* sortbenchmark.org style, keys longer than prefixes */
+Test(records_functionals, long_keys)
+{
+    struct record_layout layout = {.size = 100, .key_offset = 0, .key_len = 10};
+    check_layout(&layout, 256);
+}
+
+/* Few values per byte, so prefixes repeat and the rest decides */
+Test(records_functionals, long_keys_equal_prefixes)
+{
+    struct record_layout layout = {.size = 40, .key_offset = 0, .key_len = 12};
+    check_layout(&layout, 2);
+}
+
+/* Short key inside the record, many equal keys */
+Test(records_functionals, short_key_at_offset)
+{
+    struct record_layout layout = {.size = 16, .key_offset = 12, .key_len = 3};
+    check_layout(&layout, 10);
+}
+
+Test(records_functionals, layout_valid)
+{
+    cr_assert_not(records_layout_valid(&(struct record_layout){0, 0, 0}));
+    cr_assert_not(records_layout_valid(&(struct record_layout){10, 0, 0}));
+    cr_assert_not(records_layout_valid(&(struct record_layout){10, 8, 3}));
+    cr_assert_not(records_layout_valid(&(struct record_layout){10, 11, 1}));
+    cr_assert(records_layout_valid(&(struct record_layout){10, 7, 3}));
+}
+#endif
@@ -0,0 +1,402 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "sample_sort.h"
+#include "../algos/algos.h"
+#include "../prof/prof.h"
+
+/* Every bucket is split into elements less than its upper splitter
+ * and equal to it, the latter are sorted already
+ */
+#define SLOTS           (2U * SAMPLE_SORT_BUCKETS)
+#define SAMPLE_LEN      (SAMPLE_SORT_BUCKETS * SAMPLE_SORT_OVERSAMPLING)
+#define PAGE_LEN        4096U
+#define NODE_CPULIST    "/sys/devices/system/node/node%u/cpulist"
+#define CPULIST_LEN     8192U
+
+static unsigned int threads_setting = 0;
+
+struct sample_ctx
+{
+    void* base;
+    void* tmp;
+    /* Slot of every element, found once and used for moving it */
+    uint16_t* oracle;
+    size_t nmemb;
+    size_t size;
+    int (*compar)(const void*, const void*);
+    /* Sorted splitters and the same as an implicit search tree, children
+     * of node j are 2j and 2j + 1, node 0 is unused
+     */
+    void* splitters;
+    void* tree;
+    bool is_eq_slots;
+    unsigned int threads_num;
+    /* Per thread element counts of each slot, then write positions */
+    size_t (*counts)[SLOTS];
+    /* Slots are laid out one after another, starts[SLOTS] is nmemb */
+    size_t starts[SLOTS + 1];
+    int cpus[CPU_SETSIZE];
+    unsigned int cpus_c;
+    pthread_t* threads;
+    struct task* tasks;
+};
+
+struct task
+{
+    struct sample_ctx* ctx_p;
+    unsigned int idx;
+};
+
+static unsigned int order_cpus(int* cpus);
+static void pick_splitters(struct sample_ctx* ctx_p, void* sample);
+static void classify(const struct sample_ctx* ctx_p, size_t first, size_t n,
+    uint16_t* slots);
+static void* classify_task(void* task_p);
+static void* scatter_task(void* task_p);
+static void* sort_task(void* task_p);
+static void run_tasks(struct sample_ctx* ctx_p, void* (*task_fn)(void*));
+
+void sample_sort_set_threads(unsigned int threads_num)
+{
+    threads_setting = threads_num;
+}
+
+void sample_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*))
+{
+    if(nmemb < SAMPLE_SORT_MIN)
+    {
+        quick3_sort(base, nmemb, size, compar);
+        return;
+    }
+
+    struct sample_ctx ctx = {.base = base, .nmemb = nmemb, .size = size, .compar = compar};
+    ctx.cpus_c = order_cpus(ctx.cpus);
+    ctx.threads_num = threads_setting;
+    if(!ctx.threads_num)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        ctx.threads_num = ctx.cpus_c ? ctx.cpus_c : (online > 0 ? online : 1);
+    }
+
+    ctx.tmp = malloc(nmemb * size);
+    ctx.oracle = malloc(nmemb * sizeof(*ctx.oracle));
+    ctx.counts = malloc(ctx.threads_num * sizeof(*ctx.counts));
+    ctx.splitters = malloc((SAMPLE_SORT_BUCKETS - 1) * size);
+    ctx.tree = malloc(SAMPLE_SORT_BUCKETS * size);
+    ctx.threads = malloc(ctx.threads_num * sizeof(*ctx.threads));
+    ctx.tasks = malloc(ctx.threads_num * sizeof(*ctx.tasks));
+    void* sample = malloc(SAMPLE_LEN * size);
+    if(ctx.tmp && ctx.oracle && ctx.counts && ctx.splitters && ctx.tree &&
+       ctx.threads && ctx.tasks && sample)
+    {
+        pick_splitters(&ctx, sample);
+        run_tasks(&ctx, classify_task);
+
+        /* Slots follow each other, within a slot threads write
+         * their elements one after another
+         */
+        size_t pos = 0;
+        for(size_t s = 0; s < SLOTS; ++s)
+        {
+            ctx.starts[s] = pos;
+            for(unsigned int t = 0; t < ctx.threads_num; ++t)
+            {
+                size_t count = ctx.counts[t][s];
+                ctx.counts[t][s] = pos;
+                pos += count;
+            }
+        }
+        ctx.starts[SLOTS] = pos;
+
+        run_tasks(&ctx, scatter_task);
+        run_tasks(&ctx, sort_task);
+    }
+    else
+    {
+        /* No room to distribute, sort in place */
+        quick3_sort(base, nmemb, size, compar);
+    }
+
+    free(sample);
+    free(ctx.tasks);
+    free(ctx.threads);
+    free(ctx.tree);
+    free(ctx.splitters);
+    free(ctx.counts);
+    free(ctx.oracle);
+    free(ctx.tmp);
+}
+
+/* Sizes of pointers and keyed lines become single moves */
+static inline void copy_elem(void* dest, const void* src, size_t size)
+{
+    if(size == sizeof(void*)) memcpy(dest, src, sizeof(void*));
+    else if(size == 2 * sizeof(void*)) memcpy(dest, src, 2 * sizeof(void*));
+    else memcpy(dest, src, size);
+}
+
+static size_t stripe_begin(const struct sample_ctx* ctx_p, unsigned int idx)
+{
+    return ctx_p->nmemb / ctx_p->threads_num * idx +
+        ctx_p->nmemb % ctx_p->threads_num * idx / ctx_p->threads_num;
+}
+
+/* Threads own slots which start in their stripe, so owned ranges
+ * are contiguous and cover the array
+ * @return first element of slots owned by thread idx
+ */
+static size_t owned_begin(const struct sample_ctx* ctx_p, unsigned int idx)
+{
+    if(idx == ctx_p->threads_num) return ctx_p->nmemb;
+
+    size_t begin = stripe_begin(ctx_p, idx);
+    size_t s = 0;
+    while(ctx_p->starts[s] < begin) ++s;
+    return ctx_p->starts[s];
+}
+
+/* Cheap stateless hash, so sampled positions are spread pseudo-randomly */
+static uint64_t sample_hash(uint64_t x)
+{
+    uint64_t z = x * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Equally spaced elements of a sorted sample become splitters. Equal
+ * splitters mean some element is frequent, then its equal slots are used.
+ */
+static void pick_splitters(struct sample_ctx* ctx_p, void* sample)
+{
+    const size_t size = ctx_p->size;
+    for(size_t i = 0; i < SAMPLE_LEN; ++i)
+    {
+        size_t idx = sample_hash(ctx_p->nmemb ^ (i << 32)) % ctx_p->nmemb;
+        copy_elem(sample + i * size, ctx_p->base + idx * size, size);
+    }
+    quick3_sort(sample, SAMPLE_LEN, size, ctx_p->compar);
+
+    ctx_p->is_eq_slots = false;
+    for(size_t s = 0; s < SAMPLE_SORT_BUCKETS - 1; ++s)
+    {
+        copy_elem(ctx_p->splitters + s * size,
+            sample + (s + 1) * SAMPLE_SORT_OVERSAMPLING * size, size);
+        if(s && !ctx_p->is_eq_slots &&
+           ctx_p->compar(ctx_p->splitters + (s - 1) * size,
+               ctx_p->splitters + s * size) == 0)
+        {
+            ctx_p->is_eq_slots = true;
+        }
+    }
+
+    /* Node at position p of level l splits its subtree in halves */
+    for(size_t j = 1; j < SAMPLE_SORT_BUCKETS; ++j)
+    {
+        unsigned int level = 63 - __builtin_clzll(j);
+        size_t p = j - ((size_t)1 << level);
+        size_t s = ((2 * p + 1) << (SAMPLE_SORT_BUCKETS_LOG - level - 1)) - 1;
+        copy_elem(ctx_p->tree + j * size, ctx_p->splitters + s * size, size);
+    }
+}
+
+/* Descends the tree for n elements at once, the next node depends only
+ * on a compare result turned into 0 or 1, so there are no branches to
+ * mispredict and compares of different elements overlap
+ */
+static void classify(const struct sample_ctx* ctx_p, size_t first, size_t n,
+    uint16_t* slots)
+{
+    const size_t size = ctx_p->size;
+    const void* elems = ctx_p->base + first * size;
+    size_t j[SAMPLE_SORT_BATCH];
+    for(size_t e = 0; e < n; ++e)
+    {
+        j[e] = 1;
+    }
+    for(unsigned int level = 0; level < SAMPLE_SORT_BUCKETS_LOG; ++level)
+    {
+        for(size_t e = 0; e < n; ++e)
+        {
+            j[e] = 2 * j[e] + (ctx_p->compar(ctx_p->tree + j[e] * size, elems + e * size) < 0);
+        }
+    }
+
+    /* Bucket b holds elements greater than splitter b - 1 and not
+     * greater than splitter b
+     */
+    for(size_t e = 0; e < n; ++e)
+    {
+        size_t bucket = j[e] - SAMPLE_SORT_BUCKETS;
+        bool is_eq = ctx_p->is_eq_slots && bucket < SAMPLE_SORT_BUCKETS - 1 &&
+            ctx_p->compar(elems + e * size, ctx_p->splitters + bucket * size) == 0;
+        slots[e] = 2 * bucket + is_eq;
+    }
+}
+
+/* Counts slots of the stripe of the thread, and touches the same stripe
+ * of tmp first, so its pages are placed on the NUMA node of the thread
+ */
+static void* classify_task(void* task_p)
+{
+    struct task* t_p = task_p;
+    struct sample_ctx* ctx_p = t_p->ctx_p;
+    size_t begin = stripe_begin(ctx_p, t_p->idx);
+    size_t end = stripe_begin(ctx_p, t_p->idx + 1);
+
+    for(size_t byte = begin * ctx_p->size; byte < end * ctx_p->size; byte += PAGE_LEN)
+    {
+        ((char*)ctx_p->tmp)[byte] = 0;
+    }
+
+    size_t* counts = ctx_p->counts[t_p->idx];
+    memset(counts, 0, sizeof(ctx_p->counts[t_p->idx]));
+    for(size_t i = begin; i < end; i += SAMPLE_SORT_BATCH)
+    {
+        size_t n = end - i < SAMPLE_SORT_BATCH ? end - i : SAMPLE_SORT_BATCH;
+        classify(ctx_p, i, n, ctx_p->oracle + i);
+        for(size_t e = 0; e < n; ++e)
+        {
+            ++counts[ctx_p->oracle[i + e]];
+        }
+    }
+
+    prof_thread_merge();
+    return NULL;
+}
+
+static void* scatter_task(void* task_p)
+{
+    struct task* t_p = task_p;
+    struct sample_ctx* ctx_p = t_p->ctx_p;
+    size_t begin = stripe_begin(ctx_p, t_p->idx);
+    size_t end = stripe_begin(ctx_p, t_p->idx + 1);
+
+    /* For comparing complexity, distribution moves instead of swapping */
+    PROF_ADD(PROF_MOVES, end - begin);
+    size_t* positions = ctx_p->counts[t_p->idx];
+    for(size_t i = begin; i < end; ++i)
+    {
+        copy_elem(ctx_p->tmp + positions[ctx_p->oracle[i]]++ * ctx_p->size,
+            ctx_p->base + i * ctx_p->size, ctx_p->size);
+    }
+
+    prof_thread_merge();
+    return NULL;
+}
+
+/* Sorts owned buckets in tmp, mostly on local pages, then moves them back */
+static void* sort_task(void* task_p)
+{
+    struct task* t_p = task_p;
+    struct sample_ctx* ctx_p = t_p->ctx_p;
+    size_t begin = owned_begin(ctx_p, t_p->idx);
+    size_t end = owned_begin(ctx_p, t_p->idx + 1);
+    const size_t size = ctx_p->size;
+
+    /* Odd slots hold elements equal to a splitter */
+    for(size_t s = 0; s < SLOTS; s += 2)
+    {
+        size_t start = ctx_p->starts[s];
+        size_t len = ctx_p->starts[s + 1] - start;
+        if(start < begin || start >= end || len < 2) continue;
+        quick3_sort(ctx_p->tmp + start * size, len, size, ctx_p->compar);
+    }
+
+    PROF_ADD(PROF_MOVES, end - begin);
+    memcpy(ctx_p->base + begin * size, ctx_p->tmp + begin * size, (end - begin) * size);
+
+    prof_thread_merge();
+    return NULL;
+}
+
+/* Runs task_fn for every thread index, each on its own thread pinned
+ * to a CPU. Tasks of threads which could not be started run here.
+ */
+static void run_tasks(struct sample_ctx* ctx_p, void* (*task_fn)(void*))
+{
+    if(ctx_p->threads_num == 1)
+    {
+        ctx_p->tasks[0] = (struct task){ctx_p, 0};
+        task_fn(&ctx_p->tasks[0]);
+        return;
+    }
+
+    bool is_started[ctx_p->threads_num];
+    for(unsigned int t = 0; t < ctx_p->threads_num; ++t)
+    {
+        ctx_p->tasks[t] = (struct task){ctx_p, t};
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if(ctx_p->cpus_c)
+        {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(ctx_p->cpus[t % ctx_p->cpus_c], &cpu_set);
+            pthread_attr_setaffinity_np(&attr, sizeof(cpu_set), &cpu_set);
+        }
+        is_started[t] = !pthread_create(&ctx_p->threads[t], &attr, task_fn, &ctx_p->tasks[t]);
+        pthread_attr_destroy(&attr);
+    }
+
+    for(unsigned int t = 0; t < ctx_p->threads_num; ++t)
+    {
+        if(is_started[t]) pthread_join(ctx_p->threads[t], NULL);
+        else task_fn(&ctx_p->tasks[t]);
+    }
+}
+
+/* CPUs the process may run on, those of one NUMA node next to each
+ * other, so that neighbouring stripes of memory stay on one node
+ * @return number of CPUs, 0 if they are unknown
+ */
+static unsigned int order_cpus(int* cpus)
+{
+    cpu_set_t allowed;
+    if(sched_getaffinity(0, sizeof(allowed), &allowed)) return 0;
+
+    cpu_set_t placed;
+    CPU_ZERO(&placed);
+    unsigned int cpus_c = 0;
+    char list[CPULIST_LEN];
+    for(unsigned int node = 0; cpus_c < (unsigned int)CPU_COUNT(&allowed); ++node)
+    {
+        char path[sizeof(NODE_CPULIST) + 16];
+        snprintf(path, sizeof(path), NODE_CPULIST, node);
+        FILE* file_p = fopen(path, "r");
+        if(!file_p) break;
+        char* p = fgets(list, sizeof(list), file_p);
+        fclose(file_p);
+
+        /* Ranges like 0-3,8-11 */
+        while(p && *p >= '0' && *p <= '9')
+        {
+            unsigned long first = strtoul(p, &p, 10);
+            unsigned long last = first;
+            if(*p == '-') last = strtoul(p + 1, &p, 10);
+            for(unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu)
+            {
+                if(!CPU_ISSET(cpu, &allowed) || CPU_ISSET(cpu, &placed)) continue;
+                CPU_SET(cpu, &placed);
+                cpus[cpus_c++] = cpu;
+            }
+            if(*p == ',') ++p;
+        }
+    }
+
+    /* Without NUMA information CPUs go in their order */
+    for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if(CPU_ISSET(cpu, &allowed) && !CPU_ISSET(cpu, &placed)) cpus[cpus_c++] = cpu;
+    }
+    return cpus_c;
+}
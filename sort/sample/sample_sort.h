@@ -0,0 +1,29 @@
+#ifndef SAMPLE_SORT_H_
+#define SAMPLE_SORT_H_
+
+#include <stddef.h>
+
+/* Arrays shorter than this are sorted by quick3_sort() on the calling thread */
+#define SAMPLE_SORT_MIN          (1U << 16)
+/* Elements are distributed into 2^BUCKETS_LOG buckets in one pass */
+#define SAMPLE_SORT_BUCKETS_LOG  8U
+#define SAMPLE_SORT_BUCKETS      (1U << SAMPLE_SORT_BUCKETS_LOG)
+/* Sample elements per bucket, more of them give more even buckets */
+#define SAMPLE_SORT_OVERSAMPLING 16U
+/* Elements classified together, so their compares overlap cache misses */
+#define SAMPLE_SORT_BATCH        8U
+
+/* Sets number of threads used by following sorts,
+ * 0 for one per CPU the process may run on, which is the default
+ */
+void sample_sort_set_threads(unsigned int threads_num);
+
+/* Parallel super scalar sample sort, not stable. Splitters picked from
+ * a sample classify elements into buckets, which are then sorted
+ * independently. Needs nmemb * (size + 2) bytes of extra memory,
+ * falls back to quick3_sort() without it.
+ */
+void sample_sort(void* base, size_t nmemb, size_t size,
+    int (*compar)(const void*, const void*));
+
+#endif /* SAMPLE_SORT_H_ */
@@ -0,0 +1,140 @@
+#ifndef NO_TEST
+#include <criterion.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sample_sort.h"
+
+#define NMEMB   (4U * SAMPLE_SORT_MIN + 7U)
+#define SEED    2022U
+
+struct rec
+{
+    uint64_t key;
+    uint64_t idx;
+};
+
+static int compar_key(const void* a, const void* b)
+{
+    uint64_t k1 = ((const struct rec*)a)->key;
+    uint64_t k2 = ((const struct rec*)b)->key;
+    return (k1 > k2) - (k1 < k2);
+}
+
+/* Keys 0 to keys - 1, or ascending ones when keys is 0 */
+static struct rec* make_recs(size_t nmemb, unsigned int keys)
+{
+    struct rec* recs = malloc(nmemb * sizeof(*recs));
+    cr_assert_not_null(recs);
+    for(size_t i = 0; i < nmemb; ++i)
+    {
+        recs[i].key = keys ? (uint64_t)rand() % keys : i;
+        recs[i].idx = i;
+    }
+    return recs;
+}
+
+/* Keys don't descend and every record is present once */
+static void check_sorted(const struct rec* recs, size_t nmemb)
+{
+    char* seen = calloc(nmemb, 1);
+    cr_assert_not_null(seen);
+    for(size_t i = 0; i < nmemb; ++i)
+    {
+        cr_assert_lt(recs[i].idx, nmemb);
+        cr_assert_not(seen[recs[i].idx], "record %zu twice", (size_t)recs[i].idx);
+        seen[recs[i].idx] = 1;
+        if(i) cr_assert_leq(recs[i - 1].key, recs[i].key, "not sorted at %zu", i);
+    }
+    free(seen);
+}
+
+static void check_threads(unsigned int keys)
+{
+    const unsigned int threads[] = {1, 2, 3, 8, 0};
+    for(size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+    {
+        struct rec* recs = make_recs(NMEMB, keys);
+        sample_sort_set_threads(threads[t]);
+        sample_sort(recs, NMEMB, sizeof(*recs), compar_key);
+        check_sorted(recs, NMEMB);
+        free(recs);
+    }
+    sample_sort_set_threads(0);
+}
+
+Test(sample_sort_functionals, distinct_keys)
+{
+    srand(SEED);
+    check_threads(UINT32_MAX);
+}
+
+/* Splitters repeat, so elements equal to them go to equal buckets */
+Test(sample_sort_functionals, few_distinct_keys)
+{
+    srand(SEED);
+    check_threads(5);
+    check_threads(1);
+}
+
+Test(sample_sort_functionals, sorted_and_reversed)
+{
+    check_threads(0);
+
+    struct rec* recs = make_recs(NMEMB, 0);
+    for(size_t i = 0; i < NMEMB; ++i)
+    {
+        recs[i].key = NMEMB - i;
+    }
+    sample_sort(recs, NMEMB, sizeof(*recs), compar_key);
+    check_sorted(recs, NMEMB);
+    free(recs);
+}
+
+struct triple
+{
+    uint32_t key;
+    char pad[8];
+};
+
+static int compar_u32(const void* a, const void* b)
+{
+    uint32_t k1 = *(const uint32_t*)a;
+    uint32_t k2 = *(const uint32_t*)b;
+    return (k1 > k2) - (k1 < k2);
+}
+
+/* Short arrays are sorted directly, other sizes than the fast paths
+ * are copied whole
+ */
+Test(sample_sort_functionals, odd_sizes)
+{
+    srand(SEED);
+    const size_t nmembs[] = {0, 1, 2, SAMPLE_SORT_MIN - 1, SAMPLE_SORT_MIN};
+    for(size_t n = 0; n < sizeof(nmembs) / sizeof(nmembs[0]); ++n)
+    {
+        struct rec* recs = make_recs(nmembs[n], 1000);
+        sample_sort(recs, nmembs[n], sizeof(*recs), compar_key);
+        check_sorted(recs, nmembs[n]);
+        free(recs);
+    }
+
+    struct triple* triples = malloc(NMEMB * sizeof(*triples));
+    cr_assert_not_null(triples);
+    for(size_t i = 0; i < NMEMB; ++i)
+    {
+        triples[i].key = rand();
+        memset(triples[i].pad, triples[i].key & 0xFF, sizeof(triples[i].pad));
+    }
+    sample_sort_set_threads(3);
+    sample_sort(triples, NMEMB, sizeof(*triples), compar_u32);
+    sample_sort_set_threads(0);
+    for(size_t i = 0; i < NMEMB; ++i)
+    {
+        if(i) cr_assert_leq(triples[i - 1].key, triples[i].key);
+        cr_assert_eq((char)(triples[i].key & 0xFF), triples[i].pad[7]);
+    }
+    free(triples);
+}
+
+#endif /* NO_TEST */